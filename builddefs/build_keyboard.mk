@@ -165,10 +165,16 @@ ifneq ("$(wildcard $(KEYMAP_JSON))", "")
     INFO_RULES_MK = $(shell $(QMK_BIN) generate-rules-mk --quiet --escape --keyboard $(KEYBOARD) --keymap $(KEYMAP) --output $(KEYMAP_OUTPUT)/src/rules.mk)
     include $(INFO_RULES_MK)
 
+    # Sparse keymaps are generated from keymap.json, keymap.c is always dense
+    ifeq ($(strip $(SPARSE_KEYMAP_ENABLE)), yes)
+        OPT_DEFS += -DSPARSE_KEYMAP_ENABLE
+        JSON2C_FLAGS += --sparse
+    endif
+
 # Add rules to generate the keymap files - indentation here is important
 $(KEYMAP_OUTPUT)/src/keymap.c: $(KEYMAP_JSON)
 	@$(SILENT) || printf "$(MSG_GENERATING) $@" | $(AWK_CMD)
-	$(eval CMD=$(QMK_BIN) json2c --quiet --output $(KEYMAP_C) $(KEYMAP_JSON))
+	$(eval CMD=$(QMK_BIN) json2c --quiet $(JSON2C_FLAGS) --output $(KEYMAP_C) $(KEYMAP_JSON))
 	@$(BUILD_CMD)
 
 $(KEYMAP_OUTPUT)/src/config.h: $(KEYMAP_JSON)
@@ -460,6 +466,9 @@ $(eval $(call add_qmk_prefix_defs,MCU_FAMILY,MCU_FAMILY))
 $(eval $(call add_qmk_prefix_defs,MCU_SERIES,MCU_SERIES))
 $(eval $(call add_qmk_prefix_defs,BOARD,BOARD))
 
+# Skip the weak hooks nothing overrides
+include $(BUILDDEFS_PATH)/detect_hooks.mk
+
 # TODO: remove this bodge?
 PROJECT_DEFS := $(OPT_DEFS)
 PROJECT_INC := $(VPATH) $(EXTRAINCDIRS) $(KEYBOARD_PATHS)
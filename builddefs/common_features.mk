@@ -612,6 +612,9 @@ ifeq ($(strip $(VIA_ENABLE)), yes)
     BOOTMAGIC_ENABLE := yes
     SRC += $(QUANTUM_DIR)/via.c
     OPT_DEFS += -DVIA_ENABLE
+    ifeq ($(strip $(VIA_STREAM_ENABLE)), yes)
+        OPT_DEFS += -DVIA_STREAM_ENABLE
+    endif
 endif
 
 VALID_MAGIC_TYPES := yes
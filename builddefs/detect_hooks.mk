@@ -0,0 +1,77 @@
+# Find the weak hooks that neither the keyboard, the keymap nor the userspace
+# override, and define NO_<hook> for each of them so the core can skip calling
+# them, or use their default in place.
+#
+# A hook counts as overridden when any of their sources, any source of the
+# build outside of quantum/, or any `.c` file these pull in with `#include`,
+# has its name followed by `(` on a line without `weak`. Declarations and
+# calls are counted as well, which only costs the saving, never the hook.
+# Keymaps other than the one being built are left out. When a source of the
+# build or an included `.c` file cannot be found, no hook is skipped.
+#
+# Hooks that only run on state changes, such as led_update_kb(), are not
+# listed, skipping them would save nothing measurable.
+
+DETECT_UNUSED_HOOKS ?= yes
+
+HOOK_NAMES :=
+HOOK_NAMES += process_record_kb
+HOOK_NAMES += process_record_user
+HOOK_NAMES += post_process_record_kb
+HOOK_NAMES += post_process_record_user
+HOOK_NAMES += matrix_scan_kb
+HOOK_NAMES += matrix_scan_user
+HOOK_NAMES += housekeeping_task_kb
+HOOK_NAMES += housekeeping_task_user
+HOOK_NAMES += get_tapping_term
+HOOK_NAMES += get_permissive_hold
+HOOK_NAMES += get_hold_on_other_key_press
+HOOK_NAMES += get_ignore_mod_tap_interrupt
+HOOK_NAMES += get_tapping_force_hold
+HOOK_NAMES += get_retro_tapping
+HOOK_NAMES += get_speculative_hold
+HOOK_NAMES += get_combo_term
+HOOK_NAMES += get_auto_shifted_key
+HOOK_NAMES += get_custom_auto_shifted_key
+HOOK_NAMES += rgb_matrix_indicators_kb
+HOOK_NAMES += rgb_matrix_indicators_user
+HOOK_NAMES += rgb_matrix_indicators_advanced_kb
+HOOK_NAMES += rgb_matrix_indicators_advanced_user
+HOOK_NAMES += led_matrix_indicators_kb
+HOOK_NAMES += led_matrix_indicators_user
+HOOK_NAMES += led_matrix_indicators_advanced_kb
+HOOK_NAMES += led_matrix_indicators_advanced_user
+
+# `.c` files included by the given sources, looked up next to the including
+# file first and then along the include path, or HOOK_MISSING_INCLUDE
+HOOK_INCLUDE_DIRS = $(KEYBOARD_PATHS) $(KEYMAP_PATH) $(USER_PATH) $(VPATH) $(EXTRAINCDIRS)
+hook_resolve_include = $(or $(abspath $(firstword $(wildcard $(1)$(2) $(addsuffix /$(2),$(HOOK_INCLUDE_DIRS))))),HOOK_MISSING_INCLUDE)
+hook_c_includes = $(foreach p,$(shell grep -sHE '^[[:space:]]*\#[[:space:]]*include[[:space:]]*"[^"]+\.c"' $(1) | sed -E 's|^(([^:]*/)?)[^/:]*:[^"]*"([^"]+)".*|\1./\|\3|'),\
+    $(call hook_resolve_include,$(word 1,$(subst |, ,$(p))),$(word 2,$(subst |, ,$(p)))))
+# The sources given, and every `.c` file they include, recursively
+hook_follow_includes = $(if $(1),$(1) $(call hook_follow_includes,$(filter-out $(1) $(2),$(call hook_c_includes,$(1))),$(1) $(2)))
+
+ifeq ($(strip $(DETECT_UNUSED_HOOKS)), yes)
+    # Only the files directly in each keyboard folder, its subfolders are
+    # other keyboards, revisions or keymaps
+    HOOK_SOURCES := $(shell find $(sort $(filter-out keyboards/.,$(KEYBOARD_PATHS))) -maxdepth 1 -name '*.[ch]' 2>/dev/null)
+    HOOK_SOURCES += $(shell find $(KEYMAP_PATH) $(USER_PATH) -name '*.[ch]' 2>/dev/null)
+
+    # SRC entries are found through VPATH the way make finds them, generated
+    # sources in the build directory only hold keymaps and layouts
+    HOOK_BUILD_SRC := $(filter-out $(BUILD_DIR)/%,$(patsubst %.clib,%.c,$(SRC)) $(PLATFORM_SRC))
+    HOOK_BUILD_FOUND := $(patsubst ./%,%,$(foreach f,$(HOOK_BUILD_SRC),$(firstword $(wildcard $(f) $(addsuffix /$(f),$(VPATH))))))
+    HOOK_SOURCES += $(filter-out $(QUANTUM_DIR)/%,$(HOOK_BUILD_FOUND))
+    HOOK_SOURCES := $(sort $(call hook_follow_includes,$(sort $(HOOK_SOURCES))))
+
+    HOOK_EMPTY :=
+    HOOK_PAREN := (
+    HOOK_PATTERN := $(subst $(HOOK_EMPTY) $(HOOK_EMPTY),|,$(strip $(HOOK_NAMES)))
+    HOOKS_DEFINED := $(sort $(shell grep -shE '(^|[^[:alnum:]_])($(HOOK_PATTERN))[[:space:]]*[$(HOOK_PAREN)]' $(HOOK_SOURCES) | grep -v weak | grep -owE '$(HOOK_PATTERN)'))
+
+    # A source that cannot be found may define any hook, so keep them all
+    ifeq ($(strip $(words $(HOOK_BUILD_SRC)) $(filter HOOK_MISSING_INCLUDE,$(HOOK_SOURCES))),$(words $(HOOK_BUILD_FOUND)))
+        $(foreach AHOOK,$(filter-out $(HOOKS_DEFINED),$(HOOK_NAMES)),\
+            $(eval OPT_DEFS += -DNO_$(shell echo $(AHOOK) | tr '[:lower:]' '[:upper:]')))
+    endif
+endif
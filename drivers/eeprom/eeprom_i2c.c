@@ -15,6 +15,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #if defined(EXTERNAL_EEPROM_WP_PIN)
 #    include "gpio.h"
@@ -34,6 +35,7 @@
 */
 
 #include "wait.h"
+#include "timer.h"
 #include "i2c_master.h"
 #include "eeprom.h"
 #include "eeprom_i2c.h"
@@ -41,10 +43,33 @@
 // #define DEBUG_EEPROM_OUTPUT
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-#    include "timer.h"
 #    include "debug.h"
 #endif // DEBUG_EEPROM_OUTPUT
 
+#define EXTERNAL_EEPROM_PAGE_OF(addr) ((uintptr_t)(addr) / (EXTERNAL_EEPROM_PAGE_SIZE))
+
+#if EXTERNAL_EEPROM_CACHE_PAGES > 0
+typedef struct eeprom_cache_page_t {
+    uintptr_t page;        // page number held by this slot
+    uint32_t  last_used;   // LRU counter
+    bool      used;        // slot holds a page
+    bool      loaded;      // all bytes of the page have been read from the device
+    uint16_t  dirty_start; // offset of the first byte not yet written to the device
+    uint16_t  dirty_end;   // offset past the last byte not yet written to the device, or 0 if clean
+    uint8_t   data[EXTERNAL_EEPROM_PAGE_SIZE];
+} eeprom_cache_page_t;
+
+static eeprom_cache_page_t eeprom_cache[EXTERNAL_EEPROM_CACHE_PAGES];
+static uint32_t            eeprom_cache_counter     = 0;
+static uint32_t            eeprom_cache_dirty_since = 0;
+static bool                eeprom_cache_dirty       = false;
+#endif // EXTERNAL_EEPROM_CACHE_PAGES > 0
+
+#if EXTERNAL_EEPROM_WRITE_TIME > 0
+static bool     eeprom_write_in_progress = false;
+static uint32_t eeprom_write_start;
+#endif // EXTERNAL_EEPROM_WRITE_TIME > 0
+
 static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     uintptr_t p = (uintptr_t)addr;
     for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; ++i) {
@@ -53,6 +78,143 @@ static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     }
 }
 
+/* Waits for any in-progress write cycle to complete, by polling the EEPROM until it acknowledges its address */
+static void eeprom_wait_ready(uintptr_t target_addr) {
+#if EXTERNAL_EEPROM_WRITE_TIME > 0
+    if (!eeprom_write_in_progress) {
+        return;
+    }
+
+    uint8_t packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
+    fill_target_address(packet, (const void *)target_addr);
+    while (i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(target_addr), packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100) != I2C_STATUS_SUCCESS) {
+        if (timer_elapsed32(eeprom_write_start) >= (EXTERNAL_EEPROM_WRITE_TIME)) {
+            break;
+        }
+    }
+
+    eeprom_write_in_progress = false;
+#endif // EXTERNAL_EEPROM_WRITE_TIME > 0
+}
+
+/* Reads directly from the EEPROM, bypassing the cache */
+static void eeprom_device_read(uint8_t *buf, uintptr_t target_addr, size_t len) {
+    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
+    fill_target_address(complete_packet, (const void *)target_addr);
+
+    eeprom_wait_ready(target_addr);
+    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(target_addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
+    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS(target_addr), buf, len, 100);
+
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    dprintf("[EEPROM R] 0x%04X: ", ((int)target_addr));
+    for (size_t i = 0; i < len; ++i) {
+        dprintf(" %02X", (int)(buf[i]));
+    }
+    dprintf("\n");
+#endif // DEBUG_EEPROM_OUTPUT
+}
+
+/* Writes directly to the EEPROM, bypassing the cache. The write must not cross a page boundary. */
+static void eeprom_device_write_page(const uint8_t *buf, uintptr_t target_addr, uint16_t len) {
+    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
+    fill_target_address(complete_packet, (const void *)target_addr);
+    memcpy(&complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE], buf, len);
+
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    dprintf("[EEPROM W] 0x%04X: ", ((int)target_addr));
+    for (uint16_t i = 0; i < len; i++) {
+        dprintf(" %02X", (int)(buf[i]));
+    }
+    dprintf("\n");
+#endif // DEBUG_EEPROM_OUTPUT
+
+    eeprom_wait_ready(target_addr);
+
+#if defined(EXTERNAL_EEPROM_WP_PIN)
+    setPinOutput(EXTERNAL_EEPROM_WP_PIN);
+    writePin(EXTERNAL_EEPROM_WP_PIN, 0);
+#endif
+
+    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(target_addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + len, 100);
+
+#if defined(EXTERNAL_EEPROM_WP_PIN)
+    /* We are setting the WP pin to high in a way that requires at least two bit-flips to change back to 0 */
+    writePin(EXTERNAL_EEPROM_WP_PIN, 1);
+    setPinInputHigh(EXTERNAL_EEPROM_WP_PIN);
+#endif
+
+#if EXTERNAL_EEPROM_WRITE_TIME > 0
+    /* Don't block for the write cycle -- the next transfer will wait until the EEPROM is ready */
+    eeprom_write_in_progress = true;
+    eeprom_write_start       = timer_read32();
+#endif // EXTERNAL_EEPROM_WRITE_TIME > 0
+}
+
+#if EXTERNAL_EEPROM_CACHE_PAGES > 0
+static void eeprom_cache_writeback(eeprom_cache_page_t *entry) {
+    if (entry->dirty_end > 0) {
+        eeprom_device_write_page(&entry->data[entry->dirty_start], entry->page * (EXTERNAL_EEPROM_PAGE_SIZE) + entry->dirty_start, entry->dirty_end - entry->dirty_start);
+        entry->dirty_start = 0;
+        entry->dirty_end   = 0;
+    }
+}
+
+/* Finds the cache slot for the supplied page, claiming the least-recently-used slot if it isn't cached */
+static eeprom_cache_page_t *eeprom_cache_lookup(uintptr_t page) {
+    eeprom_cache_page_t *victim = &eeprom_cache[0];
+    for (int i = 0; i < (EXTERNAL_EEPROM_CACHE_PAGES); ++i) {
+        eeprom_cache_page_t *entry = &eeprom_cache[i];
+        if (entry->used && entry->page == page) {
+            entry->last_used = ++eeprom_cache_counter;
+            return entry;
+        }
+        if (!entry->used || (victim->used && entry->last_used < victim->last_used)) {
+            victim = entry;
+        }
+    }
+
+    eeprom_cache_writeback(victim);
+    victim->page      = page;
+    victim->last_used = ++eeprom_cache_counter;
+    victim->used      = true;
+    victim->loaded    = false;
+    return victim;
+}
+
+/* Ensures all bytes of a cached page are valid, preserving any pending writes */
+static void eeprom_cache_load(eeprom_cache_page_t *entry) {
+    if (entry->loaded) {
+        return;
+    }
+
+    uint8_t page_data[EXTERNAL_EEPROM_PAGE_SIZE];
+    eeprom_device_read(page_data, entry->page * (EXTERNAL_EEPROM_PAGE_SIZE), EXTERNAL_EEPROM_PAGE_SIZE);
+    for (int i = 0; i < (EXTERNAL_EEPROM_PAGE_SIZE); ++i) {
+        if (i < entry->dirty_start || i >= entry->dirty_end) {
+            entry->data[i] = page_data[i];
+        }
+    }
+    entry->loaded = true;
+}
+
+void eeprom_i2c_flush(void) {
+    for (int i = 0; i < (EXTERNAL_EEPROM_CACHE_PAGES); ++i) {
+        eeprom_cache_writeback(&eeprom_cache[i]);
+    }
+    eeprom_cache_dirty = false;
+}
+
+void eeprom_i2c_task(void) {
+    if (eeprom_cache_dirty && timer_elapsed32(eeprom_cache_dirty_since) >= (EXTERNAL_EEPROM_CACHE_FLUSH_MS)) {
+        eeprom_i2c_flush();
+    }
+}
+#else  // EXTERNAL_EEPROM_CACHE_PAGES > 0
+void eeprom_i2c_flush(void) {}
+void eeprom_i2c_task(void) {}
+#endif // EXTERNAL_EEPROM_CACHE_PAGES > 0
+
 void eeprom_driver_init(void) {
     i2c_init();
 #if defined(EXTERNAL_EEPROM_WP_PIN)
@@ -60,6 +222,10 @@ void eeprom_driver_init(void) {
     writePin(EXTERNAL_EEPROM_WP_PIN, 1);
     setPinInputHigh(EXTERNAL_EEPROM_WP_PIN);
 #endif
+#if EXTERNAL_EEPROM_CACHE_PAGES > 0
+    memset(eeprom_cache, 0, sizeof(eeprom_cache));
+    eeprom_cache_dirty = false;
+#endif // EXTERNAL_EEPROM_CACHE_PAGES > 0
 }
 
 void eeprom_driver_erase(void) {
@@ -72,6 +238,7 @@ void eeprom_driver_erase(void) {
     for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
         eeprom_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
     }
+    eeprom_i2c_flush();
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
@@ -79,30 +246,42 @@ void eeprom_driver_erase(void) {
 }
 
 void eeprom_read_block(void *buf, const void *addr, size_t len) {
-    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
-    fill_target_address(complete_packet, addr);
+    uint8_t * read_buf    = (uint8_t *)buf;
+    uintptr_t target_addr = (uintptr_t)addr;
 
-    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
-    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), buf, len, 100);
+#if EXTERNAL_EEPROM_CACHE_PAGES > 0
+    if (len > 0 && EXTERNAL_EEPROM_PAGE_OF(target_addr) == EXTERNAL_EEPROM_PAGE_OF(target_addr + len - 1)) {
+        /* Reads within a single page are served from the cache */
+        eeprom_cache_page_t *entry = eeprom_cache_lookup(EXTERNAL_EEPROM_PAGE_OF(target_addr));
+        eeprom_cache_load(entry);
+        memcpy(read_buf, &entry->data[target_addr % (EXTERNAL_EEPROM_PAGE_SIZE)], len);
+        return;
+    }
+#endif // EXTERNAL_EEPROM_CACHE_PAGES > 0
 
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-    dprintf("[EEPROM R] 0x%04X: ", ((int)addr));
-    for (size_t i = 0; i < len; ++i) {
-        dprintf(" %02X", (int)(((uint8_t *)buf)[i]));
+    eeprom_device_read(read_buf, target_addr, len);
+
+#if EXTERNAL_EEPROM_CACHE_PAGES > 0
+    /* Larger reads go straight to the EEPROM, with any cached pages overlaid */
+    for (int i = 0; i < (EXTERNAL_EEPROM_CACHE_PAGES); ++i) {
+        eeprom_cache_page_t *entry = &eeprom_cache[i];
+        if (!entry->used) {
+            continue;
+        }
+        uintptr_t page_addr = entry->page * (EXTERNAL_EEPROM_PAGE_SIZE);
+        for (int j = 0; j < (EXTERNAL_EEPROM_PAGE_SIZE); ++j) {
+            bool valid = entry->loaded || (j >= entry->dirty_start && j < entry->dirty_end);
+            if (valid && page_addr + j >= target_addr && page_addr + j < target_addr + len) {
+                read_buf[page_addr + j - target_addr] = entry->data[j];
+            }
+        }
     }
-    dprintf("\n");
-#endif // DEBUG_EEPROM_OUTPUT
+#endif // EXTERNAL_EEPROM_CACHE_PAGES > 0
 }
 
 void eeprom_write_block(const void *buf, void *addr, size_t len) {
-    uint8_t   complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
-    uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
-
-#if defined(EXTERNAL_EEPROM_WP_PIN)
-    setPinOutput(EXTERNAL_EEPROM_WP_PIN);
-    writePin(EXTERNAL_EEPROM_WP_PIN, 0);
-#endif
+    const uint8_t *read_buf    = (const uint8_t *)buf;
+    uintptr_t      target_addr = (uintptr_t)addr;
 
     while (len > 0) {
         uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
@@ -111,30 +290,37 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
             write_length = len;
         }
 
-        fill_target_address(complete_packet, (const void *)target_addr);
-        for (uint8_t i = 0; i < write_length; i++) {
-            complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + i] = read_buf[i];
+#if EXTERNAL_EEPROM_CACHE_PAGES > 0
+        /* Merge the write into the cached page, deferring the write to the EEPROM */
+        eeprom_cache_page_t *entry = eeprom_cache_lookup(EXTERNAL_EEPROM_PAGE_OF(target_addr));
+        if (entry->dirty_end > 0 && (page_offset > entry->dirty_end || page_offset + write_length < entry->dirty_start)) {
+            /* The pending range can only be extended over bytes which are known, so fill in the gap first */
+            eeprom_cache_load(entry);
         }
-
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-        dprintf("[EEPROM W] 0x%04X: ", ((int)target_addr));
-        for (uint8_t i = 0; i < write_length; i++) {
-            dprintf(" %02X", (int)(read_buf[i]));
+        if (!entry->loaded || memcmp(&entry->data[page_offset], read_buf, write_length) != 0) {
+            memcpy(&entry->data[page_offset], read_buf, write_length);
+            if (entry->dirty_end == 0) {
+                entry->dirty_start = page_offset;
+                entry->dirty_end   = page_offset + write_length;
+            } else {
+                if (page_offset < entry->dirty_start) {
+                    entry->dirty_start = page_offset;
+                }
+                if (page_offset + write_length > entry->dirty_end) {
+                    entry->dirty_end = page_offset + write_length;
+                }
+            }
+            if (!eeprom_cache_dirty) {
+                eeprom_cache_dirty       = true;
+                eeprom_cache_dirty_since = timer_read32();
+            }
         }
-        dprintf("\n");
-#endif // DEBUG_EEPROM_OUTPUT
-
-        i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
-        wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
+#else  // EXTERNAL_EEPROM_CACHE_PAGES > 0
+        eeprom_device_write_page(read_buf, target_addr, write_length);
+#endif // EXTERNAL_EEPROM_CACHE_PAGES > 0
 
         read_buf += write_length;
         target_addr += write_length;
         len -= write_length;
     }
-
-#if defined(EXTERNAL_EEPROM_WP_PIN)
-    /* We are setting the WP pin to high in a way that requires at least two bit-flips to change back to 0 */
-    writePin(EXTERNAL_EEPROM_WP_PIN, 1);
-    setPinInputHigh(EXTERNAL_EEPROM_WP_PIN);
-#endif
 }
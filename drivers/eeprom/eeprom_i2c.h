@@ -118,8 +118,41 @@
 
 /*
     The write cycle time of the EEPROM in milliseconds, as specified in the
-    datasheet.
+    datasheet. Writes don't block for this long; instead, the next transfer
+    polls the EEPROM until it acknowledges, for at most this long.
 */
 #ifndef EXTERNAL_EEPROM_WRITE_TIME
 #    define EXTERNAL_EEPROM_WRITE_TIME 5
 #endif
+
+/*
+    The number of EEPROM pages to cache in RAM. When enabled, reads within a
+    single page are served from the cache, and writes are merged into the
+    cached page and only written to the EEPROM when the page is evicted, when
+    the oldest pending write is EXTERNAL_EEPROM_CACHE_FLUSH_MS old, or when
+    eeprom_i2c_flush() is invoked. Each cached page consumes
+    EXTERNAL_EEPROM_PAGE_SIZE bytes of RAM. Set to 0 to disable.
+*/
+#ifndef EXTERNAL_EEPROM_CACHE_PAGES
+#    define EXTERNAL_EEPROM_CACHE_PAGES 0
+#endif
+
+/*
+    The maximum time in milliseconds a write may remain in the cache before
+    it's written to the EEPROM.
+*/
+#ifndef EXTERNAL_EEPROM_CACHE_FLUSH_MS
+#    define EXTERNAL_EEPROM_CACHE_FLUSH_MS 500
+#endif
+
+/*
+    Writes any pending cached writes to the EEPROM. Should be invoked before
+    any reset or power loss.
+*/
+void eeprom_i2c_flush(void);
+
+/*
+    Periodic housekeeping, writing cached writes to the EEPROM once they're
+    old enough.
+*/
+void eeprom_i2c_task(void);
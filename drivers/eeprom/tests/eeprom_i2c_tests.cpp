@@ -0,0 +1,289 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cstdio>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "eeprom_driver.h"
+#include "eeprom_i2c.h"
+#include "i2c_master.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// Simulated 24xx EEPROM on a 400kHz bus, which completes its write cycle faster than the datasheet maximum
+static const uint32_t BUS_US_PER_BYTE = 9 * 1000000 / 400000;
+static const uint32_t WRITE_CYCLE_US  = 3000;
+
+struct SimulatedEeprom {
+    std::array<uint8_t, EXTERNAL_EEPROM_BYTE_COUNT> memory;
+    uint32_t                                        pointer;
+    uint32_t                                        busy_until_us;
+    uint32_t                                        bus_us;
+    uint32_t                                        acked_us;
+    uint32_t                                        page_writes;
+    uint32_t                                        nacks;
+
+    void reset(void) {
+        memory.fill(0xFF);
+        pointer       = 0;
+        busy_until_us = 0;
+        bus_us        = 0;
+        acked_us      = 0;
+        page_writes   = 0;
+        nacks         = 0;
+    }
+
+    uint32_t now_us(void) {
+        return timer_read32() * 1000 + bus_us;
+    }
+
+    // Accounts for the time taken on the bus, advancing the millisecond timer as required
+    void transfer(uint16_t length) {
+        if (length > 0) {
+            acked_us += (1 + length) * BUS_US_PER_BYTE;
+        }
+        bus_us += (1 + length) * BUS_US_PER_BYTE;
+        while (bus_us >= 1000) {
+            advance_time(1);
+            bus_us -= 1000;
+        }
+    }
+
+    bool busy(void) {
+        if (now_us() < busy_until_us) {
+            ++nacks;
+            return true;
+        }
+        return false;
+    }
+};
+
+static SimulatedEeprom device;
+
+extern "C" {
+static i2c_status_t device_transmit(uint8_t address, const uint8_t* data, uint16_t length) {
+    // A busy device doesn't acknowledge its address, so the transfer ends immediately
+    if (device.busy()) {
+        device.transfer(0);
+        return I2C_STATUS_ERROR;
+    }
+    device.transfer(length);
+    device.pointer = (data[0] << 8) | data[1];
+    if (length > EXTERNAL_EEPROM_ADDRESS_SIZE) {
+        // Page writes wrap around within the page
+        uint32_t page_base = device.pointer - (device.pointer % EXTERNAL_EEPROM_PAGE_SIZE);
+        for (uint16_t i = EXTERNAL_EEPROM_ADDRESS_SIZE; i < length; ++i) {
+            device.memory[page_base + (device.pointer % EXTERNAL_EEPROM_PAGE_SIZE)] = data[i];
+            device.pointer                                                        = page_base + ((device.pointer + 1) % EXTERNAL_EEPROM_PAGE_SIZE);
+        }
+        device.busy_until_us = device.now_us() + WRITE_CYCLE_US;
+        ++device.page_writes;
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+static i2c_status_t device_receive(uint8_t address, uint8_t* data, uint16_t length) {
+    if (device.busy()) {
+        device.transfer(0);
+        return I2C_STATUS_ERROR;
+    }
+    device.transfer(length);
+    for (uint16_t i = 0; i < length; ++i) {
+        data[i]        = device.memory[device.pointer];
+        device.pointer = (device.pointer + 1) % EXTERNAL_EEPROM_BYTE_COUNT;
+    }
+    return I2C_STATUS_SUCCESS;
+}
+}
+
+static const i2c_mock_device_t device_callbacks = {device_transmit, device_receive};
+
+class EepromI2C : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        device.reset();
+        i2c_mock_set_device(&device_callbacks);
+        eeprom_driver_init();
+        i2c_mock_reset_stats();
+    }
+
+    void TearDown() override {
+        i2c_mock_set_device(nullptr);
+    }
+
+    // Drops anything cached, so that subsequent reads come from the device
+    void reinit(void) {
+        eeprom_i2c_flush();
+        eeprom_driver_init();
+    }
+};
+
+TEST_F(EepromI2C, BlockRoundTrip) {
+    uint8_t data[100];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i * 7 + 3);
+    }
+    eeprom_write_block(data, (void*)17, sizeof(data));
+    reinit();
+
+    uint8_t readback[100] = {0};
+    eeprom_read_block(readback, (void*)17, sizeof(readback));
+    EXPECT_EQ(memcmp(data, readback, sizeof(data)), 0);
+    EXPECT_EQ(memcmp(data, &device.memory[17], sizeof(data)), 0);
+}
+
+TEST_F(EepromI2C, WriteDoesNotBlockForWriteCycle) {
+    eeprom_write_byte((uint8_t*)0, 0x42);
+    eeprom_i2c_flush();
+    EXPECT_EQ(device.page_writes, 1);
+    EXPECT_EQ(timer_read32(), 0) << "Write should return without waiting for the write cycle";
+}
+
+TEST_F(EepromI2C, AckPollingWaitsForWriteCycle) {
+    eeprom_write_byte((uint8_t*)0, 0x42);
+    reinit();
+    uint32_t start = device.now_us();
+    EXPECT_EQ(eeprom_read_byte((uint8_t*)0), 0x42);
+    EXPECT_GT(device.nacks, 0);
+    EXPECT_LT(device.now_us() - start, EXTERNAL_EEPROM_WRITE_TIME * 1000) << "Polling should finish once the write cycle completes";
+}
+
+TEST_F(EepromI2C, AckPollingGivesUpAfterWriteTime) {
+    eeprom_write_byte((uint8_t*)0, 0x42);
+    reinit();
+    device.busy_until_us = UINT32_MAX;
+    uint32_t start       = timer_read32();
+    eeprom_read_byte((uint8_t*)0);
+    EXPECT_GE(timer_read32() - start, EXTERNAL_EEPROM_WRITE_TIME);
+    EXPECT_LE(timer_read32() - start, EXTERNAL_EEPROM_WRITE_TIME + 1);
+}
+
+TEST_F(EepromI2C, EraseZeroesEverything) {
+    eeprom_driver_erase();
+    reinit();
+    for (uint32_t i = 0; i < EXTERNAL_EEPROM_BYTE_COUNT; ++i) {
+        ASSERT_EQ(device.memory[i], 0) << "Byte " << i << " not erased";
+    }
+    EXPECT_EQ(device.page_writes, EXTERNAL_EEPROM_BYTE_COUNT / EXTERNAL_EEPROM_PAGE_SIZE);
+}
+
+#if EXTERNAL_EEPROM_CACHE_PAGES > 0
+TEST_F(EepromI2C, WritesWithinPageMerged) {
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_PAGE_SIZE; ++i) {
+        eeprom_write_byte((uint8_t*)(uintptr_t)(EXTERNAL_EEPROM_PAGE_SIZE + i), i);
+    }
+    EXPECT_EQ(device.page_writes, 0);
+    eeprom_i2c_flush();
+    EXPECT_EQ(device.page_writes, 1);
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_PAGE_SIZE; ++i) {
+        EXPECT_EQ(device.memory[EXTERNAL_EEPROM_PAGE_SIZE + i], i);
+    }
+}
+
+TEST_F(EepromI2C, RepeatedReadsServedFromCache) {
+    eeprom_read_byte((uint8_t*)5);
+    uint32_t transactions = i2c_mock_get_stats().transactions;
+    for (int i = 0; i < 10; ++i) {
+        eeprom_read_dword((uint32_t*)4);
+        eeprom_read_byte((uint8_t*)(EXTERNAL_EEPROM_PAGE_SIZE - 1));
+    }
+    EXPECT_EQ(i2c_mock_get_stats().transactions, transactions);
+}
+
+TEST_F(EepromI2C, UnchangedWritesSkipped) {
+    device.memory[8] = 0x5A;
+    eeprom_update_byte((uint8_t*)8, 0x5A);
+    eeprom_write_byte((uint8_t*)8, 0x5A);
+    eeprom_i2c_flush();
+    EXPECT_EQ(device.page_writes, 0);
+}
+
+TEST_F(EepromI2C, EvictionWritesBack) {
+    for (uint32_t page = 0; page <= EXTERNAL_EEPROM_CACHE_PAGES; ++page) {
+        eeprom_write_byte((uint8_t*)(uintptr_t)(page * EXTERNAL_EEPROM_PAGE_SIZE), (uint8_t)page + 1);
+    }
+    EXPECT_EQ(device.page_writes, 1);
+    EXPECT_EQ(device.memory[0], 1);
+}
+
+TEST_F(EepromI2C, TaskFlushesOldWrites) {
+    eeprom_write_byte((uint8_t*)0, 0x42);
+    for (uint32_t i = 0; i < EXTERNAL_EEPROM_CACHE_FLUSH_MS - 1; ++i) {
+        eeprom_i2c_task();
+        advance_time(1);
+    }
+    EXPECT_EQ(device.page_writes, 0);
+    advance_time(1);
+    eeprom_i2c_task();
+    EXPECT_EQ(device.page_writes, 1);
+    EXPECT_EQ(device.memory[0], 0x42);
+}
+
+TEST_F(EepromI2C, SparseWritesPreserveGap) {
+    device.memory[EXTERNAL_EEPROM_PAGE_SIZE + 5] = 0xA5;
+    eeprom_write_byte((uint8_t*)(uintptr_t)(EXTERNAL_EEPROM_PAGE_SIZE + 0), 0x01);
+    eeprom_write_byte((uint8_t*)(uintptr_t)(EXTERNAL_EEPROM_PAGE_SIZE + 10), 0x02);
+    eeprom_i2c_flush();
+    EXPECT_EQ(device.memory[EXTERNAL_EEPROM_PAGE_SIZE + 0], 0x01);
+    EXPECT_EQ(device.memory[EXTERNAL_EEPROM_PAGE_SIZE + 5], 0xA5);
+    EXPECT_EQ(device.memory[EXTERNAL_EEPROM_PAGE_SIZE + 10], 0x02);
+}
+
+TEST_F(EepromI2C, LargeReadsSeePendingWrites) {
+    eeprom_write_byte((uint8_t*)(uintptr_t)(EXTERNAL_EEPROM_PAGE_SIZE + 3), 0x77);
+    uint8_t readback[EXTERNAL_EEPROM_PAGE_SIZE * 3];
+    eeprom_read_block(readback, (void*)0, sizeof(readback));
+    EXPECT_EQ(readback[EXTERNAL_EEPROM_PAGE_SIZE + 3], 0x77);
+    EXPECT_EQ(readback[EXTERNAL_EEPROM_PAGE_SIZE + 4], 0xFF);
+}
+#endif // EXTERNAL_EEPROM_CACHE_PAGES > 0
+
+/**
+ * Reports bus usage and blocking time for typical VIA traffic.
+ */
+TEST_F(EepromI2C, ViaWorkloadReport) {
+    // Keymap of 4 layers of 5x15 keys, as stored by dynamic_keymap
+    const uint32_t keymap_base = 0x80;
+    const uint32_t keymap_size = 4 * 5 * 15 * 2;
+
+    struct {
+        const char* name;
+        void (*run)(uint32_t base, uint32_t size);
+    } workloads[] = {
+        // dynamic_keymap_set_buffer() updates a byte at a time
+        {"VIA keymap upload", [](uint32_t base, uint32_t size) {
+             for (uint32_t i = 0; i < size; ++i) {
+                 eeprom_update_byte((uint8_t*)(uintptr_t)(base + i), (uint8_t)(i % 2 ? 0x00 : 0x04 + (i % 100)));
+             }
+         }},
+        // dynamic_keymap_get_buffer() reads a byte at a time
+        {"VIA keymap download", [](uint32_t base, uint32_t size) {
+             for (uint32_t i = 0; i < size; ++i) {
+                 eeprom_read_byte((const uint8_t*)(uintptr_t)(base + i));
+             }
+         }},
+        // Single keycode changes, as made through the configurator
+        {"VIA keycode edits", [](uint32_t base, uint32_t size) {
+             for (uint32_t i = 0; i < 50; ++i) {
+                 uint16_t* addr = (uint16_t*)(uintptr_t)(base + ((i * 37) % (size / 2)) * 2);
+                 eeprom_read_word(addr);
+                 eeprom_update_word(addr, 0x4000 + i);
+             }
+         }},
+    };
+
+    for (auto& workload : workloads) {
+        SetUp();
+        uint32_t start = device.now_us();
+        workload.run(keymap_base, keymap_size);
+        eeprom_i2c_flush();
+        i2c_mock_stats_t stats = i2c_mock_get_stats();
+        printf("[ I2C EEPROM ] %-20s: %5d transactions, %6d bus bytes, %4d page writes, blocked %7.2f ms (with fixed %dms write delay: %7.2f ms)\n", workload.name, (int)stats.transactions, (int)stats.bytes, (int)device.page_writes, (device.now_us() - start) / 1000.0, EXTERNAL_EEPROM_WRITE_TIME, (device.acked_us + device.page_writes * EXTERNAL_EEPROM_WRITE_TIME * 1000) / 1000.0);
+    }
+}
@@ -0,0 +1,13 @@
+eeprom_i2c_DEFS := -DNO_PRINT -DEEPROM_DRIVER -DEEPROM_I2C -DEEPROM_I2C_24LC64
+eeprom_i2c_INC := $(DRIVER_PATH)/eeprom $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)
+
+eeprom_i2c_SRC := \
+	platforms/test/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/i2c_master.c \
+	$(DRIVER_PATH)/eeprom/eeprom_driver.c \
+	$(DRIVER_PATH)/eeprom/eeprom_i2c.c \
+	$(DRIVER_PATH)/eeprom/tests/eeprom_i2c_tests.cpp
+
+eeprom_i2c_cached_DEFS := $(eeprom_i2c_DEFS) -DEXTERNAL_EEPROM_CACHE_PAGES=4
+eeprom_i2c_cached_INC := $(eeprom_i2c_INC)
+eeprom_i2c_cached_SRC := $(eeprom_i2c_SRC)
@@ -0,0 +1,3 @@
+TEST_LIST += \
+	eeprom_i2c \
+	eeprom_i2c_cached
@@ -63,36 +63,75 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define FLASH_FLAG_WIP 0x01 /* Write in progress bit */
 #define FLASH_FLAG_WEL 0x02 /* Write enable latch bit */
 
+/* Read command, and the number of dummy bytes between the address and the data */
+#ifdef EXTERNAL_FLASH_SPI_FAST_READ
+#    define FLASH_CMD_READ_DATA FLASH_CMD_FASTREAD
+#    define FLASH_READ_DUMMY_BYTES (EXTERNAL_FLASH_FAST_READ_DUMMY_BYTES)
+#else
+#    define FLASH_CMD_READ_DATA FLASH_CMD_READ
+#    define FLASH_READ_DUMMY_BYTES 0
+#endif
+
 // #define DEBUG_FLASH_SPI_OUTPUT
 
+/* Set once a program or erase has been started, until the write-in-progress bit has been seen cleared */
+static bool spi_flash_maybe_busy = true;
+
+#if EXTERNAL_FLASH_READ_CACHE_SIZE > 0
+_Static_assert(((EXTERNAL_FLASH_READ_CACHE_SIZE) & ((EXTERNAL_FLASH_READ_CACHE_SIZE)-1)) == 0, "EXTERNAL_FLASH_READ_CACHE_SIZE must be a power of two");
+
+/* Read-ahead cache of an aligned window of flash */
+static uint8_t  spi_flash_cache[EXTERNAL_FLASH_READ_CACHE_SIZE];
+static uint32_t spi_flash_cache_addr;
+static bool     spi_flash_cache_valid = false;
+
+static void spi_flash_cache_invalidate(uint32_t addr, uint32_t len) {
+    if (spi_flash_cache_valid && addr < spi_flash_cache_addr + (EXTERNAL_FLASH_READ_CACHE_SIZE) && addr + len > spi_flash_cache_addr) {
+        spi_flash_cache_valid = false;
+    }
+}
+#else
+#    define spi_flash_cache_invalidate(addr, len)
+#endif // EXTERNAL_FLASH_READ_CACHE_SIZE > 0
+
 static bool spi_flash_start(void) {
     return spi_start(EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN, EXTERNAL_FLASH_SPI_LSBFIRST, EXTERNAL_FLASH_SPI_MODE, EXTERNAL_FLASH_SPI_CLOCK_DIVISOR);
 }
 
 static flash_status_t spi_flash_wait_while_busy(void) {
+    /* Nothing to wait for if no program or erase has been started since the flash was last idle */
+    if (!spi_flash_maybe_busy) {
+        return FLASH_STATUS_SUCCESS;
+    }
+
     uint32_t       deadline = timer_read32() + EXTERNAL_FLASH_SPI_TIMEOUT;
     flash_status_t response = FLASH_STATUS_SUCCESS;
     uint8_t        retval;
 
-    do {
-        bool res = spi_flash_start();
-        if (!res) {
-            dprint("Failed to start SPI! [spi flash wait while busy]\n");
-            return FLASH_STATUS_ERROR;
-        }
+    bool res = spi_flash_start();
+    if (!res) {
+        dprint("Failed to start SPI! [spi flash wait while busy]\n");
+        return FLASH_STATUS_ERROR;
+    }
 
-        spi_write(FLASH_CMD_RDSR);
+    /* The status register is output continuously for as long as the chip remains selected */
+    spi_write(FLASH_CMD_RDSR);
 
+    do {
         retval = (uint8_t)spi_read();
 
-        spi_stop();
-
         if (timer_read32() >= deadline) {
             response = FLASH_STATUS_TIMEOUT;
             break;
         }
     } while (retval & FLASH_FLAG_WIP);
 
+    spi_stop();
+
+    if (response == FLASH_STATUS_SUCCESS) {
+        spi_flash_maybe_busy = false;
+    }
+
     return response;
 }
 
@@ -110,24 +149,11 @@ static flash_status_t spi_flash_write_enable(void) {
     return FLASH_STATUS_SUCCESS;
 }
 
-static flash_status_t spi_flash_write_disable(void) {
-    bool res = spi_flash_start();
-    if (!res) {
-        dprint("Failed to start SPI! [spi flash write disable]\n");
-        return FLASH_STATUS_ERROR;
-    }
-
-    spi_write(FLASH_CMD_WRDI);
-
-    spi_stop();
-
-    return FLASH_STATUS_SUCCESS;
-}
-
 /* This function is used for read transfer, write transfer and erase transfer. */
 static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t *data, size_t len) {
     flash_status_t response = FLASH_STATUS_SUCCESS;
-    uint8_t        buffer[EXTERNAL_FLASH_ADDRESS_SIZE + 1];
+    uint8_t        buffer[EXTERNAL_FLASH_ADDRESS_SIZE + 1 + FLASH_READ_DUMMY_BYTES];
+    size_t         buffer_len = EXTERNAL_FLASH_ADDRESS_SIZE + 1;
 
     buffer[0] = cmd;
     for (int i = 0; i < EXTERNAL_FLASH_ADDRESS_SIZE; ++i) {
@@ -135,17 +161,29 @@ static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t
         addr >>= 8;
     }
 
+    /* Fast reads require dummy cycles before the data is output */
+    if (cmd == FLASH_CMD_READ_DATA) {
+        for (int i = 0; i < FLASH_READ_DUMMY_BYTES; ++i) {
+            buffer[buffer_len++] = 0;
+        }
+    }
+
+    /* Program and erase commands leave the flash busy */
+    if (cmd == FLASH_CMD_PP || cmd == FLASH_CMD_SE || cmd == FLASH_CMD_BE) {
+        spi_flash_maybe_busy = true;
+    }
+
     bool res = spi_flash_start();
     if (!res) {
         dprint("Failed to start SPI! [spi flash transmit]\n");
         return FLASH_STATUS_ERROR;
     }
 
-    response = spi_transmit(buffer, sizeof(buffer));
+    response = spi_transmit(buffer, buffer_len);
 
     if ((!response) && (data != NULL)) {
         switch (cmd) {
-            case FLASH_CMD_READ:
+            case FLASH_CMD_READ_DATA:
                 response = spi_receive(data, len);
                 break;
             case FLASH_CMD_PP:
@@ -162,8 +200,14 @@ static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t
     return response;
 }
 
+static flash_status_t flash_read_block_uncached(uint32_t addr, uint8_t *read_buf, size_t len);
+
 void flash_init(void) {
     spi_init();
+    spi_flash_maybe_busy = true;
+#if EXTERNAL_FLASH_READ_CACHE_SIZE > 0
+    spi_flash_cache_valid = false;
+#endif // EXTERNAL_FLASH_READ_CACHE_SIZE > 0
 }
 
 flash_status_t flash_erase_chip(void) {
@@ -184,6 +228,7 @@ flash_status_t flash_erase_chip(void) {
     }
 
     /* Erase Chip. */
+    spi_flash_cache_invalidate(0, EXTERNAL_FLASH_SIZE);
     bool res = spi_flash_start();
     if (!res) {
         dprint("Failed to start SPI! [spi flash erase chip]\n");
@@ -191,6 +236,7 @@ flash_status_t flash_erase_chip(void) {
     }
     spi_write(FLASH_CMD_CE);
     spi_stop();
+    spi_flash_maybe_busy = true;
 
     /* Wait for the write-in-progress bit to be cleared.*/
     response = spi_flash_wait_while_busy();
@@ -225,20 +271,14 @@ flash_status_t flash_erase_sector(uint32_t addr) {
         return response;
     }
 
-    /* Erase Sector. */
+    /* Erase Sector. The next operation waits for it to complete. */
+    spi_flash_cache_invalidate(addr, EXTERNAL_FLASH_SECTOR_SIZE);
     response = spi_flash_transaction(FLASH_CMD_SE, addr, NULL, 0);
     if (response != FLASH_STATUS_SUCCESS) {
         dprint("Failed to erase sector! [spi flash erase sector]\n");
         return response;
     }
 
-    /* Wait for the write-in-progress bit to be cleared.*/
-    response = spi_flash_wait_while_busy();
-    if (response != FLASH_STATUS_SUCCESS) {
-        dprint("Failed to check WIP flag! [spi flash erase sector]\n");
-        return response;
-    }
-
     return response;
 }
 
@@ -265,26 +305,44 @@ flash_status_t flash_erase_block(uint32_t addr) {
         return response;
     }
 
-    /* Erase Block. */
+    /* Erase Block. The next operation waits for it to complete. */
+    spi_flash_cache_invalidate(addr, EXTERNAL_FLASH_BLOCK_SIZE);
     response = spi_flash_transaction(FLASH_CMD_BE, addr, NULL, 0);
     if (response != FLASH_STATUS_SUCCESS) {
         dprint("Failed to erase block! [spi flash erase block]\n");
         return response;
     }
 
-    /* Wait for the write-in-progress bit to be cleared.*/
-    response = spi_flash_wait_while_busy();
-    if (response != FLASH_STATUS_SUCCESS) {
-        dprint("Failed to check WIP flag! [spi flash erase block]\n");
-        return response;
-    }
-
     return response;
 }
 
 flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len) {
+    uint8_t *read_buf = (uint8_t *)buf;
+
+#if EXTERNAL_FLASH_READ_CACHE_SIZE > 0
+    /* Reads within a single aligned window are served from the read-ahead cache */
+    uint32_t window = addr & ~(uint32_t)((EXTERNAL_FLASH_READ_CACHE_SIZE)-1);
+    if (len > 0 && ((addr + len - 1) & ~(uint32_t)((EXTERNAL_FLASH_READ_CACHE_SIZE)-1)) == window) {
+        if (!spi_flash_cache_valid || spi_flash_cache_addr != window) {
+            spi_flash_cache_valid   = false;
+            flash_status_t response = flash_read_block_uncached(window, spi_flash_cache, EXTERNAL_FLASH_READ_CACHE_SIZE);
+            if (response != FLASH_STATUS_SUCCESS) {
+                memset(read_buf, 0, len);
+                return response;
+            }
+            spi_flash_cache_addr  = window;
+            spi_flash_cache_valid = true;
+        }
+        memcpy(read_buf, &spi_flash_cache[addr - window], len);
+        return FLASH_STATUS_SUCCESS;
+    }
+#endif // EXTERNAL_FLASH_READ_CACHE_SIZE > 0
+
+    return flash_read_block_uncached(addr, read_buf, len);
+}
+
+static flash_status_t flash_read_block_uncached(uint32_t addr, uint8_t *read_buf, size_t len) {
     flash_status_t response = FLASH_STATUS_SUCCESS;
-    uint8_t *      read_buf = (uint8_t *)buf;
 
     /* Wait for the write-in-progress bit to be cleared. */
     response = spi_flash_wait_while_busy();
@@ -295,7 +353,7 @@ flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len) {
     }
 
     /* Perform read. */
-    response = spi_flash_transaction(FLASH_CMD_READ, addr, read_buf, len);
+    response = spi_flash_transaction(FLASH_CMD_READ_DATA, addr, read_buf, len);
     if (response != FLASH_STATUS_SUCCESS) {
         dprint("Failed to read block! [spi flash read block]\n");
         memset(read_buf, 0, len);
@@ -317,6 +375,8 @@ flash_status_t flash_write_block(uint32_t addr, const void *buf, size_t len) {
     flash_status_t response  = FLASH_STATUS_SUCCESS;
     uint8_t *      write_buf = (uint8_t *)buf;
 
+    spi_flash_cache_invalidate(addr, len);
+
     while (len > 0) {
         uint32_t page_offset  = addr % EXTERNAL_FLASH_PAGE_SIZE;
         size_t   write_length = EXTERNAL_FLASH_PAGE_SIZE - page_offset;
@@ -358,19 +418,7 @@ flash_status_t flash_write_block(uint32_t addr, const void *buf, size_t len) {
         len -= write_length;
     }
 
-    /* Wait for the write-in-progress bit to be cleared. */
-    response = spi_flash_wait_while_busy();
-    if (response != FLASH_STATUS_SUCCESS) {
-        dprint("Failed to check WIP flag! [spi flash write block]\n");
-        return response;
-    }
-
-    /* Disable writes. */
-    response = spi_flash_write_disable();
-    if (response != FLASH_STATUS_SUCCESS) {
-        dprint("Failed to write-disable! [spi flash write block]\n");
-        return response;
-    }
-
+    /* The write enable latch is cleared by the flash once the final page program completes, and the next
+       operation waits for it to do so -- there's no need to block here. */
     return response;
 }
@@ -91,6 +91,30 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define EXTERNAL_FLASH_SIZE (512 * 1024L)
 #endif
 
+/*
+    Define to use the FAST READ command, which allows higher clock speeds at
+    the cost of dummy cycles between the address and the data.
+        #define EXTERNAL_FLASH_SPI_FAST_READ
+*/
+
+/*
+    The number of dummy bytes sent after the address of a FAST READ command,
+    as specified in the datasheet.
+*/
+#ifndef EXTERNAL_FLASH_FAST_READ_DUMMY_BYTES
+#    define EXTERNAL_FLASH_FAST_READ_DUMMY_BYTES 1
+#endif
+
+/*
+    The size in bytes of the read-ahead cache. Reads which fall within a single
+    aligned window of this size are served from RAM after the first read of the
+    window. The cache is invalidated by writes and erases which overlap it.
+    Must be a power of two; set to 0 to disable.
+*/
+#ifndef EXTERNAL_FLASH_READ_CACHE_SIZE
+#    define EXTERNAL_FLASH_READ_CACHE_SIZE 0
+#endif
+
 /*
     The block count of the FLASH, calculated by total FLASH size and block size.
 */
@@ -0,0 +1,340 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cstdio>
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "flash_spi.h"
+#include "spi_master.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// Simulated NOR flash, modelled on the MX25L4006E with an 8MHz SPI clock
+static const uint32_t BUS_US_PER_BYTE  = 1;
+static const uint32_t PAGE_PROGRAM_US  = 1400;
+static const uint32_t SECTOR_ERASE_US  = 60000;
+static const uint32_t BLOCK_ERASE_US   = 700000;
+static const uint8_t  CMD_WREN         = 0x06;
+static const uint8_t  CMD_WRDI         = 0x04;
+static const uint8_t  CMD_RDSR         = 0x05;
+static const uint8_t  CMD_READ         = 0x03;
+static const uint8_t  CMD_FASTREAD     = 0x0B;
+static const uint8_t  CMD_PP           = 0x02;
+static const uint8_t  CMD_SE           = 0x20;
+static const uint8_t  CMD_BE           = 0xD8;
+static const uint8_t  CMD_CE           = 0x60;
+static const uint32_t ADDRESS_BYTES    = EXTERNAL_FLASH_ADDRESS_SIZE;
+static const uint32_t FAST_READ_DUMMY  = EXTERNAL_FLASH_FAST_READ_DUMMY_BYTES;
+static const uint32_t NO_COMMAND       = 0x100;
+
+struct SimulatedFlash {
+    std::vector<uint8_t> memory = std::vector<uint8_t>(EXTERNAL_FLASH_SIZE, 0xFF);
+    uint32_t             command;
+    uint32_t             index;
+    uint32_t             address;
+    bool                 write_enabled;
+    uint32_t             busy_until_us;
+    uint32_t             bus_us;
+    uint32_t             page_programs;
+    uint32_t             reads;
+    uint32_t             fast_reads;
+    uint32_t             ignored_commands;
+
+    void reset(void) {
+        std::fill(memory.begin(), memory.end(), 0xFF);
+        command          = NO_COMMAND;
+        index            = 0;
+        address          = 0;
+        write_enabled    = false;
+        busy_until_us    = 0;
+        bus_us           = 0;
+        page_programs    = 0;
+        reads            = 0;
+        fast_reads       = 0;
+        ignored_commands = 0;
+    }
+
+    uint32_t now_us(void) {
+        return timer_read32() * 1000 + bus_us;
+    }
+
+    bool busy(void) {
+        return now_us() < busy_until_us;
+    }
+
+    void clock(void) {
+        bus_us += BUS_US_PER_BYTE;
+        while (bus_us >= 1000) {
+            advance_time(1);
+            bus_us -= 1000;
+        }
+    }
+
+    // Starts a program or erase cycle, provided the flash will accept it
+    bool start_write(uint32_t duration_us) {
+        if (busy() || !write_enabled) {
+            ++ignored_commands;
+            return false;
+        }
+        write_enabled = false;
+        busy_until_us = now_us() + duration_us;
+        return true;
+    }
+
+    uint8_t exchange(uint8_t data) {
+        clock();
+        uint32_t i = index++;
+        if (i == 0) {
+            command = data;
+            if (command != CMD_RDSR && busy()) {
+                ++ignored_commands;
+                command = NO_COMMAND;
+            } else if (command == CMD_WREN) {
+                write_enabled = true;
+            } else if (command == CMD_WRDI) {
+                write_enabled = false;
+            }
+            return 0xFF;
+        }
+
+        switch (command) {
+            case CMD_RDSR:
+                return (busy() ? 0x01 : 0x00) | (write_enabled ? 0x02 : 0x00);
+            case CMD_READ:
+            case CMD_FASTREAD:
+            case CMD_PP:
+            case CMD_SE:
+            case CMD_BE: {
+                if (i <= ADDRESS_BYTES) {
+                    address = (address << 8) | data;
+                    return 0xFF;
+                }
+                uint32_t offset = i - ADDRESS_BYTES - 1;
+                if (command == CMD_FASTREAD && offset < FAST_READ_DUMMY) {
+                    return 0xFF;
+                }
+                if (command == CMD_PP) {
+                    // Programming can only clear bits, and wraps within the page
+                    uint32_t page_base = address - (address % EXTERNAL_FLASH_PAGE_SIZE);
+                    memory[page_base + ((address + offset) % EXTERNAL_FLASH_PAGE_SIZE)] &= data;
+                    return 0xFF;
+                }
+                if (command == CMD_READ || command == CMD_FASTREAD) {
+                    return memory[address++ % EXTERNAL_FLASH_SIZE];
+                }
+                return 0xFF;
+            }
+            default:
+                return 0xFF;
+        }
+    }
+
+    void deselect(void) {
+        switch (command) {
+            case CMD_READ:
+                ++reads;
+                break;
+            case CMD_FASTREAD:
+                ++fast_reads;
+                break;
+            case CMD_PP:
+                if (start_write(PAGE_PROGRAM_US)) {
+                    ++page_programs;
+                }
+                break;
+            case CMD_SE:
+                if (start_write(SECTOR_ERASE_US)) {
+                    std::fill_n(memory.begin() + (address - address % EXTERNAL_FLASH_SECTOR_SIZE), EXTERNAL_FLASH_SECTOR_SIZE, 0xFF);
+                }
+                break;
+            case CMD_BE:
+                if (start_write(BLOCK_ERASE_US)) {
+                    std::fill_n(memory.begin() + (address - address % EXTERNAL_FLASH_BLOCK_SIZE), EXTERNAL_FLASH_BLOCK_SIZE, 0xFF);
+                }
+                break;
+            case CMD_CE:
+                if (start_write(BLOCK_ERASE_US * EXTERNAL_FLASH_BLOCK_COUNT)) {
+                    std::fill(memory.begin(), memory.end(), 0xFF);
+                }
+                break;
+        }
+        command = NO_COMMAND;
+    }
+};
+
+static SimulatedFlash device;
+
+extern "C" {
+static void device_select(void) {
+    device.index   = 0;
+    device.address = 0;
+}
+static uint8_t device_exchange(uint8_t data) {
+    return device.exchange(data);
+}
+static void device_deselect(void) {
+    device.deselect();
+}
+}
+
+static const spi_mock_device_t device_callbacks = {device_select, device_exchange, device_deselect};
+
+class FlashSpi : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        device.reset();
+        spi_mock_set_device(&device_callbacks);
+        flash_init();
+        spi_mock_reset_stats();
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(device.ignored_commands, 0) << "Commands were sent while the flash was busy or write-disabled";
+        spi_mock_set_device(nullptr);
+    }
+
+    uint32_t read_commands(void) {
+        return device.reads + device.fast_reads;
+    }
+};
+
+TEST_F(FlashSpi, WriteReadRoundTrip) {
+    std::array<uint8_t, 3 * EXTERNAL_FLASH_PAGE_SIZE> data;
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (uint8_t)(i * 13 + 7);
+    }
+    EXPECT_EQ(flash_write_block(100, data.data(), data.size()), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(device.page_programs, 4) << "Writes should be split at page boundaries";
+
+    std::array<uint8_t, 3 * EXTERNAL_FLASH_PAGE_SIZE> readback;
+    EXPECT_EQ(flash_read_block(100, readback.data(), readback.size()), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(readback, data);
+}
+
+TEST_F(FlashSpi, WriteDoesNotWaitForProgramToComplete) {
+    uint8_t data[16] = {1, 2, 3, 4};
+    EXPECT_EQ(flash_write_block(0, data, sizeof(data)), FLASH_STATUS_SUCCESS);
+    EXPECT_TRUE(device.busy());
+
+    uint8_t readback[16];
+    EXPECT_EQ(flash_read_block(0, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    EXPECT_FALSE(device.busy());
+    EXPECT_EQ(memcmp(data, readback, sizeof(data)), 0);
+}
+
+TEST_F(FlashSpi, StatusPolledInSingleTransaction) {
+    uint8_t data[4] = {1, 2, 3, 4};
+    EXPECT_EQ(flash_write_block(0, data, sizeof(data)), FLASH_STATUS_SUCCESS);
+    spi_mock_reset_stats();
+
+    EXPECT_EQ(flash_erase_sector(EXTERNAL_FLASH_SECTOR_SIZE), FLASH_STATUS_SUCCESS);
+    // Status poll, write enable, erase
+    EXPECT_EQ(spi_mock_get_stats().transactions, 3);
+}
+
+TEST_F(FlashSpi, NoStatusPollWhenIdle) {
+    uint8_t readback[4];
+    EXPECT_EQ(flash_read_block(0, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    spi_mock_reset_stats();
+    EXPECT_EQ(flash_read_block(EXTERNAL_FLASH_SECTOR_SIZE, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(spi_mock_get_stats().transactions, 1);
+}
+
+TEST_F(FlashSpi, EraseSector) {
+    uint8_t data[4] = {1, 2, 3, 4};
+    EXPECT_EQ(flash_write_block(EXTERNAL_FLASH_SECTOR_SIZE, data, sizeof(data)), FLASH_STATUS_SUCCESS);
+    uint8_t readback[4];
+    EXPECT_EQ(flash_read_block(EXTERNAL_FLASH_SECTOR_SIZE, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(memcmp(data, readback, sizeof(data)), 0);
+
+    EXPECT_EQ(flash_erase_sector(EXTERNAL_FLASH_SECTOR_SIZE), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(flash_read_block(EXTERNAL_FLASH_SECTOR_SIZE, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    for (uint8_t value : readback) {
+        EXPECT_EQ(value, 0xFF) << "Stale data after erase";
+    }
+}
+
+#ifdef EXTERNAL_FLASH_SPI_FAST_READ
+TEST_F(FlashSpi, UsesFastRead) {
+    uint8_t readback[4];
+    EXPECT_EQ(flash_read_block(0, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(device.reads, 0);
+    EXPECT_EQ(device.fast_reads, 1);
+}
+#endif // EXTERNAL_FLASH_SPI_FAST_READ
+
+#if EXTERNAL_FLASH_READ_CACHE_SIZE > 0
+TEST_F(FlashSpi, ReadsWithinWindowServedFromCache) {
+    uint8_t readback[8];
+    for (uint32_t offset = 0; offset < EXTERNAL_FLASH_READ_CACHE_SIZE; offset += sizeof(readback)) {
+        EXPECT_EQ(flash_read_block(offset, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    }
+    EXPECT_EQ(read_commands(), 1);
+    EXPECT_EQ(flash_read_block(EXTERNAL_FLASH_READ_CACHE_SIZE, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(read_commands(), 2);
+}
+
+TEST_F(FlashSpi, WriteInvalidatesCache) {
+    uint8_t readback[4];
+    EXPECT_EQ(flash_read_block(0, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    uint8_t data[4] = {1, 2, 3, 4};
+    EXPECT_EQ(flash_write_block(2, data, sizeof(data)), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(flash_read_block(0, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(readback[2], 1);
+    EXPECT_EQ(readback[3], 2);
+}
+
+TEST_F(FlashSpi, ReadsSpanningWindowsBypassCache) {
+    uint8_t readback[8];
+    EXPECT_EQ(flash_read_block(EXTERNAL_FLASH_READ_CACHE_SIZE - 4, readback, sizeof(readback)), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(spi_mock_get_stats().bytes, 1 + ADDRESS_BYTES + FAST_READ_DUMMY + sizeof(readback) + 1 + 1);
+}
+#endif // EXTERNAL_FLASH_READ_CACHE_SIZE > 0
+
+/**
+ * Reports bus usage for access patterns typical of the wear-leveling backend.
+ */
+TEST_F(FlashSpi, WearLevelingAccessReport) {
+    struct {
+        const char* name;
+        void (*run)(void);
+    } workloads[] = {
+        // Log playback at startup, walking a sector in small entries
+        {"sequential 8B reads", [] {
+             uint8_t buf[8];
+             for (uint32_t offset = 0; offset < EXTERNAL_FLASH_SECTOR_SIZE; offset += sizeof(buf)) {
+                 flash_read_block(offset, buf, sizeof(buf));
+             }
+         }},
+        // Scattered reads of consolidated data
+        {"scattered 4B reads", [] {
+             uint8_t buf[4];
+             for (uint32_t i = 0; i < 512; ++i) {
+                 flash_read_block(((i * 1237) % (EXTERNAL_FLASH_SECTOR_SIZE / 4)) * 4, buf, sizeof(buf));
+             }
+         }},
+        // Appending log entries, each followed by a read of the next slot
+        {"append + readback", [] {
+             uint8_t buf[8] = {0x12, 0x34, 0x56, 0x78};
+             for (uint32_t offset = 0; offset < 128 * sizeof(buf); offset += sizeof(buf)) {
+                 flash_write_block(offset, buf, sizeof(buf));
+                 flash_read_block(offset + sizeof(buf), buf, sizeof(buf));
+             }
+         }},
+    };
+
+    for (auto& workload : workloads) {
+        SetUp();
+        uint32_t start = device.now_us();
+        workload.run();
+        spi_mock_stats_t stats = spi_mock_get_stats();
+        printf("[ SPI FLASH  ] %-20s: %5d transactions, %6d bus bytes, %5d read commands, %6.2f ms\n", workload.name, (int)stats.transactions, (int)stats.bytes, (int)read_commands(), (device.now_us() - start) / 1000.0);
+    }
+}
@@ -0,0 +1,12 @@
+flash_spi_DEFS := -DNO_PRINT -DFLASH_DRIVER -DFLASH_SPI -DEXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN=0
+flash_spi_INC := $(DRIVER_PATH)/flash $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)
+
+flash_spi_SRC := \
+	platforms/test/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/spi_master.c \
+	$(DRIVER_PATH)/flash/flash_spi.c \
+	$(DRIVER_PATH)/flash/tests/flash_spi_tests.cpp
+
+flash_spi_fast_read_cached_DEFS := $(flash_spi_DEFS) -DEXTERNAL_FLASH_SPI_FAST_READ -DEXTERNAL_FLASH_READ_CACHE_SIZE=256
+flash_spi_fast_read_cached_INC := $(flash_spi_INC)
+flash_spi_fast_read_cached_SRC := $(flash_spi_SRC)
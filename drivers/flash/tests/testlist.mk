@@ -0,0 +1,3 @@
+TEST_LIST += \
+	flash_spi \
+	flash_spi_fast_read_cached
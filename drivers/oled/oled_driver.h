@@ -226,6 +226,10 @@ void oled_write(const char *data, bool invert);
 // Advances the cursor to the next page, wiring ' ' to the remainder of the current page
 void oled_write_ln(const char *data, bool invert);
 
+// Writes a whole line of text to the buffer at the specified line, padding the remainder of the line with ' '
+// Inverts the pixels if true, and leaves the cursor at the start of the following line
+void oled_write_line(uint8_t line, const char *data, bool invert);
+
 // Pans the buffer to the right (or left by passing true) by moving contents of the buffer
 // Useful for moving the screen in preparation for new drawing
 void oled_pan(bool left);
@@ -240,6 +244,10 @@ void oled_write_raw(const char *data, uint16_t size);
 // Writes a single byte into the buffer at the specified index
 void oled_write_raw_byte(const char data, uint16_t index);
 
+// Writes a bitmap of 'width' columns by 'lines' 8-pixel rows to the buffer, starting at column 'x' of the specified line
+// Data is in display memory layout, one byte per column, one line after another
+void oled_write_raw_rect(const char *data, uint8_t x, uint8_t line, uint8_t width, uint8_t lines);
+
 // Sets a specific pixel on or off
 // Coordinates start at top-left and go right and down for positive x and y
 void oled_write_pixel(uint8_t x, uint8_t y, bool on);
@@ -256,12 +264,21 @@ void oled_write_P(const char *data, bool invert);
 // Remapped to call 'void oled_write_ln(const char *data, bool invert);' on ARM
 void oled_write_ln_P(const char *data, bool invert);
 
+// Writes a whole line of PROGMEM text to the buffer at the specified line, padding the remainder of the line with ' '
+// Remapped to call 'void oled_write_line(uint8_t line, const char *data, bool invert);' on ARM
+void oled_write_line_P(uint8_t line, const char *data, bool invert);
+
 // Writes a PROGMEM string to the buffer at current cursor position
 void oled_write_raw_P(const char *data, uint16_t size);
+
+// Writes a PROGMEM bitmap to the buffer, see 'oled_write_raw_rect'
+void oled_write_raw_rect_P(const char *data, uint8_t x, uint8_t line, uint8_t width, uint8_t lines);
 #else
 #    define oled_write_P(data, invert) oled_write(data, invert)
 #    define oled_write_ln_P(data, invert) oled_write_ln(data, invert)
+#    define oled_write_line_P(line, data, invert) oled_write_line(line, data, invert)
 #    define oled_write_raw_P(data, size) oled_write_raw(data, size)
+#    define oled_write_raw_rect_P(data, x, line, width, lines) oled_write_raw_rect(data, x, line, width, lines)
 #endif // defined(__AVR__)
 
 // Can be used to manually turn on the screen if it is off
@@ -160,6 +160,35 @@ static void InvertCharacter(uint8_t *cursor) {
     }
 }
 
+// Renders a single character from the font into the supplied glyph buffer
+static void RenderCharacter(uint8_t *glyph_buffer, const char data, bool invert) {
+    _Static_assert(sizeof(font) >= ((OLED_FONT_END + 1 - OLED_FONT_START) * OLED_FONT_WIDTH), "OLED_FONT_END references outside array");
+
+    uint8_t cast_data = (uint8_t)data; // font based on unsigned type for index
+    if (cast_data < OLED_FONT_START || cast_data > OLED_FONT_END) {
+        memset(glyph_buffer, 0x00, OLED_FONT_WIDTH);
+    } else {
+        const uint8_t *glyph = &font[(cast_data - OLED_FONT_START) * OLED_FONT_WIDTH];
+        memcpy_P(glyph_buffer, glyph, OLED_FONT_WIDTH);
+    }
+
+    if (invert) {
+        InvertCharacter(glyph_buffer);
+    }
+}
+
+// Copies data into the display buffer, only marking the blocks whose contents actually change as dirty
+static void oled_write_buffer(uint16_t index, const uint8_t *data, uint16_t size, bool progmem) {
+    if (index >= OLED_MATRIX_SIZE) return;
+    if ((index + size) > OLED_MATRIX_SIZE) size = OLED_MATRIX_SIZE - index;
+    for (uint16_t i = index; i < index + size; i++) {
+        uint8_t c = progmem ? pgm_read_byte(data++) : *data++;
+        if (oled_buffer[i] == c) continue;
+        oled_buffer[i] = c;
+        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (i / OLED_BLOCK_SIZE));
+    }
+}
+
 bool oled_init(oled_rotation_t rotation) {
 #if defined(USE_I2C) && defined(SPLIT_KEYBOARD)
     if (!is_keyboard_master()) {
@@ -417,33 +446,10 @@ void oled_write_char(const char data, bool invert) {
         return;
     }
 
-    // copy the current render buffer to check for dirty after
+    // render the glyph, then only dirty the blocks it actually changes
     static uint8_t oled_temp_buffer[OLED_FONT_WIDTH];
-    memcpy(&oled_temp_buffer, oled_cursor, OLED_FONT_WIDTH);
-
-    _Static_assert(sizeof(font) >= ((OLED_FONT_END + 1 - OLED_FONT_START) * OLED_FONT_WIDTH), "OLED_FONT_END references outside array");
-
-    // set the reder buffer data
-    uint8_t cast_data = (uint8_t)data; // font based on unsigned type for index
-    if (cast_data < OLED_FONT_START || cast_data > OLED_FONT_END) {
-        memset(oled_cursor, 0x00, OLED_FONT_WIDTH);
-    } else {
-        const uint8_t *glyph = &font[(cast_data - OLED_FONT_START) * OLED_FONT_WIDTH];
-        memcpy_P(oled_cursor, glyph, OLED_FONT_WIDTH);
-    }
-
-    // Invert if needed
-    if (invert) {
-        InvertCharacter(oled_cursor);
-    }
-
-    // Dirty check
-    if (memcmp(&oled_temp_buffer, oled_cursor, OLED_FONT_WIDTH)) {
-        uint16_t index = oled_cursor - &oled_buffer[0];
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (index / OLED_BLOCK_SIZE));
-        // Edgecase check if the written data spans the 2 chunks
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << ((index + OLED_FONT_WIDTH - 1) / OLED_BLOCK_SIZE));
-    }
+    RenderCharacter(oled_temp_buffer, data, invert);
+    oled_write_buffer(oled_cursor - &oled_buffer[0], oled_temp_buffer, OLED_FONT_WIDTH, false);
 
     // Finally move to the next char
     oled_advance_char();
@@ -462,6 +468,40 @@ void oled_write_ln(const char *data, bool invert) {
     oled_advance_page(true);
 }
 
+static void oled_write_line_impl(uint8_t line, const char *data, bool invert, bool progmem) {
+    static uint8_t oled_temp_buffer[OLED_FONT_WIDTH];
+    uint16_t       index = line * oled_rotation_width;
+    if (index >= OLED_MATRIX_SIZE) {
+        return;
+    }
+
+    // Render every character slot on the line, padding with spaces once the string runs out
+    uint8_t chars = oled_rotation_width / OLED_FONT_WIDTH;
+    bool    ended = false;
+    for (uint8_t i = 0; i < chars; ++i, index += OLED_FONT_WIDTH) {
+        char c = ended ? 0 : (progmem ? pgm_read_byte(data) : *data);
+        if (c == 0 || c == '\n' || c == '\r') {
+            ended = true;
+            c     = ' ';
+        } else {
+            data++;
+        }
+        RenderCharacter(oled_temp_buffer, c, invert);
+        oled_write_buffer(index, oled_temp_buffer, OLED_FONT_WIDTH, false);
+    }
+
+    // Leave the cursor at the start of the next line
+    index = (line + 1) * oled_rotation_width;
+    if (index >= OLED_MATRIX_SIZE) {
+        index = 0;
+    }
+    oled_cursor = &oled_buffer[index];
+}
+
+void oled_write_line(uint8_t line, const char *data, bool invert) {
+    oled_write_line_impl(line, data, invert, false);
+}
+
 void oled_pan(bool left) {
     uint16_t i = 0;
     for (uint16_t y = 0; y < OLED_DISPLAY_HEIGHT / 8; y++) {
@@ -496,14 +536,23 @@ void oled_write_raw_byte(const char data, uint16_t index) {
 }
 
 void oled_write_raw(const char *data, uint16_t size) {
-    uint16_t cursor_start_index = oled_cursor - &oled_buffer[0];
-    if ((size + cursor_start_index) > OLED_MATRIX_SIZE) size = OLED_MATRIX_SIZE - cursor_start_index;
-    for (uint16_t i = cursor_start_index; i < cursor_start_index + size; i++) {
-        uint8_t c = *data++;
-        if (oled_buffer[i] == c) continue;
-        oled_buffer[i] = c;
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (i / OLED_BLOCK_SIZE));
+    oled_write_buffer(oled_cursor - &oled_buffer[0], (const uint8_t *)data, size, false);
+}
+
+static void oled_write_raw_rect_impl(const char *data, uint8_t x, uint8_t line, uint8_t width, uint8_t lines, bool progmem) {
+    if (x >= oled_rotation_width) {
+        return;
     }
+
+    // Each line of the bitmap is contiguous in the display buffer, so it can be copied in one go
+    uint8_t copy_width = (x + width > oled_rotation_width) ? oled_rotation_width - x : width;
+    for (uint8_t i = 0; i < lines; ++i) {
+        oled_write_buffer((line + i) * oled_rotation_width + x, (const uint8_t *)data + i * width, copy_width, progmem);
+    }
+}
+
+void oled_write_raw_rect(const char *data, uint8_t x, uint8_t line, uint8_t width, uint8_t lines) {
+    oled_write_raw_rect_impl(data, x, line, width, lines, false);
 }
 
 void oled_write_pixel(uint8_t x, uint8_t y, bool on) {
@@ -540,15 +589,16 @@ void oled_write_ln_P(const char *data, bool invert) {
     oled_advance_page(true);
 }
 
+void oled_write_line_P(uint8_t line, const char *data, bool invert) {
+    oled_write_line_impl(line, data, invert, true);
+}
+
 void oled_write_raw_P(const char *data, uint16_t size) {
-    uint16_t cursor_start_index = oled_cursor - &oled_buffer[0];
-    if ((size + cursor_start_index) > OLED_MATRIX_SIZE) size = OLED_MATRIX_SIZE - cursor_start_index;
-    for (uint16_t i = cursor_start_index; i < cursor_start_index + size; i++) {
-        uint8_t c = pgm_read_byte(data++);
-        if (oled_buffer[i] == c) continue;
-        oled_buffer[i] = c;
-        oled_dirty |= ((OLED_BLOCK_TYPE)1 << (i / OLED_BLOCK_SIZE));
-    }
+    oled_write_buffer(oled_cursor - &oled_buffer[0], (const uint8_t *)data, size, true);
+}
+
+void oled_write_raw_rect_P(const char *data, uint8_t x, uint8_t line, uint8_t width, uint8_t lines) {
+    oled_write_raw_rect_impl(data, x, line, width, lines, true);
 }
 #endif // defined(__AVR__)
 
@@ -696,6 +746,7 @@ bool oled_scroll_off(void) {
             print("oled_scroll_off cmd failed\n");
             return oled_scrolling;
         }
+        // Display RAM needs to be rewritten after scrolling
         oled_scrolling = false;
         oled_dirty     = OLED_ALL_BLOCKS_MASK;
     }
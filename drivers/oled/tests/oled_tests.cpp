@@ -0,0 +1,180 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "oled_driver.h"
+#include "i2c_master.h"
+
+extern uint8_t  oled_buffer[OLED_MATRIX_SIZE];
+extern uint16_t oled_dirty;
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+static const char *status_text = nullptr;
+
+bool oled_task_user(void) {
+    if (status_text) {
+        oled_write(status_text, false);
+    }
+    return false;
+}
+}
+
+// Each rendered block costs a bounds command transfer plus a data transfer
+static const uint32_t BLOCK_BYTES = (1 + 7) + (1 + 1 + OLED_BLOCK_SIZE);
+
+class OledDriver : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        status_text = nullptr;
+        ASSERT_TRUE(oled_init(OLED_ROTATION_0));
+        render_all();
+        i2c_mock_reset_stats();
+    }
+
+    void render_all(void) {
+        while (oled_dirty) {
+            oled_render();
+        }
+    }
+
+    // Runs oled_task once per millisecond for the specified duration, returning the number of I2C bytes sent
+    uint32_t run_for(uint32_t ms) {
+        i2c_mock_reset_stats();
+        for (uint32_t i = 0; i < ms; ++i) {
+            oled_task();
+            advance_time(1);
+        }
+        return i2c_mock_get_stats().bytes;
+    }
+};
+
+TEST_F(OledDriver, InitialRenderSendsEveryBlockOnce) {
+    oled_write("hello", false);
+    render_all();
+    i2c_mock_stats_t stats = i2c_mock_get_stats();
+    EXPECT_EQ(stats.transactions, 2);
+    EXPECT_EQ(stats.bytes, BLOCK_BYTES);
+}
+
+TEST_F(OledDriver, RewritingSameTextDoesNotDirty) {
+    oled_write("status", false);
+    render_all();
+    oled_set_cursor(0, 0);
+    oled_write("status", false);
+    EXPECT_EQ(oled_dirty, 0);
+}
+
+TEST_F(OledDriver, ChangedCharacterOnlyDirtiesItsBlock) {
+    oled_write("status", false);
+    render_all();
+    oled_set_cursor(1, 0);
+    oled_write("T", false);
+    EXPECT_EQ(oled_dirty, 1);
+}
+
+TEST_F(OledDriver, CharacterSpanningTwoBlocksOnlyDirtiesChangedBlock) {
+    // Character 5 covers bytes 30..35, across the first two blocks -- only the second block differs from a blank glyph
+    oled_buffer[32] = 0x7F;
+    oled_set_cursor(5, 0);
+    oled_write(" ", false);
+    EXPECT_EQ(oled_dirty, 2);
+}
+
+TEST_F(OledDriver, ClearAndRedrawResendsEveryBlock) {
+    oled_write("layer: base", false);
+    render_all();
+    i2c_mock_reset_stats();
+
+    // Only the buffer bytes are compared, never a digest of what was sent, so every dirty block goes out
+    oled_clear();
+    oled_write("layer: base", false);
+    render_all();
+    EXPECT_EQ(i2c_mock_get_stats().bytes, OLED_BLOCK_COUNT * BLOCK_BYTES);
+}
+
+TEST_F(OledDriver, FilledBlockIsSent) {
+    char lit[OLED_BLOCK_SIZE];
+    memset(lit, 0xFF, sizeof(lit));
+    oled_write_raw(lit, sizeof(lit));
+    render_all();
+    EXPECT_EQ(i2c_mock_get_stats().bytes, BLOCK_BYTES);
+}
+
+TEST_F(OledDriver, InvertedSpaceOverBlankIsSent) {
+    oled_write(" ", true);
+    render_all();
+    EXPECT_EQ(i2c_mock_get_stats().bytes, BLOCK_BYTES);
+}
+
+TEST_F(OledDriver, SteadyStatusTextHasNoBusTraffic) {
+    status_text = "WPM: 042\nLayer: base";
+    EXPECT_GT(run_for(1000), 0);
+    EXPECT_EQ(run_for(1000), 0);
+}
+
+TEST_F(OledDriver, ScrollOffResendsEverything) {
+    oled_write("hello", false);
+    render_all();
+    ASSERT_TRUE(oled_scroll_left());
+    ASSERT_TRUE(oled_scroll_off());
+    i2c_mock_reset_stats();
+    render_all();
+    EXPECT_EQ(i2c_mock_get_stats().bytes, OLED_BLOCK_COUNT * BLOCK_BYTES);
+}
+
+TEST_F(OledDriver, WriteLinePadsAndMovesCursor) {
+    oled_set_cursor(0, 1);
+    oled_write("XXXXXXXXXX", false);
+    render_all();
+
+    oled_write_line(1, "ab", false);
+    oled_buffer_reader_t reader = oled_read_raw(OLED_DISPLAY_WIDTH);
+    // Everything after the two characters is now blank
+    for (uint16_t i = 2 * OLED_FONT_WIDTH; i < (OLED_DISPLAY_WIDTH / OLED_FONT_WIDTH) * OLED_FONT_WIDTH; ++i) {
+        EXPECT_EQ(reader.current_element[i], 0) << i;
+    }
+    EXPECT_NE(reader.current_element[OLED_FONT_WIDTH + 1], 0);
+
+    // Writing the same line again is a no-op
+    render_all();
+    oled_write_line(1, "ab", false);
+    EXPECT_EQ(oled_dirty, 0);
+
+    // The cursor is left at the start of the following line
+    oled_write("c", false);
+    EXPECT_NE(oled_read_raw(2 * OLED_DISPLAY_WIDTH).current_element[1], 0);
+}
+
+TEST_F(OledDriver, WriteRawRect) {
+    char bitmap[2][4] = {{1, 2, 3, 4}, {5, 6, 7, 8}};
+    oled_write_raw_rect(&bitmap[0][0], 126, 2, 4, 2);
+
+    // Columns beyond the display width are clipped
+    EXPECT_EQ(oled_buffer[2 * OLED_DISPLAY_WIDTH + 126], 1);
+    EXPECT_EQ(oled_buffer[2 * OLED_DISPLAY_WIDTH + 127], 2);
+    EXPECT_EQ(oled_buffer[3 * OLED_DISPLAY_WIDTH + 126], 5);
+    EXPECT_EQ(oled_buffer[3 * OLED_DISPLAY_WIDTH + 127], 6);
+    EXPECT_EQ(oled_buffer[3 * OLED_DISPLAY_WIDTH], 0);
+
+    // Only the last block of each line is touched
+    uint16_t expected = (1 << ((3 * OLED_DISPLAY_WIDTH - 1) / OLED_BLOCK_SIZE)) | (1 << ((4 * OLED_DISPLAY_WIDTH - 1) / OLED_BLOCK_SIZE));
+    EXPECT_EQ(oled_dirty, expected);
+
+    // Blitting the same bitmap again doesn't dirty anything
+    render_all();
+    oled_write_raw_rect(&bitmap[0][0], 126, 2, 4, 2);
+    EXPECT_EQ(oled_dirty, 0);
+}
+
+TEST_F(OledDriver, BytesPerSecondReport) {
+    status_text = "WPM: 042\nLayer: base";
+    uint32_t first  = run_for(1000);
+    uint32_t steady = run_for(1000);
+    printf("[ OLED I2C ] first second %u bytes/s, steady state %u bytes/s\n", (unsigned)first, (unsigned)steady);
+    EXPECT_LE(first, OLED_BLOCK_COUNT * BLOCK_BYTES);
+}
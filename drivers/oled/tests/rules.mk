@@ -0,0 +1,9 @@
+oled_DEFS := -DNO_PRINT -DOLED_ENABLE
+oled_CONFIG := $(DRIVER_PATH)/oled/tests/config_oled.h
+oled_INC := $(DRIVER_PATH)/oled $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)
+
+oled_SRC := \
+	platforms/test/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/i2c_master.c \
+	$(DRIVER_PATH)/oled/ssd1306_sh1106.c \
+	$(DRIVER_PATH)/oled/tests/oled_tests.cpp
@@ -9,6 +9,7 @@ from qmk.commands import parse_configurator_json
 
 
 @cli.argument('-o', '--output', arg_only=True, type=qmk.path.normpath, help='File to write to')
+@cli.argument('--sparse', arg_only=True, action='store_true', help='Store the layers above the base layers sparse, for SPARSE_KEYMAP_ENABLE')
 @cli.argument('-q', '--quiet', arg_only=True, action='store_true', help="Quiet mode, only output error messages")
 @cli.argument('filename', type=qmk.path.FileType('r'), arg_only=True, completer=FilesCompleter('.json'), help='Configurator JSON file')
 @cli.subcommand('Creates a keymap.c from a QMK Configurator export.')
@@ -26,7 +27,7 @@ def json2c(cli):
         cli.args.output = None
 
     # Generate the keymap
-    keymap_c = qmk.keymap.generate_c(user_keymap)
+    keymap_c = qmk.keymap.generate_c(user_keymap, sparse=cli.args.sparse)
 
     if cli.args.output:
         cli.args.output.parent.mkdir(parents=True, exist_ok=True)
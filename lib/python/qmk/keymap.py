@@ -15,6 +15,9 @@ import qmk.path
 from qmk.keyboard import find_keyboard_from_dir, rules_mk, keyboard_folder
 from qmk.errors import CppError
 
+# Keycodes that fall through to the layer below
+TRANSPARENT_KEYCODES = ('KC_TRANSPARENT', 'KC_TRNS', '_______')
+
 # The `keymap.c` template to use when a keyboard doesn't have its own
 DEFAULT_KEYMAP_C = """#include QMK_KEYBOARD_H
 __INCLUDES__
@@ -76,6 +79,114 @@ def _strip_any(keycode):
     return keycode
 
 
+def _layout_matrix(keyboard, layout):
+    """Returns `(rows, cols, positions)` for a layout, where `positions` holds the `[row, col]` of each key in the order the LAYOUT macro takes them.
+    """
+    import qmk.info  # qmk.info imports this module, so it can only be imported once we need it
+
+    kb_info_json = qmk.info.info_json(keyboard)
+    layout = kb_info_json.get('layout_aliases', {}).get(layout, layout)
+
+    if layout not in kb_info_json['layouts'] or 'matrix_size' not in kb_info_json:
+        cli.log.error('%s: Sparse keymaps need the matrix size and the %s matrix positions in info.json.', keyboard, layout)
+        exit(1)
+
+    matrix_size = kb_info_json['matrix_size']
+    positions = [key.get('matrix') for key in kb_info_json['layouts'][layout]['layout']]
+
+    if None in positions:
+        cli.log.error('%s: Every key of %s needs a matrix position for a sparse keymap.', keyboard, layout)
+        exit(1)
+
+    return matrix_size['rows'], matrix_size['cols'], positions
+
+
+def generate_sparse_layers(layers, rows, cols, positions):
+    """Splits a keymap into dense base layers and sparse upper layers.
+
+    Returns `(dense_count, masks, offsets, keycodes)`. Each sparse layer has a bitmap of its non-transparent keys per matrix row, the index of the first keycode of each row, and its non-transparent keycodes in matrix order. Layer 0 is always dense, and the layers above it stay dense until storing one sparse saves flash. Matrix positions outside of the layout are transparent in sparse layers.
+    """
+    row_bytes = 1 if cols <= 8 else 2 if cols <= 16 else 4 if cols <= 32 else 8
+    sparse_layers = []
+
+    for layer in layers:
+        if len(layer) != len(positions):
+            cli.log.error('Layer has %s keys, the layout has %s.', len(layer), len(positions))
+            exit(1)
+
+        matrix = {}
+        for keycode, (row, col) in zip(map(_strip_any, layer), positions):
+            if keycode not in TRANSPARENT_KEYCODES:
+                matrix[row, col] = keycode
+
+        sparse_layers.append(matrix)
+
+    dense_count = 1
+    while dense_count < len(layers) and rows * row_bytes + rows * 2 + len(sparse_layers[dense_count]) * 2 >= rows * cols * 2:
+        dense_count += 1
+
+    masks = []
+    offsets = []
+    keycodes = []
+    key_count = 0
+
+    for matrix in sparse_layers[dense_count:]:
+        layer_masks = []
+        layer_offsets = []
+        layer_keycodes = []
+
+        for row in range(rows):
+            layer_offsets.append(key_count)
+            mask = 0
+
+            for col in range(cols):
+                if (row, col) in matrix:
+                    mask |= 1 << col
+                    layer_keycodes.append(matrix[row, col])
+                    key_count += 1
+
+            layer_masks.append(mask)
+
+        masks.append(layer_masks)
+        offsets.append(layer_offsets)
+        keycodes.append(layer_keycodes)
+
+    return dense_count, masks, offsets, keycodes
+
+
+def _generate_sparse_c(dense_count, masks, offsets, keycodes, cols):
+    """Returns the C tables for the sparse layers of a keymap.
+    """
+    mask_digits = 2 if cols <= 8 else 4 if cols <= 16 else 8 if cols <= 32 else 16
+    masks_txt = []
+    offsets_txt = []
+    keycodes_txt = []
+
+    for sparse_num, (layer_masks, layer_offsets, layer_keycodes) in enumerate(zip(masks, offsets, keycodes)):
+        layer_num = dense_count + sparse_num
+        masks_txt.append('\t/* %s */ {%s},' % (layer_num, ', '.join('0x%0*X' % (mask_digits, mask) for mask in layer_masks)))
+        offsets_txt.append('\t/* %s */ {%s},' % (layer_num, ', '.join(str(offset) for offset in layer_offsets)))
+        if layer_keycodes:
+            keycodes_txt.append('\t/* %s */ %s,' % (layer_num, ', '.join(layer_keycodes)))
+
+    return '\n'.join((
+        '',
+        '// Layers from %s up only store their non-transparent keys (SPARSE_KEYMAP_ENABLE)' % dense_count,
+        'const matrix_row_t PROGMEM keymap_sparse_masks[][MATRIX_ROWS] = {',
+        *masks_txt,
+        '};',
+        '',
+        'const uint16_t PROGMEM keymap_sparse_offsets[][MATRIX_ROWS] = {',
+        *offsets_txt,
+        '};',
+        '',
+        'const uint16_t PROGMEM keymap_sparse_keycodes[] = {',
+        *keycodes_txt,
+        '};',
+        '',
+    ))
+
+
 def find_keymap_from_dir():
     """Returns `(keymap_name, source)` for the directory we're currently in.
 
@@ -187,7 +298,7 @@ def generate_json(keymap, keyboard, layout, layers, macros=None):
     return new_keymap
 
 
-def generate_c(keymap_json):
+def generate_c(keymap_json, sparse=False):
     """Returns a `keymap.c`.
 
     `keymap_json` is a dictionary with the following keys:
@@ -203,11 +314,19 @@ def generate_c(keymap_json):
 
         macros
             A sequence of strings containing macros to implement for this keyboard.
+
+    When `sparse` is true only the dense base layers go into `keymaps`, and the layers above them are written to the sparse tables instead.
     """
     new_keymap = template_c(keymap_json['keyboard'])
     layer_txt = []
+    layers = keymap_json['layers']
+
+    if sparse:
+        rows, cols, positions = _layout_matrix(keymap_json['keyboard'], keymap_json['layout'])
+        dense_count, masks, offsets, keycodes = generate_sparse_layers(layers, rows, cols, positions)
+        layers = layers[:dense_count]
 
-    for layer_num, layer in enumerate(keymap_json['layers']):
+    for layer_num, layer in enumerate(layers):
         if layer_num != 0:
             layer_txt[-1] = layer_txt[-1] + ','
         layer = map(_strip_any, layer)
@@ -217,6 +336,9 @@ def generate_c(keymap_json):
     keymap = '\n'.join(layer_txt)
     new_keymap = new_keymap.replace('__KEYMAP_GOES_HERE__', keymap)
 
+    if sparse:
+        new_keymap = new_keymap + _generate_sparse_c(dense_count, masks, offsets, keycodes, cols)
+
     if keymap_json.get('macros'):
         macro_txt = [
             'bool process_record_user(uint16_t keycode, keyrecord_t *record) {',
@@ -51,6 +51,22 @@ def test_compile_json():
     check_returncode(result)
 
 
+def test_compile_detect_hooks_platform_source():
+    # housekeeping_task_kb() of massdrop/alt lives in tmk_core, found through VPATH
+    result = cli.run(['make', 'massdrop/alt:default', '-n', 'SKIP_GIT=yes'], stdin=DEVNULL, combined_output=True)
+    check_returncode(result)
+    assert '-DNO_MATRIX_SCAN_KB' in result.stdout
+    assert '-DNO_HOUSEKEEPING_TASK_KB' not in result.stdout
+
+
+def test_compile_detect_hooks_included_source():
+    # matrix_scan_user() of preonic:badger comes from the default keymap.c it includes
+    result = cli.run(['make', 'preonic/rev3:badger', '-n', 'SKIP_GIT=yes'], stdin=DEVNULL, combined_output=True)
+    check_returncode(result)
+    assert '-DNO_MATRIX_SCAN_KB' in result.stdout
+    assert '-DNO_MATRIX_SCAN_USER' not in result.stdout
+
+
 def test_flash():
     result = check_subcommand('flash', '-kb', 'handwired/pytest/basic', '-km', 'default', '-n')
     check_returncode(result)
@@ -32,6 +32,16 @@ def test_generate_c_pytest_has_template():
     assert templ == '#include QMK_KEYBOARD_H\nconst uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {\t[0] = LAYOUT(KC_A)};\n'
 
 
+def test_generate_sparse_layers():
+    positions = [[0, 0], [0, 1], [1, 1]]
+    layers = [['KC_A', 'KC_B', 'KC_C'], ['KC_TRNS', 'KC_D', '_______'], ['_______', 'KC_TRNS', 'KC_TRANSPARENT']]
+    dense_count, masks, offsets, keycodes = qmk.keymap.generate_sparse_layers(layers, 2, 8, positions)
+    assert dense_count == 1
+    assert masks == [[0x02, 0x00], [0x00, 0x00]]
+    assert offsets == [[0, 1], [1, 1]]
+    assert keycodes == [['KC_D'], []]
+
+
 def test_generate_json_pytest_has_template():
     templ = qmk.keymap.generate_json('default', 'handwired/pytest/has_template', 'LAYOUT', [['KC_A']])
     assert templ == {"keyboard": "handwired/pytest/has_template", "documentation": "This file is a keymap.json file for handwired/pytest/has_template", "keymap": "default", "layout": "LAYOUT", "layers": [["KC_A"]]}
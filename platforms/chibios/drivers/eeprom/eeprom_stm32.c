@@ -53,6 +53,8 @@
  *
  * FEE_PAGE_COUNT   # Total number of pages to use for eeprom simulation (Compact + Write log)
  * FEE_DENSITY_BYTES   # Size of simulated eeprom. (Defaults to half the space allocated by FEE_PAGE_COUNT)
+ * FEE_COMPACTION_THRESHOLD_BYTES   # Write log usage at which EEPROM_Task() starts compacting in the background (Defaults to 3/4 of the write log)
+ * FEE_COMPACTION_PROGRAM_STEP   # Number of words programmed into the compacted area per EEPROM_Task() call (Defaults to 64)
  * NOTE: The current implementation does not include page swapping,
  * and FEE_DENSITY_BYTES will consume that amount of RAM as a cached view of actual EEPROM contents.
  *
@@ -64,7 +66,7 @@
  * *** General Algorithm ***
  *
  * During initialization:
- * The contents of the Compacted-flash area are loaded and the 1's complement value
+ * The contents of the Compacted-flash area are loaded 32 bits at a time and the 1's complement value
  * is cached into memory (e.g. 0xFFFF in Flash represents 0x0000 in cache).
  * Write log entries are processed until a 0xFFFF is reached.
  * Each log entry updates a byte or word in the cache.
@@ -79,6 +81,15 @@
  * If the write log is full, erase both the Compacted-flash area and the Write log, then write cached contents to the Compacted-flash area.
  * Otherwise a Write log entry is constructed and appended to the next free position in the Write log.
  *
+ * During EEPROM_Task():
+ * Once the write log passes FEE_COMPACTION_THRESHOLD_BYTES, compaction is performed in the background
+ * ahead of the write log filling up: one page is erased per call (pages which are already blank are skipped),
+ * then FEE_COMPACTION_PROGRAM_STEP words of cached contents are programmed into the Compacted-flash area per call.
+ * Writes to words which have not yet been reprogrammed only update the cache, as they will be picked up when
+ * their word is programmed. Writes to words which have already been reprogrammed follow the normal rules above.
+ * Compaction, background or not, is not power-loss safe -- contents are only held in memory until it completes.
+ * EEPROM_Flush() completes a background compaction, and is called before resetting or suspending.
+ *
  *
  * *** Write Log Structure ***
  *
@@ -149,12 +160,25 @@
 
 /* In-memory contents of emulated eeprom for faster access */
 /* *TODO: Implement page swapping */
-static uint16_t WordBuf[FEE_DENSITY_BYTES / 2];
+static uint16_t WordBuf[FEE_DENSITY_BYTES / 2] __attribute__((aligned(4)));
 static uint8_t *DataBuf = (uint8_t *)WordBuf;
 
 /* Pointer to the first available slot within the write log */
 static uint16_t *empty_slot;
 
+/* Background compaction state */
+typedef enum {
+    FEE_COMPACTION_IDLE,
+    FEE_COMPACTION_ERASING,
+    FEE_COMPACTION_PROGRAMMING,
+} fee_compaction_state_t;
+
+static fee_compaction_state_t compaction_state = FEE_COMPACTION_IDLE;
+/* Next page to erase while erasing, or the number of compacted bytes programmed so far while programming */
+static uint16_t compaction_cursor;
+
+static void eeprom_compact_step(void);
+
 // #define DEBUG_EEPROM_OUTPUT
 
 /*
@@ -214,12 +238,19 @@ void print_eeprom(void) {
 }
 
 uint16_t EEPROM_Init(void) {
-    /* Load emulated eeprom contents from compacted flash into memory */
-    uint16_t *src  = (uint16_t *)FEE_COMPACTED_BASE_ADDRESS;
-    uint16_t *dest = (uint16_t *)DataBuf;
-    for (; src < (uint16_t *)FEE_COMPACTED_LAST_ADDRESS; ++src, ++dest) {
+    /* Finish any in-progress compaction, as flash contents are incomplete until it's done */
+    EEPROM_Flush();
+
+    /* Load emulated eeprom contents from compacted flash into memory, 32 bits at a time */
+    uint32_t *src  = (uint32_t *)FEE_COMPACTED_BASE_ADDRESS;
+    uint32_t *dest = (uint32_t *)DataBuf;
+    for (; src < (uint32_t *)(FEE_COMPACTED_LAST_ADDRESS & ~(uintptr_t)3); ++src, ++dest) {
         *dest = ~*src;
     }
+#if (FEE_DENSITY_BYTES % 4) != 0
+    /* Trailing half-word */
+    *(uint16_t *)dest = ~*(uint16_t *)src;
+#endif
 
     if (debug_eeprom) {
         println("EEPROM_Init Compacted Pages:");
@@ -288,17 +319,29 @@ uint16_t EEPROM_Init(void) {
     return FEE_DENSITY_BYTES;
 }
 
+/* Erase a single page, skipping the erase if the page is already blank */
+static void eeprom_erase_page(uint16_t page_num) {
+    uint32_t *page = (uint32_t *)(FEE_PAGE_BASE_ADDRESS + (page_num * FEE_PAGE_SIZE));
+    for (uint32_t *src = page; src < page + (FEE_PAGE_SIZE / 4); ++src) {
+        if (*src != 0xFFFFFFFF) {
+            FLASH_Unlock();
+            eeprom_printf("FLASH_ErasePage(0x%04lx)\n", (uint32_t)(uintptr_t)page);
+            FLASH_ErasePage((uintptr_t)page);
+            FLASH_Lock();
+            return;
+        }
+    }
+}
+
 /* Clear flash contents (doesn't touch in-memory DataBuf) */
 static void eeprom_clear(void) {
-    FLASH_Unlock();
+    /* Abandon any in-progress compaction */
+    compaction_state = FEE_COMPACTION_IDLE;
 
     for (uint16_t page_num = 0; page_num < FEE_PAGE_COUNT; ++page_num) {
-        eeprom_printf("FLASH_ErasePage(0x%04lx)\n", (uint32_t)(FEE_PAGE_BASE_ADDRESS + (page_num * FEE_PAGE_SIZE)));
-        FLASH_ErasePage(FEE_PAGE_BASE_ADDRESS + (page_num * FEE_PAGE_SIZE));
+        eeprom_erase_page(page_num);
     }
 
-    FLASH_Lock();
-
     empty_slot = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS;
     eeprom_printf("eeprom_clear empty_slot: 0x%08lx\n", (uint32_t)empty_slot);
 }
@@ -312,20 +355,16 @@ void EEPROM_Erase(void) {
     EEPROM_Init();
 }
 
-/* Compact write log */
-static uint8_t eeprom_compact(void) {
-    /* Erase compacted pages and write log */
-    eeprom_clear();
-
+/* Write emulated eeprom contents from memory to compacted flash, for the supplied byte range */
+static uint8_t eeprom_program_compacted(uint16_t start, uint16_t end) {
     FLASH_Unlock();
 
     FLASH_Status final_status = FLASH_COMPLETE;
 
-    /* Write emulated eeprom contents from memory to compacted flash */
-    uint16_t *src  = (uint16_t *)DataBuf;
-    uintptr_t dest = FEE_COMPACTED_BASE_ADDRESS;
+    uint16_t *src  = (uint16_t *)&DataBuf[start];
+    uintptr_t dest = FEE_COMPACTED_BASE_ADDRESS + start;
     uint16_t  value;
-    for (; dest < FEE_COMPACTED_LAST_ADDRESS; ++src, dest += 2) {
+    for (; dest < FEE_COMPACTED_BASE_ADDRESS + end; ++src, dest += 2) {
         value = *src;
         if (value) {
             eeprom_printf("FLASH_ProgramHalfWord(0x%04lx, 0x%04x)\n", (uint32_t)dest, ~value);
@@ -336,6 +375,16 @@ static uint8_t eeprom_compact(void) {
 
     FLASH_Lock();
 
+    return final_status;
+}
+
+/* Compact write log */
+static uint8_t eeprom_compact(void) {
+    /* Erase compacted pages and write log */
+    eeprom_clear();
+
+    FLASH_Status final_status = eeprom_program_compacted(0, FEE_DENSITY_BYTES);
+
     if (debug_eeprom) {
         println("eeprom_compacted:");
         print_eeprom();
@@ -344,6 +393,70 @@ static uint8_t eeprom_compact(void) {
     return final_status;
 }
 
+/* Perform the next step of background compaction */
+static void eeprom_compact_step(void) {
+    switch (compaction_state) {
+        case FEE_COMPACTION_IDLE:
+            break;
+
+        case FEE_COMPACTION_ERASING:
+            eeprom_erase_page(compaction_cursor++);
+            if (compaction_cursor >= FEE_PAGE_COUNT) {
+                empty_slot        = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS;
+                compaction_cursor = 0;
+                compaction_state  = FEE_COMPACTION_PROGRAMMING;
+            }
+            break;
+
+        case FEE_COMPACTION_PROGRAMMING: {
+            uint16_t end = compaction_cursor + (FEE_COMPACTION_PROGRAM_STEP * 2);
+            if (end > FEE_DENSITY_BYTES) {
+                end = FEE_DENSITY_BYTES;
+            }
+            eeprom_program_compacted(compaction_cursor, end);
+            compaction_cursor = end;
+            if (compaction_cursor >= FEE_DENSITY_BYTES) {
+                compaction_state = FEE_COMPACTION_IDLE;
+                if (debug_eeprom) {
+                    println("eeprom_compacted:");
+                    print_eeprom();
+                }
+            }
+        } break;
+    }
+}
+
+/* Check whether a write only needs to update the cache, as background compaction will program it later */
+static bool eeprom_compaction_pending(uint16_t Address) {
+    switch (compaction_state) {
+        case FEE_COMPACTION_ERASING:
+            return true;
+        case FEE_COMPACTION_PROGRAMMING:
+            return (Address & 0xFFFE) >= compaction_cursor;
+        default:
+            return false;
+    }
+}
+
+void EEPROM_Task(void) {
+    if (compaction_state == FEE_COMPACTION_IDLE) {
+        /* Start compacting ahead of time, rather than stalling a write once the log is full */
+        if ((uintptr_t)empty_slot - FEE_WRITE_LOG_BASE_ADDRESS < FEE_COMPACTION_THRESHOLD_BYTES) {
+            return;
+        }
+        eeprom_println("EEPROM_Task: starting background compaction");
+        compaction_cursor = 0;
+        compaction_state  = FEE_COMPACTION_ERASING;
+    }
+    eeprom_compact_step();
+}
+
+void EEPROM_Flush(void) {
+    while (compaction_state != FEE_COMPACTION_IDLE) {
+        eeprom_compact_step();
+    }
+}
+
 static uint8_t eeprom_write_direct_entry(uint16_t Address) {
     /* Check if we can just write this directly to the compacted flash area */
     uintptr_t directAddress = FEE_COMPACTED_BASE_ADDRESS + (Address & 0xFFFE);
@@ -453,6 +566,11 @@ uint8_t EEPROM_WriteDataByte(uint16_t Address, uint8_t DataByte) {
     DataBuf[Address] = DataByte;
     eeprom_printf("EEPROM_WriteDataByte DataBuf[0x%04x] = 0x%02x\n", Address, DataBuf[Address]);
 
+    /* defer to background compaction if it has yet to program this word */
+    if (eeprom_compaction_pending(Address)) {
+        return FLASH_COMPLETE;
+    }
+
     /* perform the write into flash memory */
     /* First, attempt to write directly into the compacted flash area */
     FLASH_Status status = eeprom_write_direct_entry(Address);
@@ -500,6 +618,11 @@ uint8_t EEPROM_WriteDataWord(uint16_t Address, uint16_t DataWord) {
     *(uint16_t *)(&DataBuf[Address]) = DataWord;
     eeprom_printf("EEPROM_WriteDataWord DataBuf[0x%04x] = 0x%04x\n", Address, *(uint16_t *)(&DataBuf[Address]));
 
+    /* defer to background compaction if it has yet to program this word */
+    if (eeprom_compaction_pending(Address)) {
+        return FLASH_COMPLETE;
+    }
+
     /* perform the write into flash memory */
     /* First, attempt to write directly into the compacted flash area */
     final_status = eeprom_write_direct_entry(Address);
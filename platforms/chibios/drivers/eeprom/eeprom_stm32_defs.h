@@ -122,6 +122,16 @@
 #    define FEE_WRITE_LOG_BYTES (FEE_PAGE_COUNT * FEE_PAGE_SIZE - FEE_DENSITY_BYTES)
 #endif
 
+/* Write log usage at which background compaction starts */
+#ifndef FEE_COMPACTION_THRESHOLD_BYTES
+#    define FEE_COMPACTION_THRESHOLD_BYTES (FEE_WRITE_LOG_BYTES * 3 / 4)
+#endif
+
+/* Number of words programmed per background compaction step */
+#ifndef FEE_COMPACTION_PROGRAM_STEP
+#    define FEE_COMPACTION_PROGRAM_STEP 64
+#endif
+
 /* Start of the emulated eeprom compacted flash area */
 #define FEE_COMPACTED_BASE_ADDRESS FEE_PAGE_BASE_ADDRESS
 /* End of the emulated eeprom compacted flash area */
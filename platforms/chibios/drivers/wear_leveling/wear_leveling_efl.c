@@ -17,6 +17,10 @@ static flash_sector_t first_sector = UINT16_MAX;
 static flash_sector_t sector_count = UINT16_MAX;
 static BaseFlash *    flash;
 
+#if defined(WEAR_LEVELING_TWO_BANK) && defined(STM32_FLASH_SECTOR_SIZE)
+_Static_assert((WEAR_LEVELING_ERASE_SIZE) % (STM32_FLASH_SECTOR_SIZE) == 0, "WEAR_LEVELING_ERASE_SIZE must be a multiple of the flash sector size");
+#endif // defined(WEAR_LEVELING_TWO_BANK) && defined(STM32_FLASH_SECTOR_SIZE)
+
 #ifndef WEAR_LEVELING_EFL_FIRST_SECTOR
 // "Automatic" detection of the flash size -- ideally ChibiOS would have this already, but alas, it doesn't.
 static inline uint32_t detect_flash_size(void) {
@@ -39,6 +43,25 @@ static inline uint32_t detect_flash_size(void) {
 }
 #endif // WEAR_LEVELING_EFL_FIRST_SECTOR
 
+#ifdef WEAR_LEVELING_TWO_BANK
+// Whether [address, address + length) is made up of whole sectors, so that erasing it leaves everything else intact
+static bool range_is_whole_sectors(uint32_t address, uint32_t length) {
+    uint32_t covered = 0;
+    for (int i = 0; i < sector_count; ++i) {
+        flash_offset_t offset = flashGetSectorOffset(flash, first_sector + i) - base_offset;
+        uint32_t       size   = flashGetSectorSize(flash, first_sector + i);
+        if (offset + size <= address || offset >= address + length) {
+            continue;
+        }
+        if (offset < address || offset + size > address + length) {
+            return false;
+        }
+        covered += size;
+    }
+    return covered == length;
+}
+#endif // WEAR_LEVELING_TWO_BANK
+
 bool backing_store_init(void) {
     bs_dprintf("Init\n");
     flash = (BaseFlash *)&EFLD1;
@@ -86,6 +109,19 @@ bool backing_store_init(void) {
 
 #endif // defined(WEAR_LEVELING_EFL_FIRST_SECTOR)
 
+#ifdef WEAR_LEVELING_TWO_BANK
+    // Each erase step must land on sector boundaries, otherwise erasing one bank would also clear part of the other
+    if (sector_count == UINT16_MAX) {
+        return false;
+    }
+    for (uint32_t address = 0; address < (WEAR_LEVELING_BACKING_SIZE); address += (WEAR_LEVELING_ERASE_SIZE)) {
+        if (!range_is_whole_sectors(address, (WEAR_LEVELING_ERASE_SIZE))) {
+            bs_dprintf("Erase size does not match the flash sectors\n");
+            return false;
+        }
+    }
+#endif // WEAR_LEVELING_TWO_BANK
+
     return true;
 }
 
@@ -119,6 +155,35 @@ bool backing_store_erase(void) {
     return ret;
 }
 
+#ifdef WEAR_LEVELING_TWO_BANK
+bool backing_store_erase_range(uint32_t address, uint32_t length) {
+    // Sectors are erased whole, so refuse a range that would leave part of one behind or clear data outside of it
+    if (!range_is_whole_sectors(address, length)) {
+        return false;
+    }
+
+    bool          ret = true;
+    flash_error_t status;
+    for (int i = 0; i < sector_count; ++i) {
+        flash_offset_t offset = flashGetSectorOffset(flash, first_sector + i) - base_offset;
+        if (offset < address || offset >= address + length) {
+            continue;
+        }
+
+        status = flashStartEraseSector(flash, first_sector + i);
+        if (status != FLASH_NO_ERROR && status != FLASH_BUSY_ERASING) {
+            ret = false;
+        }
+
+        status = flashWaitErase(flash);
+        if (status != FLASH_NO_ERROR && status != FLASH_BUSY_ERASING) {
+            ret = false;
+        }
+    }
+    return ret;
+}
+#endif // WEAR_LEVELING_TWO_BANK
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     uint32_t offset = (base_offset + address);
     bs_dprintf("Write ");
@@ -187,6 +187,15 @@ bool backing_store_erase(void) {
     return true;
 }
 
+#ifdef WEAR_LEVELING_TWO_BANK
+bool backing_store_erase_range(uint32_t address, uint32_t length) {
+    interrupts = save_and_disable_interrupts();
+    flash_range_erase((WEAR_LEVELING_RP2040_FLASH_BASE) + address, length);
+    restore_interrupts(interrupts);
+    return true;
+}
+#endif // WEAR_LEVELING_TWO_BANK
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return backing_store_write_bulk(address, &value, 1);
 }
@@ -30,3 +30,8 @@
 #ifndef WEAR_LEVELING_RP2040_FLASH_BASE
 #    define WEAR_LEVELING_RP2040_FLASH_BASE ((WEAR_LEVELING_RP2040_FLASH_SIZE) - (WEAR_LEVELING_BACKING_SIZE))
 #endif
+
+// Erase a single sector at a time during incremental consolidation
+#if defined(WEAR_LEVELING_TWO_BANK) && !defined(WEAR_LEVELING_ERASE_SIZE)
+#    define WEAR_LEVELING_ERASE_SIZE (FLASH_SECTOR_SIZE)
+#endif // defined(WEAR_LEVELING_TWO_BANK) && !defined(WEAR_LEVELING_ERASE_SIZE)
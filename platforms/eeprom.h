@@ -60,8 +60,8 @@ void     eeprom_update_block(const void *__src, void *__dst, size_t __n);
 #    define TOTAL_EEPROM_BYTE_COUNT 4096
 #elif defined(EEPROM_TEST_HARNESS)
 #    ifndef FLASH_STM32_MOCKED
-// Normal tests
-#        define TOTAL_EEPROM_BYTE_COUNT 32
+// Normal tests, with room for the whole EECONFIG block
+#        define TOTAL_EEPROM_BYTE_COUNT 1024
 #    else
 // Flash wear-leveling testing
 #        include "eeprom_stm32_tests.h"
@@ -0,0 +1,66 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "i2c_master.h"
+
+static i2c_mock_stats_t         i2c_stats;
+static const i2c_mock_device_t* i2c_device = NULL;
+
+static i2c_status_t i2c_mock_transfer(uint16_t length) {
+    i2c_stats.transactions++;
+    i2c_stats.bytes += 1 + length; // address byte + payload
+    return I2C_STATUS_SUCCESS;
+}
+
+void i2c_mock_reset_stats(void) {
+    memset(&i2c_stats, 0, sizeof(i2c_stats));
+}
+
+i2c_mock_stats_t i2c_mock_get_stats(void) {
+    return i2c_stats;
+}
+
+void i2c_mock_set_device(const i2c_mock_device_t* device) {
+    i2c_device = device;
+}
+
+void i2c_init(void) {}
+
+i2c_status_t i2c_start(uint8_t address) {
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_mock_transfer(length);
+    return i2c_device ? i2c_device->transmit(address, data, length) : I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_mock_transfer(length);
+    if (i2c_device) {
+        return i2c_device->receive(address, data, length);
+    }
+    memset(data, 0, length);
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    return i2c_mock_transfer(1 + length);
+}
+
+i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    return i2c_mock_transfer(2 + length);
+}
+
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_mock_transfer(1);
+    return i2c_receive(devaddr, data, length, timeout);
+}
+
+i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_mock_transfer(2);
+    return i2c_receive(devaddr, data, length, timeout);
+}
+
+void i2c_stop(void) {}
@@ -0,0 +1,44 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/* Mock i2c_master for the test platform, mirroring the ChibiOS API.
+ * Nothing is actually transmitted; transfers are counted so that tests can
+ * measure bus usage of drivers built on top of i2c_master.
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef int16_t i2c_status_t;
+
+#define I2C_STATUS_SUCCESS (0)
+#define I2C_STATUS_ERROR (-1)
+#define I2C_STATUS_TIMEOUT (-2)
+
+void         i2c_init(void);
+i2c_status_t i2c_start(uint8_t address);
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
+void         i2c_stop(void);
+
+typedef struct i2c_mock_stats_t {
+    uint32_t transactions; // number of start..stop transfers
+    uint32_t bytes;        // total bytes on the bus, including the address byte of each transfer
+} i2c_mock_stats_t;
+
+void             i2c_mock_reset_stats(void);
+i2c_mock_stats_t i2c_mock_get_stats(void);
+
+/* Optional simulated device; when set, transfers are routed to it so that it can
+ * respond with data or NACK. Transfers succeed and receive zeroes otherwise.
+ */
+typedef struct i2c_mock_device_t {
+    i2c_status_t (*transmit)(uint8_t address, const uint8_t* data, uint16_t length);
+    i2c_status_t (*receive)(uint8_t address, uint8_t* data, uint16_t length);
+} i2c_mock_device_t;
+
+void i2c_mock_set_device(const i2c_mock_device_t* device);
@@ -0,0 +1,63 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "spi_master.h"
+
+static spi_mock_stats_t         spi_stats;
+static const spi_mock_device_t *spi_device = NULL;
+
+static uint8_t spi_mock_exchange(uint8_t data) {
+    spi_stats.bytes++;
+    return spi_device ? spi_device->exchange(data) : 0;
+}
+
+void spi_mock_reset_stats(void) {
+    memset(&spi_stats, 0, sizeof(spi_stats));
+}
+
+spi_mock_stats_t spi_mock_get_stats(void) {
+    return spi_stats;
+}
+
+void spi_mock_set_device(const spi_mock_device_t *device) {
+    spi_device = device;
+}
+
+void spi_init(void) {}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    spi_stats.transactions++;
+    if (spi_device) {
+        spi_device->select();
+    }
+    return true;
+}
+
+spi_status_t spi_write(uint8_t data) {
+    return spi_mock_exchange(data);
+}
+
+spi_status_t spi_read(void) {
+    return spi_mock_exchange(0);
+}
+
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; ++i) {
+        spi_mock_exchange(data[i]);
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_receive(uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; ++i) {
+        data[i] = spi_mock_exchange(0);
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+void spi_stop(void) {
+    if (spi_device) {
+        spi_device->deselect();
+    }
+}
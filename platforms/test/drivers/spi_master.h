@@ -0,0 +1,57 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/* Mock spi_master for the test platform, mirroring the ChibiOS API.
+ * Transfers are counted so that tests can measure bus usage of drivers built
+ * on top of spi_master, and optionally routed to a simulated device.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t pin_t;
+
+typedef int16_t spi_status_t;
+
+#define SPI_STATUS_SUCCESS (0)
+#define SPI_STATUS_ERROR (-1)
+#define SPI_STATUS_TIMEOUT (-2)
+
+#define SPI_TIMEOUT_IMMEDIATE (0)
+#define SPI_TIMEOUT_INFINITE (0xFFFF)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void         spi_init(void);
+bool         spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor);
+spi_status_t spi_write(uint8_t data);
+spi_status_t spi_read(void);
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length);
+spi_status_t spi_receive(uint8_t *data, uint16_t length);
+void         spi_stop(void);
+
+typedef struct spi_mock_stats_t {
+    uint32_t transactions; // number of start..stop transfers
+    uint32_t bytes;        // total bytes exchanged on the bus
+} spi_mock_stats_t;
+
+void             spi_mock_reset_stats(void);
+spi_mock_stats_t spi_mock_get_stats(void);
+
+/* Optional simulated device; when set, the device is notified when it's selected
+ * and deselected, and each byte is exchanged with it. Reads return zeroes otherwise.
+ */
+typedef struct spi_mock_device_t {
+    void (*select)(void);
+    uint8_t (*exchange)(uint8_t data);
+    void (*deselect)(void);
+} spi_mock_device_t;
+
+void spi_mock_set_device(const spi_mock_device_t *device);
+
+#ifdef __cplusplus
+}
+#endif
@@ -14,82 +14,105 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "eeprom.h"
+#include "eeprom_mock.h"
 
 static uint8_t buffer[TOTAL_EEPROM_BYTE_COUNT];
 
-uint8_t eeprom_read_byte(const uint8_t *addr) {
+/* Each read, write or update call models one transaction to the underlying storage */
+static eeprom_mock_stats_t          stats;
+static eeprom_mock_write_callback_t write_callback;
+
+static void eeprom_read_raw(uint8_t *dest, const uint8_t *addr, size_t len) {
     uintptr_t offset = (uintptr_t)addr;
-    return buffer[offset];
+    stats.reads++;
+    memcpy(dest, &buffer[offset], len);
 }
 
-void eeprom_write_byte(uint8_t *addr, uint8_t value) {
-    uintptr_t offset = (uintptr_t)addr;
-    buffer[offset]   = value;
+uint8_t eeprom_read_byte(const uint8_t *addr) {
+    uint8_t buf[1];
+    eeprom_read_raw(buf, addr, sizeof(buf));
+    return buf[0];
 }
 
 uint16_t eeprom_read_word(const uint16_t *addr) {
-    const uint8_t *p = (const uint8_t *)addr;
-    return eeprom_read_byte(p) | (eeprom_read_byte(p + 1) << 8);
+    uint8_t buf[2];
+    eeprom_read_raw(buf, (const uint8_t *)addr, sizeof(buf));
+    return buf[0] | (buf[1] << 8);
 }
 
 uint32_t eeprom_read_dword(const uint32_t *addr) {
-    const uint8_t *p = (const uint8_t *)addr;
-    return eeprom_read_byte(p) | (eeprom_read_byte(p + 1) << 8) | (eeprom_read_byte(p + 2) << 16) | (eeprom_read_byte(p + 3) << 24);
+    uint8_t buf[4];
+    eeprom_read_raw(buf, (const uint8_t *)addr, sizeof(buf));
+    return buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
 }
 
 void eeprom_read_block(void *buf, const void *addr, size_t len) {
-    const uint8_t *p    = (const uint8_t *)addr;
-    uint8_t *      dest = (uint8_t *)buf;
-    while (len--) {
-        *dest++ = eeprom_read_byte(p++);
+    eeprom_read_raw((uint8_t *)buf, (const uint8_t *)addr, len);
+}
+
+static void eeprom_write_raw(uint8_t *addr, const uint8_t *src, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+    stats.writes++;
+    stats.bytes_written += len;
+    memcpy(&buffer[offset], src, len);
+    if (write_callback) {
+        write_callback(offset, src, len);
+    }
+}
+
+static void eeprom_update_raw(uint8_t *addr, const uint8_t *src, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+    if (memcmp(&buffer[offset], src, len) != 0) {
+        eeprom_write_raw(addr, src, len);
     }
 }
 
+void eeprom_mock_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+eeprom_mock_stats_t eeprom_mock_get_stats(void) {
+    return stats;
+}
+
+void eeprom_mock_set_write_callback(eeprom_mock_write_callback_t callback) {
+    write_callback = callback;
+}
+
+void eeprom_write_byte(uint8_t *addr, uint8_t value) {
+    eeprom_write_raw(addr, &value, 1);
+}
+
 void eeprom_write_word(uint16_t *addr, uint16_t value) {
-    uint8_t *p = (uint8_t *)addr;
-    eeprom_write_byte(p++, value);
-    eeprom_write_byte(p, value >> 8);
+    uint8_t buf[2] = {value, value >> 8};
+    eeprom_write_raw((uint8_t *)addr, buf, sizeof(buf));
 }
 
 void eeprom_write_dword(uint32_t *addr, uint32_t value) {
-    uint8_t *p = (uint8_t *)addr;
-    eeprom_write_byte(p++, value);
-    eeprom_write_byte(p++, value >> 8);
-    eeprom_write_byte(p++, value >> 16);
-    eeprom_write_byte(p, value >> 24);
+    uint8_t buf[4] = {value, value >> 8, value >> 16, value >> 24};
+    eeprom_write_raw((uint8_t *)addr, buf, sizeof(buf));
 }
 
 void eeprom_write_block(const void *buf, void *addr, size_t len) {
-    uint8_t *      p   = (uint8_t *)addr;
-    const uint8_t *src = (const uint8_t *)buf;
-    while (len--) {
-        eeprom_write_byte(p++, *src++);
-    }
+    eeprom_write_raw((uint8_t *)addr, (const uint8_t *)buf, len);
 }
 
 void eeprom_update_byte(uint8_t *addr, uint8_t value) {
-    eeprom_write_byte(addr, value);
+    eeprom_update_raw(addr, &value, 1);
 }
 
 void eeprom_update_word(uint16_t *addr, uint16_t value) {
-    uint8_t *p = (uint8_t *)addr;
-    eeprom_write_byte(p++, value);
-    eeprom_write_byte(p, value >> 8);
+    uint8_t buf[2] = {value, value >> 8};
+    eeprom_update_raw((uint8_t *)addr, buf, sizeof(buf));
 }
 
 void eeprom_update_dword(uint32_t *addr, uint32_t value) {
-    uint8_t *p = (uint8_t *)addr;
-    eeprom_write_byte(p++, value);
-    eeprom_write_byte(p++, value >> 8);
-    eeprom_write_byte(p++, value >> 16);
-    eeprom_write_byte(p, value >> 24);
+    uint8_t buf[4] = {value, value >> 8, value >> 16, value >> 24};
+    eeprom_update_raw((uint8_t *)addr, buf, sizeof(buf));
 }
 
 void eeprom_update_block(const void *buf, void *addr, size_t len) {
-    uint8_t *      p   = (uint8_t *)addr;
-    const uint8_t *src = (const uint8_t *)buf;
-    while (len--) {
-        eeprom_write_byte(p++, *src++);
-    }
+    eeprom_update_raw((uint8_t *)addr, (const uint8_t *)buf, len);
 }
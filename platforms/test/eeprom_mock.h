@@ -0,0 +1,26 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/* Access statistics for the test platform's RAM-backed EEPROM, so that tests
+ * can measure how many storage transactions a feature issues.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct {
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t bytes_written;
+} eeprom_mock_stats_t;
+
+void                eeprom_mock_reset_stats(void);
+eeprom_mock_stats_t eeprom_mock_get_stats(void);
+
+/* Called after every write that reaches the storage, so that tests can check
+ * the order writes land in. NULL stops the calls.
+ */
+typedef void (*eeprom_mock_write_callback_t)(uintptr_t offset, const uint8_t *data, size_t len);
+
+void eeprom_mock_set_write_callback(eeprom_mock_write_callback_t callback);
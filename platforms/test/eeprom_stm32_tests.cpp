@@ -435,3 +435,144 @@ TEST_F(EepromStm32Test, TestCompaction) {
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE], 0xFFFF);
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + LOG_SIZE - 2], 0xFFFF);
 }
+
+/* Simulated cost of flash operations, modelled on STM32F303 embedded flash */
+#define FLASH_PROGRAM_US 60
+#define FLASH_ERASE_US 20000
+
+/* Number of bytes of the write log in use, i.e. what needs to be replayed at init */
+static uint32_t writeLogUsed(void) {
+    uint32_t used = 0;
+    while (used < LOG_SIZE && *(uint16_t*)&FlashBuf[LOG_BASE + used] != 0xFFFF) {
+        used += 2;
+    }
+    return used;
+}
+
+/* Invokes the supplied operation, returning the simulated time spent in flash operations */
+template <typename F>
+static uint32_t flashCost(F&& func) {
+    uint32_t erases   = FlashEraseCount;
+    uint32_t programs = FlashProgramCount;
+    func();
+    return (FlashEraseCount - erases) * FLASH_ERASE_US + (FlashProgramCount - programs) * FLASH_PROGRAM_US;
+}
+
+/* Fills the write log up to the background compaction threshold */
+static uint32_t fillWriteLog(void) {
+    uint32_t val = 0xd8453c6b;
+    while (writeLogUsed() < FEE_COMPACTION_THRESHOLD_BYTES) {
+        val ^= 0x593ca5b3;
+        eeprom_write_dword((uint32_t*)200, val);
+    }
+    return val;
+}
+
+TEST_F(EepromStm32Test, TestBlankPagesNotErased) {
+    FlashEraseCount = 0;
+    EEPROM_Erase();
+    EXPECT_EQ(FlashEraseCount, 0);
+    eeprom_write_byte((uint8_t*)4, 0x3c);
+    EEPROM_Erase();
+    EXPECT_EQ(FlashEraseCount, 1);
+    EXPECT_EQ(EEPROM_ReadDataByte(4), 0);
+}
+
+TEST_F(EepromStm32Test, TestBackgroundCompaction) {
+    eeprom_write_dword((uint32_t*)0, 0xdeadbeef);
+    eeprom_write_dword((uint32_t*)(EEPROM_SIZE - 4), 0xba5eba11);
+    /* Nothing to do below the threshold */
+    eeprom_write_dword((uint32_t*)200, 0x12345678);
+    eeprom_write_dword((uint32_t*)200, 0x87654321);
+    uint32_t erases = FlashEraseCount;
+    EEPROM_Task();
+    EXPECT_EQ(FlashEraseCount, erases);
+    /* Cross the threshold */
+    uint32_t val = fillWriteLog();
+    /* Each step should erase at most one page, or program at most one chunk */
+    uint32_t steps = 0;
+    while (writeLogUsed() != 0 || steps < FEE_PAGE_COUNT + (EEPROM_SIZE / 2 + FEE_COMPACTION_PROGRAM_STEP - 1) / FEE_COMPACTION_PROGRAM_STEP) {
+        uint32_t erases   = FlashEraseCount;
+        uint32_t programs = FlashProgramCount;
+        EEPROM_Task();
+        EXPECT_LE(FlashEraseCount - erases, 1);
+        EXPECT_LE(FlashProgramCount - programs, FEE_COMPACTION_PROGRAM_STEP);
+        ASSERT_LT(++steps, 1000);
+    }
+    /* Check values */
+    EEPROM_Init();
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdeadbeef);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)200), val);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)(EEPROM_SIZE - 4)), 0xba5eba11);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[EEPROM_BASE + 200], (uint16_t)~(val & 0xFFFF));
+    EXPECT_EQ(writeLogUsed(), 0);
+}
+
+TEST_F(EepromStm32Test, TestWritesDuringBackgroundCompaction) {
+    eeprom_write_dword((uint32_t*)0, 0xdeadbeef);
+    eeprom_write_dword((uint32_t*)(EEPROM_SIZE - 4), 0xba5eba11);
+    fillWriteLog();
+    /* Write while erasing */
+    EEPROM_Task();
+    eeprom_write_dword((uint32_t*)8, 0xcafef00d);
+    /* Write to both programmed and unprogrammed words */
+    for (int i = 1; i < FEE_PAGE_COUNT + 1; ++i) {
+        EEPROM_Task();
+    }
+    eeprom_write_dword((uint32_t*)0, 0xdecafbad);
+    eeprom_write_dword((uint32_t*)(EEPROM_SIZE - 4), 0xfacef00d);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdecafbad);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)(EEPROM_SIZE - 4)), 0xfacef00d);
+    /* Init completes compaction */
+    EEPROM_Init();
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdecafbad);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)8), 0xcafef00d);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)(EEPROM_SIZE - 4)), 0xfacef00d);
+    /* Programmed words were updated through the write log, the rest when they were programmed */
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE], BYTE_VALUE(0, 0xad));
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[EEPROM_BASE + EEPROM_SIZE - 4], (uint16_t)~0xf00d);
+}
+
+TEST_F(EepromStm32Test, TestFlushCompletesBackgroundCompaction) {
+    eeprom_write_dword((uint32_t*)0, 0xdeadbeef);
+    fillWriteLog();
+    /* Stop partway through erasing, with a write only held in the cache */
+    EEPROM_Task();
+    eeprom_write_dword((uint32_t*)8, 0xcafef00d);
+    EEPROM_Flush();
+    /* Flash holds everything without replaying the cache */
+    EXPECT_EQ(writeLogUsed(), 0);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[EEPROM_BASE + 0], (uint16_t)~0xbeef);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[EEPROM_BASE + 8], (uint16_t)~0xf00d);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[EEPROM_BASE + 10], (uint16_t)~0xcafe);
+    /* Nothing left for the task to do */
+    uint32_t erases = FlashEraseCount;
+    EEPROM_Task();
+    EXPECT_EQ(FlashEraseCount, erases);
+}
+
+TEST_F(EepromStm32Test, TestCompactionStallReport) {
+    uint32_t sync_stall = 0, sync_replay = 0;
+    uint32_t bg_stall = 0, bg_replay = 0;
+    uint32_t writes = (LOG_SIZE / 4) * 4;
+    for (bool background : {false, true}) {
+        EEPROM_Erase();
+        uint32_t& stall  = background ? bg_stall : sync_stall;
+        uint32_t& replay = background ? bg_replay : sync_replay;
+        uint32_t  val    = 0x3c6bd845;
+        for (uint32_t i = 0; i < writes; ++i) {
+            val ^= 0x593ca5b3;
+            val += i;
+            uint16_t address = 0x80 + ((i * 2) % (EEPROM_SIZE - 0x80));
+            stall            = std::max(stall, flashCost([&] { EEPROM_WriteDataWord(address, val); }));
+            if (background) {
+                stall = std::max(stall, flashCost([] { EEPROM_Task(); }));
+            }
+            replay = std::max(replay, writeLogUsed());
+        }
+    }
+    printf("[ FEE STALL ] sync compaction:       worst-case stall %7d us, worst-case init replay %5d bytes\n", (int)sync_stall, (int)sync_replay);
+    printf("[ FEE STALL ] background compaction: worst-case stall %7d us, worst-case init replay %5d bytes\n", (int)bg_stall, (int)bg_replay);
+    EXPECT_LT(bg_stall, sync_stall);
+    EXPECT_LT(bg_replay, sync_replay);
+}
@@ -4,5 +4,6 @@
 
 #include "flash_stm32.h"
 #include "eeprom_stm32.h"
+#include "eeprom_stm32_defs.h"
 
 #define EEPROM_SIZE (FEE_PAGE_SIZE * FEE_PAGE_COUNT / 2)
@@ -20,6 +20,9 @@
 
 uint8_t FlashBuf[MOCK_FLASH_SIZE] = {0};
 
+uint32_t FlashEraseCount   = 0;
+uint32_t FlashProgramCount = 0;
+
 static bool flash_locked = true;
 
 FLASH_Status FLASH_ErasePage(uint32_t Page_Address) {
@@ -28,6 +31,7 @@ FLASH_Status FLASH_ErasePage(uint32_t Page_Address) {
     Page_Address -= (Page_Address % FEE_PAGE_SIZE);
     if (Page_Address >= MOCK_FLASH_SIZE) return FLASH_BAD_ADDRESS;
     memset(&FlashBuf[Page_Address], '\xff', FEE_PAGE_SIZE);
+    ++FlashEraseCount;
     return FLASH_COMPLETE;
 }
 
@@ -38,6 +42,7 @@ FLASH_Status FLASH_ProgramHalfWord(uint32_t Address, uint16_t Data) {
     uint16_t oldData = *(uint16_t*)&FlashBuf[Address];
     if (oldData == 0xFFFF || Data == 0) {
         *(uint16_t*)&FlashBuf[Address] = Data;
+        ++FlashProgramCount;
         return FLASH_COMPLETE;
     } else {
         return FLASH_ERROR_PG;
@@ -55,13 +55,13 @@ int retro_tapping_counter = 0;
 #    include "process_auto_shift.h"
 #endif
 
-#ifdef IGNORE_MOD_TAP_INTERRUPT_PER_KEY
+#if defined(IGNORE_MOD_TAP_INTERRUPT_PER_KEY) && !defined(NO_GET_IGNORE_MOD_TAP_INTERRUPT)
 __attribute__((weak)) bool get_ignore_mod_tap_interrupt(uint16_t keycode, keyrecord_t *record) {
     return false;
 }
 #endif
 
-#ifdef RETRO_TAPPING_PER_KEY
+#if defined(RETRO_TAPPING_PER_KEY) && !defined(NO_GET_RETRO_TAPPING)
 __attribute__((weak)) bool get_retro_tapping(uint16_t keycode, keyrecord_t *record) {
     return false;
 }
@@ -206,7 +206,8 @@ void process_hand_swap(keyevent_t *event) {
 bool disable_action_cache = false;
 
 void process_record_nocache(keyrecord_t *record) {
-    disable_action_cache = true;
+    disable_action_cache    = true;
+    record->lookup.resolved = false;
     process_record(record);
     disable_action_cache = false;
 }
@@ -228,7 +229,7 @@ __attribute__((weak)) void post_process_record_quantum(keyrecord_t *record) {}
  * FIXME: Needs documentation.
  */
 void process_record_tap_hint(keyrecord_t *record) {
-    action_t action = layer_switch_get_action(record->event.key);
+    action_t action = action_for_keycode(get_record_keycode(record, true));
 
     switch (action.kind.id) {
 #    ifdef SWAP_HANDS_ENABLE
@@ -270,16 +271,7 @@ void process_record(keyrecord_t *record) {
 }
 
 void process_record_handler(keyrecord_t *record) {
-#ifdef COMBO_ENABLE
-    action_t action;
-    if (record->keycode) {
-        action = action_for_keycode(record->keycode);
-    } else {
-        action = store_or_get_action(record->event.pressed, record->event.key);
-    }
-#else
-    action_t action = store_or_get_action(record->event.pressed, record->event.key);
-#endif
+    action_t action = action_for_keycode(get_record_keycode(record, true));
     dprint("ACTION: ");
     debug_action(action);
 #ifndef NO_ACTION_LAYER
@@ -450,7 +442,7 @@ void process_action(keyrecord_t *record, action_t action) {
 #    if !defined(IGNORE_MOD_TAP_INTERRUPT) || defined(IGNORE_MOD_TAP_INTERRUPT_PER_KEY)
                             if (
 #        ifdef IGNORE_MOD_TAP_INTERRUPT_PER_KEY
-                                !get_ignore_mod_tap_interrupt(get_event_keycode(record->event, false), record) &&
+                                !get_ignore_mod_tap_interrupt(get_record_keycode(record, false), record) &&
 #        endif
                                 record->tap.interrupted) {
                                 dprint("mods_tap: tap: cancel: add_mods\n");
@@ -791,7 +783,7 @@ void process_action(keyrecord_t *record, action_t action) {
             } else {
                 if (
 #        ifdef RETRO_TAPPING_PER_KEY
-                    get_retro_tapping(get_event_keycode(record->event, false), record) &&
+                    get_retro_tapping(get_record_keycode(record, false), record) &&
 #        endif
                     retro_tapping_counter == 2) {
 #        if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)
@@ -1094,16 +1086,7 @@ bool is_tap_record(keyrecord_t *record) {
         return false;
     }
 
-#ifdef COMBO_ENABLE
-    action_t action;
-    if (record->keycode) {
-        action = action_for_keycode(record->keycode);
-    } else {
-        action = layer_switch_get_action(record->event.key);
-    }
-#else
-    action_t action = layer_switch_get_action(record->event.key);
-#endif
+    action_t action = action_for_keycode(get_record_keycode(record, true));
     return is_tap_action(action);
 }
 
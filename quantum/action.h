@@ -44,6 +44,13 @@ typedef struct {
     uint8_t count : 4;
 } tap_t;
 
+/* keycode and source layer of a record, resolved from the keymap once per event */
+typedef struct {
+    uint16_t keycode;
+    uint8_t  layer;
+    bool     resolved;
+} keylookup_t;
+
 /* Key event container for recording */
 typedef struct {
     keyevent_t event;
@@ -53,6 +60,7 @@ typedef struct {
 #ifdef COMBO_ENABLE
     uint16_t keycode;
 #endif
+    keylookup_t lookup;
 } keyrecord_t;
 
 /* Execute action per keyevent */
@@ -80,6 +88,8 @@ typedef uint8_t swap_state_row_t;
 typedef uint16_t swap_state_row_t;
 #    elif (MATRIX_COLS <= 32)
 typedef uint32_t swap_state_row_t;
+#    elif (MATRIX_COLS <= 64)
+typedef uint64_t swap_state_row_t;
 #    else
 #        error "MATRIX_COLS: invalid value"
 #    endif
@@ -13,6 +13,13 @@
 #include "util.h"
 #include "action_layer.h"
 
+// printf has no portable 64-bit conversion, so wide states are printed in two halves
+#ifdef LAYER_STATE_64BIT
+#    define layer_state_debug(state) dprintf("%08lX%08lX(%u)", (uint32_t)((state) >> 32), (uint32_t)(state), get_highest_layer(state))
+#else
+#    define layer_state_debug(state) dprintf("%08lX(%u)", (state), get_highest_layer(state))
+#endif
+
 /** \brief Default Layer State
  */
 layer_state_t default_layer_state = 0;
@@ -54,10 +61,10 @@ static void default_layer_state_set(layer_state_t state) {
 
 /** \brief Default Layer Print
  *
- * Print out the hex value of the 32-bit default layer state, as well as the value of the highest bit.
+ * Print out the hex value of the default layer state, as well as the value of the highest bit.
  */
 void default_layer_debug(void) {
-    dprintf("%08lX(%u)", default_layer_state, get_highest_layer(default_layer_state));
+    layer_state_debug(default_layer_state);
 }
 
 /** \brief Default Layer Set
@@ -215,10 +222,10 @@ void layer_xor(layer_state_t state) {
 
 /** \brief Layer debug printing
  *
- * Print out the hex value of the 32-bit layer state, as well as the value of the highest bit.
+ * Print out the hex value of the layer state, as well as the value of the highest bit.
  */
 void layer_debug(void) {
-    dprintf("%08lX(%u)", layer_state, get_highest_layer(layer_state));
+    layer_state_debug(layer_state);
 }
 #endif
 
@@ -311,47 +318,65 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
     uint8_t layer;
 
     if (pressed) {
-        layer = layer_switch_get_layer(key);
+        uint16_t keycode = layer_switch_get_keycode(key, &layer);
         update_source_layers_cache(key, layer);
-    } else {
-        layer = read_source_layers_cache(key);
+        return action_for_keycode(keycode);
     }
+    layer = read_source_layers_cache(key);
     return action_for_key(layer, key);
 #else
     return layer_switch_get_action(key);
 #endif
 }
 
-/** \brief Layer switch get layer
+/** \brief Layer switch get keycode
  *
- * Gets the layer based on key info
+ * Gets the keycode and the layer it comes from based on key info, looking up
+ * each active layer at most once, and skipping inactive layers by scanning for
+ * the highest bit left in the active mask
  */
-uint8_t layer_switch_get_layer(keypos_t key) {
+uint16_t layer_switch_get_keycode(keypos_t key, uint8_t *layer) {
 #ifndef NO_ACTION_LAYER
-    action_t action;
-    action.code = ACTION_TRANSPARENT;
+    layer_state_t active = layer_state | default_layer_state;
+#    if MAX_LAYER < (1 << MAX_LAYER_BITS)
+    active &= ((layer_state_t)1 << MAX_LAYER) - 1;
+#    endif
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
-    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
-        if (layers & ((layer_state_t)1 << i)) {
-            action = action_for_key(i, key);
-            if (action.code != ACTION_TRANSPARENT) {
-                return i;
-            }
+    for (layer_state_t layers = active; layers;) {
+        uint8_t  i       = get_highest_layer(layers);
+        uint16_t keycode = keymap_key_to_keycode(i, key);
+        // only KC_TRANSPARENT maps to ACTION_TRANSPARENT, keycode_config() leaves it alone
+        if (keycode != KC_TRANSPARENT) {
+            *layer = i;
+            return keycode;
         }
+        layers &= ~((layer_state_t)1 << i);
     }
     /* fall back to layer 0 */
-    return 0;
+    *layer = 0;
+    return (active & 1) ? KC_TRANSPARENT : keymap_key_to_keycode(0, key);
 #else
-    return get_highest_layer(default_layer_state);
+    *layer = get_highest_layer(default_layer_state);
+    return keymap_key_to_keycode(*layer, key);
 #endif
 }
 
+/** \brief Layer switch get layer
+ *
+ * Gets the layer based on key info
+ */
+uint8_t layer_switch_get_layer(keypos_t key) {
+    uint8_t layer;
+    layer_switch_get_keycode(key, &layer);
+    return layer;
+}
+
 /** \brief Layer switch get layer
  *
  * Gets action code based on key position
  */
 action_t layer_switch_get_action(keypos_t key) {
-    return action_for_key(layer_switch_get_layer(key), key);
+    uint8_t layer;
+    return action_for_keycode(layer_switch_get_keycode(key, &layer));
 }
@@ -33,14 +33,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #        ifndef LAYER_STATE_16BIT
 #            define LAYER_STATE_16BIT
 #        endif
-#    else
+#    elif DYNAMIC_KEYMAP_LAYER_COUNT <= 32
 #        ifndef LAYER_STATE_32BIT
 #            define LAYER_STATE_32BIT
 #        endif
+#    else
+#        ifndef LAYER_STATE_64BIT
+#            define LAYER_STATE_64BIT
+#        endif
 #    endif
 #endif
 
-#if !defined(LAYER_STATE_8BIT) && !defined(LAYER_STATE_16BIT) && !defined(LAYER_STATE_32BIT)
+#if !defined(LAYER_STATE_8BIT) && !defined(LAYER_STATE_16BIT) && !defined(LAYER_STATE_32BIT) && !defined(LAYER_STATE_64BIT)
 #    define LAYER_STATE_16BIT
 #endif
 
@@ -65,6 +69,13 @@ typedef uint32_t layer_state_t;
 #        define MAX_LAYER 32
 #    endif
 #    define get_highest_layer(state) biton32(state)
+#elif defined(LAYER_STATE_64BIT)
+typedef uint64_t layer_state_t;
+#    define MAX_LAYER_BITS 6
+#    ifndef MAX_LAYER
+#        define MAX_LAYER 64
+#    endif
+#    define get_highest_layer(state) biton64(state)
 #else
 #    error Layer Mask size not specified.  HOW?!
 #endif
@@ -141,7 +152,8 @@ uint8_t read_source_layers_cache(keypos_t key);
 action_t store_or_get_action(bool pressed, keypos_t key);
 
 /* return the topmost non-transparent layer currently associated with key */
-uint8_t layer_switch_get_layer(keypos_t key);
+uint8_t  layer_switch_get_layer(keypos_t key);
+uint16_t layer_switch_get_keycode(keypos_t key, uint8_t *layer);
 
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
@@ -1,5 +1,6 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #ifdef DEBUG_ACTION
 #    include "debug.h"
@@ -10,6 +11,7 @@
 #include "action.h"
 #include "action_layer.h"
 #include "action_tapping.h"
+#include "action_util.h"
 #include "keycode.h"
 #include "timer.h"
 
@@ -40,53 +42,93 @@ __attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *r
 }
 #    endif
 
-#    ifdef TAPPING_FORCE_HOLD_PER_KEY
+#    if defined(TAPPING_FORCE_HOLD_PER_KEY) && !defined(NO_GET_TAPPING_FORCE_HOLD)
 __attribute__((weak)) bool get_tapping_force_hold(uint16_t keycode, keyrecord_t *record) {
     return false;
 }
 #    endif
 
-#    ifdef PERMISSIVE_HOLD_PER_KEY
+#    if defined(PERMISSIVE_HOLD_PER_KEY) && !defined(NO_GET_PERMISSIVE_HOLD)
 __attribute__((weak)) bool get_permissive_hold(uint16_t keycode, keyrecord_t *record) {
     return false;
 }
 #    endif
 
-#    ifdef HOLD_ON_OTHER_KEY_PRESS_PER_KEY
+#    if defined(HOLD_ON_OTHER_KEY_PRESS_PER_KEY) && !defined(NO_GET_HOLD_ON_OTHER_KEY_PRESS)
 __attribute__((weak)) bool get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record) {
     return false;
 }
 #    endif
 
+#    if defined(SPECULATIVE_HOLD_PER_KEY) && !defined(NO_GET_SPECULATIVE_HOLD)
+__attribute__((weak)) bool get_speculative_hold(uint16_t keycode, keyrecord_t *record) {
+    return false;
+}
+#    endif
+
 #    if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)
 #        include "process_auto_shift.h"
 #    endif
 
+_Static_assert(WAITING_BUFFER_SIZE >= 2 && WAITING_BUFFER_SIZE <= 256, "WAITING_BUFFER_SIZE must be between 2 and 256");
+
 static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
 static uint8_t     waiting_buffer_tail                 = 0;
 
+// summaries of the queued events, kept up to date as they come and go
+static uint8_t waiting_buffer_pressed = 0;
+
+// per key counts cost two bytes per matrix position, so only large buffers, where scanning costs more, keep them
+#    if WAITING_BUFFER_SIZE > 16
+#        define WAITING_BUFFER_KEY_INDEX
+static uint8_t waiting_buffer_unindexed                              = 0;
+static uint8_t waiting_buffer_key_presses[MATRIX_ROWS][MATRIX_COLS]  = {};
+static uint8_t waiting_buffer_key_releases[MATRIX_ROWS][MATRIX_COLS] = {};
+#    endif
+
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
 static void waiting_buffer_clear(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
 static void waiting_buffer_scan_tap(void);
+static void waiting_buffer_process(void);
+static bool waiting_buffer_scan_interrupts(void);
+static void waiting_buffer_remove(uint8_t index);
+static void waiting_buffer_index(keyevent_t event, bool queued);
+static void process_tapping_key(void);
 static void debug_tapping_key(void);
 static void debug_waiting_buffer(void);
 
+#    if defined(SPECULATIVE_HOLD) || defined(SPECULATIVE_HOLD_PER_KEY)
+static uint8_t speculative_mods = 0;
+
+static void speculative_hold_start(void);
+static void speculative_hold_settle(void);
+#    endif
+
 /** \brief Action Tapping Process
  *
  * FIXME: Needs doc
  */
 void action_tapping_process(keyrecord_t record) {
+#    if defined(SPECULATIVE_HOLD) || defined(SPECULATIVE_HOLD_PER_KEY)
+    bool speculate = !IS_TAPPING_PRESSED() && waiting_buffer_head == waiting_buffer_tail;
+#    endif
     if (process_tapping(&record)) {
         if (!IS_NOEVENT(record.event)) {
             debug("processed: ");
             debug_record(record);
             debug("\n");
         }
+#    if defined(SPECULATIVE_HOLD) || defined(SPECULATIVE_HOLD_PER_KEY)
+        // only a tap-hold key pressed with nothing else waiting, so the modifiers cannot reach earlier keys
+        if (speculate && IS_TAPPING_PRESSED() && tapping_key.tap.count == 0 && KEYEQ(tapping_key.event.key, record.event.key) && tapping_key.event.time == record.event.time) {
+            speculative_hold_start();
+        }
+#    endif
     } else {
         if (!waiting_buffer_enq(record)) {
             // clear all in case of overflow.
@@ -94,6 +136,9 @@ void action_tapping_process(keyrecord_t record) {
             clear_keyboard();
             waiting_buffer_clear();
             tapping_key = (keyrecord_t){};
+#    if defined(SPECULATIVE_HOLD) || defined(SPECULATIVE_HOLD_PER_KEY)
+            speculative_mods = 0;
+#    endif
         }
     }
 
@@ -101,22 +146,20 @@ void action_tapping_process(keyrecord_t record) {
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
-            debug("processed: waiting_buffer[");
-            debug_dec(waiting_buffer_tail);
-            debug("] = ");
-            debug_record(waiting_buffer[waiting_buffer_tail]);
-            debug("\n\n");
-        } else {
-            break;
-        }
-    }
+    waiting_buffer_process();
     if (!IS_NOEVENT(record.event)) {
         debug("\n");
     }
 }
 
+/** \brief Tapping key changed
+ *
+ * Whether the tapping key has changed or been resolved since `state` was taken.
+ */
+static bool tapping_key_changed(const keyrecord_t *state) {
+    return !KEYEQ(state->event.key, tapping_key.event.key) || state->event.pressed != tapping_key.event.pressed || state->event.time != tapping_key.event.time || state->tap.count != tapping_key.tap.count;
+}
+
 /** \brief Tapping
  *
  * Rule: Tap key is typed(pressed and released) within TAPPING_TERM.
@@ -126,7 +169,7 @@ void action_tapping_process(keyrecord_t record) {
 bool process_tapping(keyrecord_t *keyp) {
     keyevent_t event = keyp->event;
 #    if (defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)) || defined(PERMISSIVE_HOLD_PER_KEY) || defined(TAPPING_FORCE_HOLD_PER_KEY) || defined(HOLD_ON_OTHER_KEY_PRESS_PER_KEY)
-    uint16_t tapping_keycode = get_record_keycode(&tapping_key, false);
+    uint16_t tapping_keycode = IS_TAPPING() ? get_record_keycode(&tapping_key, false) : KC_NO;
 #    endif
 
     // if tapping
@@ -152,7 +195,7 @@ bool process_tapping(keyrecord_t *keyp) {
                     debug("Tapping: First tap(0->1).\n");
                     tapping_key.tap.count = 1;
                     debug_tapping_key();
-                    process_record(&tapping_key);
+                    process_tapping_key();
 
                     // copy tapping state
                     keyp->tap = tapping_key.tap;
@@ -218,7 +261,7 @@ bool process_tapping(keyrecord_t *keyp) {
                 ) {
                     // clang-format on
                     debug("Tapping: End. No tap. Interfered by typing key\n");
-                    process_record(&tapping_key);
+                    process_tapping_key();
                     tapping_key = (keyrecord_t){};
                     debug_tapping_key();
                     // enqueue
@@ -231,7 +274,7 @@ bool process_tapping(keyrecord_t *keyp) {
                  */
                 else if (IS_RELEASED(event) && !waiting_buffer_typed(event)) {
                     // Modifier should be retained till end of this tapping.
-                    action_t action = layer_switch_get_action(event.key);
+                    action_t action = action_for_keycode(get_record_keycode(keyp, false));
                     switch (action.kind.id) {
                         case ACT_LMODS:
                         case ACT_RMODS:
@@ -258,7 +301,7 @@ bool process_tapping(keyrecord_t *keyp) {
 #        endif
                         {
                             debug("Tapping: End. No tap. Interfered by pressed key\n");
-                            process_record(&tapping_key);
+                            process_tapping_key();
                             tapping_key = (keyrecord_t){};
                             debug_tapping_key();
                             // enqueue
@@ -316,7 +359,7 @@ bool process_tapping(keyrecord_t *keyp) {
                 debug("Tapping: End. Timeout. Not tap(0): ");
                 debug_event(event);
                 debug("\n");
-                process_record(&tapping_key);
+                process_tapping_key();
                 tapping_key = (keyrecord_t){};
                 debug_tapping_key();
                 return false;
@@ -455,6 +498,7 @@ bool waiting_buffer_enq(keyrecord_t record) {
 
     waiting_buffer[waiting_buffer_head] = record;
     waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_index(record.event, true);
 
     debug("waiting_buffer_enq: ");
     debug_waiting_buffer();
@@ -466,15 +510,31 @@ bool waiting_buffer_enq(keyrecord_t record) {
  * FIXME: Needs docs
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_head    = 0;
+    waiting_buffer_tail    = 0;
+    waiting_buffer_pressed = 0;
+#    ifdef WAITING_BUFFER_KEY_INDEX
+    waiting_buffer_unindexed = 0;
+    memset(waiting_buffer_key_presses, 0, sizeof(waiting_buffer_key_presses));
+    memset(waiting_buffer_key_releases, 0, sizeof(waiting_buffer_key_releases));
+#    endif
 }
 
 /** \brief Waiting buffer typed
  *
- * FIXME: Needs docs
+ * Whether the buffer holds the counterpart of `event`: a release of the same
+ * key for a press, or a press for a release.
  */
 bool waiting_buffer_typed(keyevent_t event) {
+#    ifdef WAITING_BUFFER_KEY_INDEX
+    if (event.key.row < MATRIX_ROWS && event.key.col < MATRIX_COLS) {
+        return (event.pressed ? waiting_buffer_key_releases : waiting_buffer_key_presses)[event.key.row][event.key.col] > 0;
+    }
+    // combos and encoders are not indexed
+    if (waiting_buffer_unindexed == 0) {
+        return false;
+    }
+#    endif
     for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
             return true;
@@ -485,13 +545,10 @@ bool waiting_buffer_typed(keyevent_t event) {
 
 /** \brief Waiting buffer has anykey pressed
  *
- * FIXME: Needs docs
+ * Whether the buffer holds any key press.
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
-    }
-    return false;
+    return waiting_buffer_pressed > 0;
 }
 
 /** \brief Scan buffer for tapping
@@ -503,12 +560,14 @@ void waiting_buffer_scan_tap(void) {
     if (tapping_key.tap.count > 0) return;
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
+    // no release of the tapping key queued
+    if (!waiting_buffer_typed(tapping_key.event)) return;
 
     for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
         if (IS_TAPPING_KEY(waiting_buffer[i].event.key) && !waiting_buffer[i].event.pressed && WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
             tapping_key.tap.count       = 1;
             waiting_buffer[i].tap.count = 1;
-            process_record(&tapping_key);
+            process_tapping_key();
 
             debug("waiting_buffer_scan_tap: found at [");
             debug_dec(i);
@@ -519,6 +578,207 @@ void waiting_buffer_scan_tap(void) {
     }
 }
 
+/** \brief Process tapping key
+ *
+ * Processes the press of the tapping key, once it has settled as a tap or hold.
+ */
+static void process_tapping_key(void) {
+#    if defined(SPECULATIVE_HOLD) || defined(SPECULATIVE_HOLD_PER_KEY)
+    speculative_hold_settle();
+#    endif
+    process_record(&tapping_key);
+}
+
+#    if defined(SPECULATIVE_HOLD) || defined(SPECULATIVE_HOLD_PER_KEY)
+/** \brief Speculative hold start
+ *
+ * Sends the modifiers of a mod-tap tapping key to the host right away, before
+ * it settles, so that they already apply to mouse clicks and the like.
+ */
+static void speculative_hold_start(void) {
+    uint16_t keycode = get_record_keycode(&tapping_key, false);
+    action_t action  = action_for_keycode(keycode);
+    uint8_t  mods;
+
+    switch (action.kind.id) {
+        case ACT_LMODS_TAP:
+        case ACT_RMODS_TAP:
+            switch (action.layer_tap.code) {
+                case MODS_ONESHOT:
+                case MODS_TAP_TOGGLE:
+                    return;
+            }
+            mods = (action.kind.id == ACT_LMODS_TAP) ? action.key.mods : action.key.mods << 4;
+            break;
+        default:
+            return;
+    }
+
+    if ((mods & ~(SPECULATIVE_HOLD_MODS))
+#        ifdef SPECULATIVE_HOLD_PER_KEY
+        || !get_speculative_hold(keycode, &tapping_key)
+#        endif
+    ) {
+        return;
+    }
+
+    // leave modifiers that are already held to whoever holds them
+    speculative_mods = mods & ~get_mods();
+    if (speculative_mods) {
+        debug("Tapping: speculative hold\n");
+        add_mods(speculative_mods);
+        send_keyboard_report();
+    }
+}
+
+/** \brief Speculative hold settle
+ *
+ * Takes back the modifiers sent ahead of the tapping key. A hold registers them
+ * again without a report in between, a tap has them released before it is sent.
+ */
+static void speculative_hold_settle(void) {
+    if (!speculative_mods) {
+        return;
+    }
+
+    del_mods(speculative_mods);
+    speculative_mods = 0;
+
+    // clang-format off
+    if (tapping_key.tap.count > 0
+#        if !defined(IGNORE_MOD_TAP_INTERRUPT) || defined(IGNORE_MOD_TAP_INTERRUPT_PER_KEY)
+        // an interrupted tap is a hold, see process_action()
+        && !(tapping_key.tap.interrupted
+#            ifdef IGNORE_MOD_TAP_INTERRUPT_PER_KEY
+             && !get_ignore_mod_tap_interrupt(get_record_keycode(&tapping_key, false), &tapping_key)
+#            endif
+        )
+#        endif
+    ) {
+        // clang-format on
+        send_keyboard_report();
+    }
+}
+#    endif
+
+/** \brief Waiting buffer process
+ *
+ * Processes the waiting buffer in order, up to the first event that still has
+ * to wait for the tapping key.
+ *
+ * A tap-hold key that becomes the tapping key from inside the buffer has not
+ * seen the events queued behind it, which it would have been handed one by one
+ * had they arrived after it. Those are handed to it as well, so that rolled and
+ * nested tap-hold keys settle on their own interrupt rules at once, instead of
+ * waiting for the next live event or their tapping term.
+ */
+static void waiting_buffer_process(void) {
+    keyrecord_t state = tapping_key;
+
+    while (waiting_buffer_tail != waiting_buffer_head) {
+        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+            debug("processed: waiting_buffer[");
+            debug_dec(waiting_buffer_tail);
+            debug("] = ");
+            debug_record(waiting_buffer[waiting_buffer_tail]);
+            debug("\n\n");
+            waiting_buffer_index(waiting_buffer[waiting_buffer_tail].event, false);
+            waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+            continue;
+        }
+        if (tapping_key_changed(&state)) {
+            state = tapping_key;
+            if (waiting_buffer_scan_interrupts()) {
+                // settled meanwhile, start over from the oldest event
+                state = tapping_key;
+                continue;
+            }
+        }
+        break;
+    }
+}
+
+/** \brief Scan buffer for interrupts
+ *
+ * Hands the events behind the head of the buffer to the tapping key, each one
+ * seeing only the events queued before it, like it would have on arrival.
+ * Events processed on the way are removed from the buffer.
+ *
+ * Returns true when the tapping key settled, and the buffer has to be processed
+ * again from its head.
+ */
+static bool waiting_buffer_scan_interrupts(void) {
+    keyrecord_t state   = tapping_key;
+    uint8_t     head    = waiting_buffer_head;
+    uint8_t     i       = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE;
+    bool        settled = false;
+
+    // hide the events from the summaries as well, and show them again one by one
+    for (uint8_t j = i; j != head; j = (j + 1) % WAITING_BUFFER_SIZE) {
+        waiting_buffer_index(waiting_buffer[j].event, false);
+    }
+
+    while (i != head && !settled) {
+        waiting_buffer_head = i;
+        bool processed      = process_tapping(&waiting_buffer[i]);
+        waiting_buffer_head = head;
+
+        if (processed) {
+            debug("processed: waiting_buffer[");
+            debug_dec(i);
+            debug("] = ");
+            debug_record(waiting_buffer[i]);
+            debug("\n\n");
+            // back in, for waiting_buffer_remove() to count it out
+            waiting_buffer_index(waiting_buffer[i].event, true);
+            waiting_buffer_remove(i);
+            head = waiting_buffer_head;
+        } else {
+            waiting_buffer_index(waiting_buffer[i].event, true);
+            i = (i + 1) % WAITING_BUFFER_SIZE;
+        }
+
+        settled = tapping_key_changed(&state);
+    }
+
+    for (; i != head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+        waiting_buffer_index(waiting_buffer[i].event, true);
+    }
+    return settled;
+}
+
+/** \brief Waiting buffer remove
+ *
+ * Removes the event at `index`, keeping the ones queued after it in order.
+ */
+static void waiting_buffer_remove(uint8_t index) {
+    waiting_buffer_index(waiting_buffer[index].event, false);
+    for (uint8_t i = index, next = (index + 1) % WAITING_BUFFER_SIZE; next != waiting_buffer_head; i = next, next = (next + 1) % WAITING_BUFFER_SIZE) {
+        waiting_buffer[i] = waiting_buffer[next];
+    }
+    waiting_buffer_head = (waiting_buffer_head + WAITING_BUFFER_SIZE - 1) % WAITING_BUFFER_SIZE;
+}
+
+/** \brief Waiting buffer index
+ *
+ * Counts `event` in or out of the summaries of the buffer, as it is queued or
+ * leaves it.
+ */
+static void waiting_buffer_index(keyevent_t event, bool queued) {
+    int8_t delta = queued ? 1 : -1;
+
+    if (event.pressed) {
+        waiting_buffer_pressed += delta;
+    }
+#    ifdef WAITING_BUFFER_KEY_INDEX
+    if (event.key.row < MATRIX_ROWS && event.key.col < MATRIX_COLS) {
+        (event.pressed ? waiting_buffer_key_presses : waiting_buffer_key_releases)[event.key.row][event.key.col] += delta;
+    } else {
+        waiting_buffer_unindexed += delta;
+    }
+#    endif
+}
+
 /** \brief Tapping key debug print
  *
  * FIXME: Needs docs
@@ -27,12 +27,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define TAPPING_TOGGLE 5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* number of events queued while a tap-hold key settles */
+#ifndef WAITING_BUFFER_SIZE
+#    define WAITING_BUFFER_SIZE 8
+#endif
+
+/* modifiers a mod-tap may send ahead of settling, with SPECULATIVE_HOLD */
+#ifndef SPECULATIVE_HOLD_MODS
+#    define SPECULATIVE_HOLD_MODS (MOD_MASK_CTRL | MOD_MASK_SHIFT)
+#endif
 
-#ifndef NO_ACTION_TAPPING
 uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
 uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
-void     action_tapping_process(keyrecord_t record);
+
+#ifndef NO_ACTION_TAPPING
+void action_tapping_process(keyrecord_t record);
 #endif
 
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
@@ -40,12 +49,34 @@ bool     get_permissive_hold(uint16_t keycode, keyrecord_t *record);
 bool     get_ignore_mod_tap_interrupt(uint16_t keycode, keyrecord_t *record);
 bool     get_tapping_force_hold(uint16_t keycode, keyrecord_t *record);
 bool     get_retro_tapping(uint16_t keycode, keyrecord_t *record);
+bool     get_speculative_hold(uint16_t keycode, keyrecord_t *record);
+bool     get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record);
+
+/* per-key hooks left at their default, see builddefs/detect_hooks.mk */
+#ifdef NO_GET_PERMISSIVE_HOLD
+#    define get_permissive_hold(keycode, record) ((void)(keycode), (void)(record), false)
+#endif
+#ifdef NO_GET_IGNORE_MOD_TAP_INTERRUPT
+#    define get_ignore_mod_tap_interrupt(keycode, record) ((void)(keycode), (void)(record), false)
+#endif
+#ifdef NO_GET_TAPPING_FORCE_HOLD
+#    define get_tapping_force_hold(keycode, record) ((void)(keycode), (void)(record), false)
+#endif
+#ifdef NO_GET_RETRO_TAPPING
+#    define get_retro_tapping(keycode, record) ((void)(keycode), (void)(record), false)
+#endif
+#ifdef NO_GET_SPECULATIVE_HOLD
+#    define get_speculative_hold(keycode, record) ((void)(keycode), (void)(record), false)
+#endif
+#ifdef NO_GET_HOLD_ON_OTHER_KEY_PRESS
+#    define get_hold_on_other_key_press(keycode, record) ((void)(keycode), (void)(record), false)
+#endif
 
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
 extern uint16_t g_tapping_term;
 #endif
 
-#ifdef TAPPING_TERM_PER_KEY
+#if defined(TAPPING_TERM_PER_KEY) && !defined(NO_GET_TAPPING_TERM)
 #    define GET_TAPPING_TERM(keycode, record) get_tapping_term(keycode, record)
 #elif defined(DYNAMIC_TAPPING_TERM_ENABLE)
 #    define GET_TAPPING_TERM(keycode, record) g_tapping_term
@@ -43,6 +43,13 @@ uint8_t bitpop32(uint32_t bits) {
     return c;
 }
 
+uint8_t bitpop64(uint64_t bits) {
+    uint8_t c;
+    for (c = 0; bits; c++)
+        bits &= bits - 1;
+    return c;
+}
+
 // most significant on-bit - return highest location of on-bit
 // NOTE: return 0 when bit0 is on or all bits are off
 __attribute__((noinline)) uint8_t biton(uint8_t bits) {
@@ -108,6 +115,15 @@ uint8_t biton32(uint32_t bits) {
     return n;
 }
 
+uint8_t biton64(uint64_t bits) {
+    uint8_t n = 0;
+    if (bits >> 32) {
+        bits >>= 32;
+        n += 32;
+    }
+    return n + biton32((uint32_t)bits);
+}
+
 __attribute__((noinline)) uint8_t bitrev(uint8_t bits) {
     bits = (bits & 0x0f) << 4 | (bits & 0xf0) >> 4;
     bits = (bits & 0b00110011) << 2 | (bits & 0b11001100) >> 2;
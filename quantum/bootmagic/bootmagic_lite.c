@@ -51,7 +51,7 @@ __attribute__((weak)) void bootmagic_lite(void) {
     }
 #endif
 
-    if (matrix_get_row(row) & (1 << col)) {
+    if (matrix_get_row(row) & (MATRIX_ROW_SHIFTER << col)) {
         bootmagic_lite_reset_eeprom();
 
         // Jump to bootloader.
@@ -129,6 +129,11 @@ static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], ui
     for (uint8_t row = 0; row < num_rows; row++) {
         matrix_row_t delta        = raw[row] ^ cooked[row];
         matrix_row_t existing_row = cooked[row];
+        if (!delta) {
+            // nothing to start in this row, skip its counters a whole row at a time
+            debounce_pointer += MATRIX_COLS;
+            continue;
+        }
         for (uint8_t col = 0; col < MATRIX_COLS; col++) {
             matrix_row_t col_mask = (ROW_SHIFTER << col);
             if (delta & col_mask) {
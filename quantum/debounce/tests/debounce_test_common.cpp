@@ -98,7 +98,7 @@ void DebounceTest::runEventsInternal() {
 
         /* Check output matrix has expected change events */
         for (auto &output : event.outputs_) {
-            EXPECT_EQ(!!(cooked_matrix_[output.row_] & (1U << output.col_)), directionValue(output.direction_)) << "Missing event at " << strTime() << " expected key " << output.row_ << "," << output.col_ << " " << directionLabel(output.direction_) << "\ninput_matrix: changed=" << !event.inputs_.empty() << "\n" << strMatrix(input_matrix_) << "\nexpected_matrix:\n" << strMatrix(output_matrix_) << "\nactual_matrix:\n" << strMatrix(cooked_matrix_);
+            EXPECT_EQ(!!(cooked_matrix_[output.row_] & (MATRIX_ROW_SHIFTER << output.col_)), directionValue(output.direction_)) << "Missing event at " << strTime() << " expected key " << output.row_ << "," << output.col_ << " " << directionLabel(output.direction_) << "\ninput_matrix: changed=" << !event.inputs_.empty() << "\n" << strMatrix(input_matrix_) << "\nexpected_matrix:\n" << strMatrix(output_matrix_) << "\nactual_matrix:\n" << strMatrix(cooked_matrix_);
         }
 
         /* Check output matrix has no other changes */
@@ -162,7 +162,7 @@ std::string DebounceTest::strMatrix(matrix_row_t matrix[]) {
     for (int row = 0; row < MATRIX_ROWS; row++) {
         text << "\t" << std::setw(2) << row << ":";
         for (int col = 0; col < MATRIX_COLS; col++) {
-            text << ((matrix[row] & (1U << col)) ? " XX" : " __");
+            text << ((matrix[row] & (MATRIX_ROW_SHIFTER << col)) ? " XX" : " __");
         }
 
         text << "\n";
@@ -193,19 +193,19 @@ std::string DebounceTest::directionLabel(Direction direction) {
 
 /* Modify a matrix and verify that events always specify a change */
 void DebounceTest::matrixUpdate(matrix_row_t matrix[], const std::string &name, const MatrixTestEvent &event) {
-    ASSERT_NE(!!(matrix[event.row_] & (1U << event.col_)), directionValue(event.direction_)) << "Test " << name << " at " << strTime() << " sets key " << event.row_ << "," << event.col_ << " " << directionLabel(event.direction_) << " but it is already " << directionLabel(event.direction_) << "\n" << name << "_matrix:\n" << strMatrix(matrix);
+    ASSERT_NE(!!(matrix[event.row_] & (MATRIX_ROW_SHIFTER << event.col_)), directionValue(event.direction_)) << "Test " << name << " at " << strTime() << " sets key " << event.row_ << "," << event.col_ << " " << directionLabel(event.direction_) << " but it is already " << directionLabel(event.direction_) << "\n" << name << "_matrix:\n" << strMatrix(matrix);
 
     switch (event.direction_) {
         case DOWN:
-            matrix[event.row_] |= (1U << event.col_);
+            matrix[event.row_] |= (MATRIX_ROW_SHIFTER << event.col_);
             break;
 
         case UP:
-            matrix[event.row_] &= ~(1U << event.col_);
+            matrix[event.row_] &= ~(MATRIX_ROW_SHIFTER << event.col_);
             break;
     }
 }
 
 DebounceTestEvent::DebounceTestEvent(fast_timer_t time, std::initializer_list<MatrixTestEvent> inputs, std::initializer_list<MatrixTestEvent> outputs) : time_(time), inputs_(inputs), outputs_(outputs) {}
 
-MatrixTestEvent::MatrixTestEvent(int row, int col, Direction direction) : row_(row), col_(col), direction_(direction) {}
+MatrixTestEvent::MatrixTestEvent(int row, int col, Direction direction) : row_(row), col_(col + DEBOUNCE_TEST_COL_OFFSET), direction_(direction) {}
@@ -25,6 +25,12 @@ extern "C" {
 #include "timer.h"
 }
 
+/* Shifts every test key right by this many columns, so that the same tests
+ * can run across a word boundary of wide matrix rows. */
+#ifndef DEBOUNCE_TEST_COL_OFFSET
+#    define DEBOUNCE_TEST_COL_OFFSET 0
+#endif
+
 enum Direction {
     DOWN,
     UP,
@@ -14,6 +14,7 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 DEBOUNCE_COMMON_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -DDEBOUNCE=5
+DEBOUNCE_WIDE_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=40 -DDEBOUNCE=5 -DDEBOUNCE_TEST_COL_OFFSET=31
 
 DEBOUNCE_COMMON_SRC := $(QUANTUM_PATH)/debounce/tests/debounce_test_common.cpp \
 	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
@@ -47,3 +48,12 @@ debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
 debounce_asym_eager_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c \
 	$(QUANTUM_PATH)/debounce/tests/asym_eager_defer_pk_tests.cpp
+
+debounce_sym_defer_g_wide_DEFS := $(DEBOUNCE_WIDE_DEFS)
+debounce_sym_defer_g_wide_SRC := $(debounce_sym_defer_g_SRC)
+
+debounce_sym_defer_pk_wide_DEFS := $(DEBOUNCE_WIDE_DEFS)
+debounce_sym_defer_pk_wide_SRC := $(debounce_sym_defer_pk_SRC)
+
+debounce_sym_eager_pk_wide_DEFS := $(DEBOUNCE_WIDE_DEFS)
+debounce_sym_eager_pk_wide_SRC := $(debounce_sym_eager_pk_SRC)
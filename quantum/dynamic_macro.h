@@ -77,7 +77,7 @@ void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_
 void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
     dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
 
-    uint32_t saved_layer_state = layer_state;
+    layer_state_t saved_layer_state = layer_state;
 
     clear_keyboard();
     layer_clear();
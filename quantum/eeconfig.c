@@ -1,8 +1,10 @@
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "eeprom.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "timer.h"
 
 #if defined(EEPROM_DRIVER)
 #    include "eeprom_driver.h"
@@ -13,11 +15,216 @@
 #endif
 
 #if defined(VIA_ENABLE)
-bool via_eeprom_is_valid(void);
-void via_eeprom_set_valid(bool valid);
-void eeconfig_init_via(void);
+#    include "via.h"
 #endif
 
+/* The small configuration blocks at the start of EEPROM are mirrored in RAM.
+ * VIA's magic and layout options are included when they directly follow the
+ * EECONFIG_* block; keyboard-level VIA custom config is left to its owner.
+ */
+#if defined(VIA_ENABLE) && VIA_EEPROM_MAGIC_ADDR == EECONFIG_SIZE
+#    define EECONFIG_IMAGE_SIZE (VIA_EEPROM_CUSTOM_CONFIG_ADDR)
+#else
+#    define EECONFIG_IMAGE_SIZE (EECONFIG_SIZE)
+#endif
+
+_Static_assert(EECONFIG_IMAGE_SIZE <= UINT8_MAX, "EECONFIG RAM image is too large");
+
+static uint8_t eeconfig_image[EECONFIG_IMAGE_SIZE];
+static uint8_t eeconfig_dirty[(EECONFIG_IMAGE_SIZE + 7) / 8];
+static bool    eeconfig_image_loaded      = false;
+static bool    eeconfig_image_is_dirty    = false;
+static uint8_t eeconfig_transaction_depth = 0;
+#if EECONFIG_FLUSH_DELAY_MS > 0
+static uint32_t eeconfig_dirty_time = 0;
+#endif
+
+/** \brief Loads the RAM image with a single bulk read, on first use
+ */
+static void eeconfig_image_load(void) {
+    if (!eeconfig_image_loaded) {
+        eeprom_read_block(eeconfig_image, (const void *)0, EECONFIG_IMAGE_SIZE);
+        eeconfig_image_loaded = true;
+    }
+}
+
+#if defined(EEPROM_DRIVER)
+/** \brief Discards the RAM image after the underlying storage was erased
+ */
+static void eeconfig_image_invalidate(void) {
+    memset(eeconfig_dirty, 0, sizeof(eeconfig_dirty));
+    eeconfig_image_is_dirty = false;
+    eeconfig_image_loaded   = false;
+}
+#endif
+
+static inline bool eeconfig_is_dirty(uint8_t i) {
+    return eeconfig_dirty[i / 8] & (1 << (i % 8));
+}
+
+/** \brief Writes staged changes in the RAM image back to EEPROM
+ *
+ * The range spanning all dirty bytes is written with a single block write,
+ * trimmed so that bytes which already hold their value are not rewritten.
+ * All clean bytes are refreshed from EEPROM first, so that data written
+ * directly with eeprom_update_*() is never overwritten with stale values from
+ * the image, and is seen by later reads.
+ */
+void eeconfig_flush(void) {
+    if (!eeconfig_image_is_dirty) {
+        return;
+    }
+
+    uint8_t start = 0;
+    uint8_t end   = EECONFIG_IMAGE_SIZE;
+    while (start < end && !eeconfig_is_dirty(start)) {
+        ++start;
+    }
+    while (end > start && !eeconfig_is_dirty(end - 1)) {
+        --end;
+    }
+
+    uint8_t current[EECONFIG_IMAGE_SIZE];
+    eeprom_read_block(current, (const void *)0, EECONFIG_IMAGE_SIZE);
+    for (uint8_t i = 0; i < EECONFIG_IMAGE_SIZE; ++i) {
+        if (!eeconfig_is_dirty(i)) {
+            eeconfig_image[i] = current[i];
+        }
+    }
+    while (start < end && current[start] == eeconfig_image[start]) {
+        ++start;
+    }
+    while (end > start && current[end - 1] == eeconfig_image[end - 1]) {
+        --end;
+    }
+    if (start < end) {
+        eeprom_write_block(&eeconfig_image[start], (void *)(uintptr_t)start, end - start);
+    }
+
+    memset(eeconfig_dirty, 0, sizeof(eeconfig_dirty));
+    eeconfig_image_is_dirty = false;
+}
+
+/** \brief Flushes the RAM image once changes have settled
+ *
+ * Only needed when EECONFIG_FLUSH_DELAY_MS is non-zero; otherwise changes are
+ * written as soon as they are made, or when the enclosing transaction commits.
+ */
+void eeconfig_task(void) {
+#if EECONFIG_FLUSH_DELAY_MS > 0
+    if (eeconfig_image_is_dirty && eeconfig_transaction_depth == 0 && timer_elapsed32(eeconfig_dirty_time) >= EECONFIG_FLUSH_DELAY_MS) {
+        eeconfig_flush();
+    }
+#endif
+}
+
+/** \brief Opens an eeconfig transaction
+ *
+ * Until the matching eeconfig_transaction_commit(), updates to the EECONFIG_*
+ * block are only staged in the RAM image. Transactions may be nested, in which
+ * case only the outermost commit writes to EEPROM.
+ */
+void eeconfig_transaction_begin(void) {
+    eeconfig_image_load();
+    ++eeconfig_transaction_depth;
+}
+
+/** \brief Closes an eeconfig transaction, writing all staged changes at once
+ *
+ * Reads made while the transaction is open come from the RAM image, and do not
+ * see direct eeprom_update_*() writes to the EECONFIG_* block. Those become
+ * visible once the outermost transaction commits; where they touch the same
+ * bytes as a staged eeconfig_update_*(), the staged value wins.
+ */
+void eeconfig_transaction_commit(void) {
+    if (eeconfig_transaction_depth == 0 || --eeconfig_transaction_depth > 0) {
+        return;
+    }
+    if (eeconfig_image_is_dirty) {
+#if EECONFIG_FLUSH_DELAY_MS == 0
+        eeconfig_flush();
+#endif
+    } else {
+        // Nothing to write, but reload on the next read in case of direct writes
+        eeconfig_image_loaded = false;
+    }
+}
+
+/** \brief Checks whether an eeconfig transaction is open
+ */
+bool eeconfig_in_transaction(void) {
+    return eeconfig_transaction_depth > 0;
+}
+
+/** \brief Reads a block of EEPROM, served from the RAM image where possible
+ */
+void eeconfig_read_block(void *buf, const void *addr, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+    if (offset + len <= EECONFIG_IMAGE_SIZE) {
+        eeconfig_image_load();
+        memcpy(buf, &eeconfig_image[offset], len);
+    } else {
+        eeprom_read_block(buf, addr, len);
+    }
+}
+
+/** \brief Updates a block of EEPROM through the RAM image where possible
+ */
+void eeconfig_update_block(const void *buf, void *addr, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+    if (offset + len > EECONFIG_IMAGE_SIZE) {
+        eeprom_update_block(buf, addr, len);
+        return;
+    }
+
+    // Bytes are marked dirty even if the image already holds the value, as the
+    // flush compares against EEPROM and skips anything that is unchanged there
+    eeconfig_image_load();
+    memcpy(&eeconfig_image[offset], buf, len);
+    for (uint8_t i = offset; i < offset + len; ++i) {
+        eeconfig_dirty[i / 8] |= 1 << (i % 8);
+    }
+    eeconfig_image_is_dirty = true;
+
+#if EECONFIG_FLUSH_DELAY_MS > 0
+    eeconfig_dirty_time = timer_read32();
+#else
+    if (eeconfig_transaction_depth == 0) {
+        eeconfig_flush();
+    }
+#endif
+}
+
+static inline uint8_t eeconfig_read_u8(const uint8_t *addr) {
+    uint8_t val;
+    eeconfig_read_block(&val, addr, sizeof(val));
+    return val;
+}
+
+static inline uint16_t eeconfig_read_u16(const uint16_t *addr) {
+    uint16_t val;
+    eeconfig_read_block(&val, addr, sizeof(val));
+    return val;
+}
+
+static inline uint32_t eeconfig_read_u32(const uint32_t *addr) {
+    uint32_t val;
+    eeconfig_read_block(&val, addr, sizeof(val));
+    return val;
+}
+
+static inline void eeconfig_update_u8(uint8_t *addr, uint8_t val) {
+    eeconfig_update_block(&val, addr, sizeof(val));
+}
+
+static inline void eeconfig_update_u16(uint16_t *addr, uint16_t val) {
+    eeconfig_update_block(&val, addr, sizeof(val));
+}
+
+static inline void eeconfig_update_u32(uint32_t *addr, uint32_t val) {
+    eeconfig_update_block(&val, addr, sizeof(val));
+}
+
 /** \brief eeconfig enable
  *
  * FIXME: needs doc
@@ -40,31 +247,33 @@ __attribute__((weak)) void eeconfig_init_kb(void) {
 void eeconfig_init_quantum(void) {
 #if defined(EEPROM_DRIVER)
     eeprom_driver_erase();
+    eeconfig_image_invalidate();
 #endif
-    eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
-    eeprom_update_byte(EECONFIG_DEBUG, 0);
-    eeprom_update_byte(EECONFIG_DEFAULT_LAYER, 0);
+    eeconfig_transaction_begin();
+    eeconfig_update_u16(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
+    eeconfig_update_u8(EECONFIG_DEBUG, 0);
+    eeconfig_update_u8(EECONFIG_DEFAULT_LAYER, 0);
     default_layer_state = 0;
-    eeprom_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, 0);
-    eeprom_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, 0x4);
-    eeprom_update_byte(EECONFIG_MOUSEKEY_ACCEL, 0);
-    eeprom_update_byte(EECONFIG_BACKLIGHT, 0);
-    eeprom_update_byte(EECONFIG_AUDIO, 0xFF); // On by default
-    eeprom_update_dword(EECONFIG_RGBLIGHT, 0);
-    eeprom_update_byte(EECONFIG_STENOMODE, 0);
-    eeprom_update_dword(EECONFIG_HAPTIC, 0);
-    eeprom_update_byte(EECONFIG_VELOCIKEY, 0);
-    eeprom_update_dword(EECONFIG_RGB_MATRIX, 0);
-    eeprom_update_word(EECONFIG_RGB_MATRIX_EXTENDED, 0);
+    eeconfig_update_u8(EECONFIG_KEYMAP_LOWER_BYTE, 0);
+    eeconfig_update_u8(EECONFIG_KEYMAP_UPPER_BYTE, 0x4);
+    eeconfig_update_u8(EECONFIG_MOUSEKEY_ACCEL, 0);
+    eeconfig_update_u8(EECONFIG_BACKLIGHT, 0);
+    eeconfig_update_u8(EECONFIG_AUDIO, 0xFF); // On by default
+    eeconfig_update_u32(EECONFIG_RGBLIGHT, 0);
+    eeconfig_update_u8(EECONFIG_STENOMODE, 0);
+    eeconfig_update_u32(EECONFIG_HAPTIC, 0);
+    eeconfig_update_u8(EECONFIG_VELOCIKEY, 0);
+    eeconfig_update_u32(EECONFIG_RGB_MATRIX, 0);
+    eeconfig_update_u16(EECONFIG_RGB_MATRIX_EXTENDED, 0);
 
     // TODO: Remove once ARM has a way to configure EECONFIG_HANDEDNESS
     //        within the emulated eeprom via dfu-util or another tool
 #if defined INIT_EE_HANDS_LEFT
 #    pragma message "Faking EE_HANDS for left hand"
-    eeprom_update_byte(EECONFIG_HANDEDNESS, 1);
+    eeconfig_update_u8(EECONFIG_HANDEDNESS, 1);
 #elif defined INIT_EE_HANDS_RIGHT
 #    pragma message "Faking EE_HANDS for right hand"
-    eeprom_update_byte(EECONFIG_HANDEDNESS, 0);
+    eeconfig_update_u8(EECONFIG_HANDEDNESS, 0);
 #endif
 
 #if defined(HAPTIC_ENABLE)
@@ -73,7 +282,7 @@ void eeconfig_init_quantum(void) {
     // this is used in case haptic is disabled, but we still want sane defaults
     // in the haptic configuration eeprom. All zero will trigger a haptic_reset
     // when a haptic-enabled firmware is loaded onto the keyboard.
-    eeprom_update_dword(EECONFIG_HAPTIC, 0);
+    eeconfig_update_u32(EECONFIG_HAPTIC, 0);
 #endif
 #if defined(VIA_ENABLE)
     // Invalidate VIA eeprom config, and then reset.
@@ -84,6 +293,7 @@ void eeconfig_init_quantum(void) {
 #endif
 
     eeconfig_init_kb();
+    eeconfig_transaction_commit();
 }
 
 /** \brief eeconfig initialization
@@ -99,7 +309,7 @@ void eeconfig_init(void) {
  * FIXME: needs doc
  */
 void eeconfig_enable(void) {
-    eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
+    eeconfig_update_u16(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
 }
 
 /** \brief eeconfig disable
@@ -109,8 +319,9 @@ void eeconfig_enable(void) {
 void eeconfig_disable(void) {
 #if defined(EEPROM_DRIVER)
     eeprom_driver_erase();
+    eeconfig_image_invalidate();
 #endif
-    eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER_OFF);
+    eeconfig_update_u16(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER_OFF);
 }
 
 /** \brief eeconfig is enabled
@@ -118,7 +329,7 @@ void eeconfig_disable(void) {
  * FIXME: needs doc
  */
 bool eeconfig_is_enabled(void) {
-    bool is_eeprom_enabled = (eeprom_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER);
+    bool is_eeprom_enabled = (eeconfig_read_u16(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER);
 #ifdef VIA_ENABLE
     if (is_eeprom_enabled) {
         is_eeprom_enabled = via_eeprom_is_valid();
@@ -132,7 +343,7 @@ bool eeconfig_is_enabled(void) {
  * FIXME: needs doc
  */
 bool eeconfig_is_disabled(void) {
-    bool is_eeprom_disabled = (eeprom_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER_OFF);
+    bool is_eeprom_disabled = (eeconfig_read_u16(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER_OFF);
 #ifdef VIA_ENABLE
     if (!is_eeprom_disabled) {
         is_eeprom_disabled = !via_eeprom_is_valid();
@@ -146,14 +357,14 @@ bool eeconfig_is_disabled(void) {
  * FIXME: needs doc
  */
 uint8_t eeconfig_read_debug(void) {
-    return eeprom_read_byte(EECONFIG_DEBUG);
+    return eeconfig_read_u8(EECONFIG_DEBUG);
 }
 /** \brief eeconfig update debug
  *
  * FIXME: needs doc
  */
 void eeconfig_update_debug(uint8_t val) {
-    eeprom_update_byte(EECONFIG_DEBUG, val);
+    eeconfig_update_u8(EECONFIG_DEBUG, val);
 }
 
 /** \brief eeconfig read default layer
@@ -161,14 +372,14 @@ void eeconfig_update_debug(uint8_t val) {
  * FIXME: needs doc
  */
 uint8_t eeconfig_read_default_layer(void) {
-    return eeprom_read_byte(EECONFIG_DEFAULT_LAYER);
+    return eeconfig_read_u8(EECONFIG_DEFAULT_LAYER);
 }
 /** \brief eeconfig update default layer
  *
  * FIXME: needs doc
  */
 void eeconfig_update_default_layer(uint8_t val) {
-    eeprom_update_byte(EECONFIG_DEFAULT_LAYER, val);
+    eeconfig_update_u8(EECONFIG_DEFAULT_LAYER, val);
 }
 
 /** \brief eeconfig read keymap
@@ -176,15 +387,15 @@ void eeconfig_update_default_layer(uint8_t val) {
  * FIXME: needs doc
  */
 uint16_t eeconfig_read_keymap(void) {
-    return (eeprom_read_byte(EECONFIG_KEYMAP_LOWER_BYTE) | (eeprom_read_byte(EECONFIG_KEYMAP_UPPER_BYTE) << 8));
+    return (eeconfig_read_u8(EECONFIG_KEYMAP_LOWER_BYTE) | (eeconfig_read_u8(EECONFIG_KEYMAP_UPPER_BYTE) << 8));
 }
 /** \brief eeconfig update keymap
  *
  * FIXME: needs doc
  */
 void eeconfig_update_keymap(uint16_t val) {
-    eeprom_update_byte(EECONFIG_KEYMAP_LOWER_BYTE, val & 0xFF);
-    eeprom_update_byte(EECONFIG_KEYMAP_UPPER_BYTE, (val >> 8) & 0xFF);
+    eeconfig_update_u8(EECONFIG_KEYMAP_LOWER_BYTE, val & 0xFF);
+    eeconfig_update_u8(EECONFIG_KEYMAP_UPPER_BYTE, (val >> 8) & 0xFF);
 }
 
 /** \brief eeconfig read audio
@@ -192,14 +403,14 @@ void eeconfig_update_keymap(uint16_t val) {
  * FIXME: needs doc
  */
 uint8_t eeconfig_read_audio(void) {
-    return eeprom_read_byte(EECONFIG_AUDIO);
+    return eeconfig_read_u8(EECONFIG_AUDIO);
 }
 /** \brief eeconfig update audio
  *
  * FIXME: needs doc
  */
 void eeconfig_update_audio(uint8_t val) {
-    eeprom_update_byte(EECONFIG_AUDIO, val);
+    eeconfig_update_u8(EECONFIG_AUDIO, val);
 }
 
 /** \brief eeconfig read kb
@@ -207,14 +418,14 @@ void eeconfig_update_audio(uint8_t val) {
  * FIXME: needs doc
  */
 uint32_t eeconfig_read_kb(void) {
-    return eeprom_read_dword(EECONFIG_KEYBOARD);
+    return eeconfig_read_u32(EECONFIG_KEYBOARD);
 }
 /** \brief eeconfig update kb
  *
  * FIXME: needs doc
  */
 void eeconfig_update_kb(uint32_t val) {
-    eeprom_update_dword(EECONFIG_KEYBOARD, val);
+    eeconfig_update_u32(EECONFIG_KEYBOARD, val);
 }
 
 /** \brief eeconfig read user
@@ -222,14 +433,14 @@ void eeconfig_update_kb(uint32_t val) {
  * FIXME: needs doc
  */
 uint32_t eeconfig_read_user(void) {
-    return eeprom_read_dword(EECONFIG_USER);
+    return eeconfig_read_u32(EECONFIG_USER);
 }
 /** \brief eeconfig update user
  *
  * FIXME: needs doc
  */
 void eeconfig_update_user(uint32_t val) {
-    eeprom_update_dword(EECONFIG_USER, val);
+    eeconfig_update_u32(EECONFIG_USER, val);
 }
 
 /** \brief eeconfig read haptic
@@ -237,14 +448,14 @@ void eeconfig_update_user(uint32_t val) {
  * FIXME: needs doc
  */
 uint32_t eeconfig_read_haptic(void) {
-    return eeprom_read_dword(EECONFIG_HAPTIC);
+    return eeconfig_read_u32(EECONFIG_HAPTIC);
 }
 /** \brief eeconfig update haptic
  *
  * FIXME: needs doc
  */
 void eeconfig_update_haptic(uint32_t val) {
-    eeprom_update_dword(EECONFIG_HAPTIC, val);
+    eeconfig_update_u32(EECONFIG_HAPTIC, val);
 }
 
 /** \brief eeconfig read split handedness
@@ -252,12 +463,12 @@ void eeconfig_update_haptic(uint32_t val) {
  * FIXME: needs doc
  */
 bool eeconfig_read_handedness(void) {
-    return !!eeprom_read_byte(EECONFIG_HANDEDNESS);
+    return !!eeconfig_read_u8(EECONFIG_HANDEDNESS);
 }
 /** \brief eeconfig update split handedness
  *
  * FIXME: needs doc
  */
 void eeconfig_update_handedness(bool val) {
-    eeprom_update_byte(EECONFIG_HANDEDNESS, !!val);
+    eeconfig_update_u8(EECONFIG_HANDEDNESS, !!val);
 }
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifndef EECONFIG_MAGIC_NUMBER
 #    define EECONFIG_MAGIC_NUMBER (uint16_t)0xFEE8 // When changing, decrement this value to avoid future re-init issues
@@ -55,6 +56,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define EECONFIG_KEYMAP_UPPER_BYTE (uint8_t *)34
 // Size of EEPROM being used, other code can refer to this for available EEPROM
 #define EECONFIG_SIZE 35
+
+/* EEPROM layout, assigned at build time in this order:
+ *   EECONFIG_* block   0 .. EECONFIG_SIZE
+ *   VIA block          VIA_EEPROM_MAGIC_ADDR .. VIA_EEPROM_CONFIG_END (see via.h)
+ *   Dynamic keymaps    DYNAMIC_KEYMAP_EEPROM_ADDR .. DYNAMIC_KEYMAP_EEPROM_MAX_ADDR (see dynamic_keymap.c)
+ * The EECONFIG_* block, along with VIA's magic and layout options, is kept in
+ * a RAM image that is loaded with a single read and serves all eeconfig reads.
+ */
+
+// Delay before changes made through eeconfig are written to EEPROM, 0 writes immediately
+#ifndef EECONFIG_FLUSH_DELAY_MS
+#    define EECONFIG_FLUSH_DELAY_MS 0
+#endif
 /* debug bit */
 #define EECONFIG_DEBUG_ENABLE (1 << 0)
 #define EECONFIG_DEBUG_MATRIX (1 << 1)
@@ -112,16 +126,26 @@ void     eeconfig_update_haptic(uint32_t val);
 bool eeconfig_read_handedness(void);
 void eeconfig_update_handedness(bool val);
 
+void eeconfig_read_block(void *buf, const void *addr, size_t len);
+void eeconfig_update_block(const void *buf, void *addr, size_t len);
+
+void eeconfig_transaction_begin(void);
+void eeconfig_transaction_commit(void);
+bool eeconfig_in_transaction(void);
+
+void eeconfig_flush(void);
+void eeconfig_task(void);
+
 #define EECONFIG_DEBOUNCE_HELPER(name, offset, config)                  \
     static uint8_t dirty_##name = false;                                \
                                                                         \
     static inline void eeconfig_init_##name(void) {                     \
-        eeprom_read_block(&config, offset, sizeof(config));             \
+        eeconfig_read_block(&config, offset, sizeof(config));           \
         dirty_##name = false;                                           \
     }                                                                   \
     static inline void eeconfig_flush_##name(bool force) {              \
         if (force || dirty_##name) {                                    \
-            eeprom_update_block(&config, offset, sizeof(config));       \
+            eeconfig_update_block(&config, offset, sizeof(config));     \
             dirty_##name = false;                                       \
         }                                                               \
     }                                                                   \
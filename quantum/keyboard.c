@@ -90,6 +90,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef EEPROM_DRIVER
 #    include "eeprom_driver.h"
 #endif
+#ifdef EEPROM_STM32_FLASH_EMULATED
+#    include "eeprom_stm32.h"
+#endif
+#ifdef WEAR_LEVELING_ENABLE
+#    include "wear_leveling.h"
+#endif
 #if defined(CRC_ENABLE)
 #    include "crc.h"
 #endif
@@ -175,9 +181,9 @@ static matrix_row_t   get_real_keys(uint8_t row, matrix_row_t rowdata) {
     matrix_row_t out = 0;
     for (uint8_t col = 0; col < MATRIX_COLS; col++) {
         // read each key in the row data and check if the keymap defines it as a real key
-        if (pgm_read_byte(&keymaps[0][row][col]) && (rowdata & (1 << col))) {
+        if (pgm_read_byte(&keymaps[0][row][col]) && (rowdata & (MATRIX_ROW_SHIFTER << col))) {
             // this creates new row data, if a key is defined in the keymap, it will be set here
-            out |= 1 << col;
+            out |= MATRIX_ROW_SHIFTER << col;
         }
     }
     return out;
@@ -317,8 +323,12 @@ __attribute__((weak)) void housekeeping_task_user(void) {}
  * Invokes hooks for executing code after QMK is done after each loop iteration.
  */
 void housekeeping_task(void) {
+#ifndef NO_HOUSEKEEPING_TASK_KB
     housekeeping_task_kb();
+#endif
+#ifndef NO_HOUSEKEEPING_TASK_USER
     housekeeping_task_user();
+#endif
 }
 
 /** \brief Init tasks previously located in matrix_init_quantum
@@ -484,8 +494,9 @@ static bool matrix_task(void) {
             continue;
         }
 
+        // stop once no changes are left in the columns above, as wide rows are mostly idle
         matrix_row_t col_mask = 1;
-        for (uint8_t col = 0; col < MATRIX_COLS; col++, col_mask <<= 1) {
+        for (uint8_t col = 0; col < MATRIX_COLS && row_changes >= col_mask; col++, col_mask <<= 1) {
             if (row_changes & col_mask) {
                 const bool key_pressed = current_row & col_mask;
 
@@ -670,5 +681,25 @@ void keyboard_task(void) {
     programmable_button_send();
 #endif
 
+#ifdef VIA_STREAM_ENABLE
+    via_task();
+#endif
+
+#if EECONFIG_FLUSH_DELAY_MS > 0
+    eeconfig_task();
+#endif
+
+#ifdef WEAR_LEVELING_ENABLE
+    wear_leveling_task();
+#endif
+
+#ifdef EEPROM_STM32_FLASH_EMULATED
+    EEPROM_Task();
+#endif
+
+#ifdef EEPROM_I2C
+    eeprom_i2c_task();
+#endif
+
     led_task();
 }
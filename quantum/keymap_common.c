@@ -43,10 +43,17 @@ action_t action_for_key(uint8_t layer, keypos_t key) {
 };
 
 action_t action_for_keycode(uint16_t keycode) {
+    action_t action = {};
+
+    // plain keys and modifiers are their own action, and remap to plain keys only
+    if (IS_KEY(keycode) || IS_MOD(keycode)) {
+        action.code = ACTION_KEY(keycode_config(keycode));
+        return action;
+    }
+
     // keycode remapping
     keycode = keycode_config(keycode);
 
-    action_t action = {};
     uint8_t  action_layer, mod;
 
     (void)action_layer;
@@ -147,7 +154,11 @@ action_t action_for_keycode(uint16_t keycode) {
 // translates key to keycode
 __attribute__((weak)) uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
     if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+#ifdef SPARSE_KEYMAP_ENABLE
+        return keycode_at_keymap_location(layer, key.row, key.col);
+#else
         return pgm_read_word(&keymaps[layer][key.row][key.col]);
+#endif
     }
 #ifdef ENCODER_MAP_ENABLE
     else if (key.row == KEYLOC_ENCODER_CW && key.col < NUM_ENCODERS) {
@@ -11,13 +11,62 @@
 
 #include "keymap_introspection.h"
 
-#define NUM_KEYMAP_LAYERS ((uint8_t)(sizeof(keymaps) / ((MATRIX_ROWS) * (MATRIX_COLS) * sizeof(uint16_t))))
+#define NUM_DENSE_KEYMAP_LAYERS ((uint8_t)(sizeof(keymaps) / ((MATRIX_ROWS) * (MATRIX_COLS) * sizeof(uint16_t))))
+
+#ifdef SPARSE_KEYMAP_ENABLE
+
+#    define NUM_SPARSE_KEYMAP_LAYERS ((uint8_t)(sizeof(keymap_sparse_offsets) / ((MATRIX_ROWS) * sizeof(uint16_t))))
+#    define NUM_KEYMAP_LAYERS ((uint8_t)(NUM_DENSE_KEYMAP_LAYERS + NUM_SPARSE_KEYMAP_LAYERS))
+
+_Static_assert(sizeof(keymap_sparse_masks) == NUM_SPARSE_KEYMAP_LAYERS * (MATRIX_ROWS) * sizeof(matrix_row_t), "Number of sparse keymap masks doesn't match the number of sparse keymap layers");
+
+static inline matrix_row_t sparse_mask_read(uint8_t sparse_layer, uint8_t row) {
+#    if (MATRIX_COLS <= 8)
+    return pgm_read_byte(&keymap_sparse_masks[sparse_layer][row]);
+#    elif (MATRIX_COLS <= 16)
+    return pgm_read_word(&keymap_sparse_masks[sparse_layer][row]);
+#    elif (MATRIX_COLS <= 32)
+    return pgm_read_dword(&keymap_sparse_masks[sparse_layer][row]);
+#    else
+    const uint32_t *words = (const uint32_t *)&keymap_sparse_masks[sparse_layer][row];
+    return pgm_read_dword(&words[0]) | (matrix_row_t)pgm_read_dword(&words[1]) << 32;
+#    endif
+}
+
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    if (layer_num < NUM_DENSE_KEYMAP_LAYERS) {
+        return pgm_read_word(&keymaps[layer_num][row][column]);
+    }
+    if (layer_num >= NUM_KEYMAP_LAYERS) {
+        return KC_TRANSPARENT;
+    }
+
+    // a clear bit is a transparent key, otherwise count the keys stored before it in the row
+    uint8_t      sparse_layer = layer_num - NUM_DENSE_KEYMAP_LAYERS;
+    matrix_row_t mask         = sparse_mask_read(sparse_layer, row);
+    matrix_row_t bit          = MATRIX_ROW_SHIFTER << column;
+    if (!(mask & bit)) {
+        return KC_TRANSPARENT;
+    }
+    uint16_t index = pgm_read_word(&keymap_sparse_offsets[sparse_layer][row]) + __builtin_popcountll(mask & (bit - 1));
+    return pgm_read_word(&keymap_sparse_keycodes[index]);
+}
+
+#else
+
+#    define NUM_KEYMAP_LAYERS NUM_DENSE_KEYMAP_LAYERS
+
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    return pgm_read_word(&keymaps[layer_num][row][column]);
+}
+
+#endif // SPARSE_KEYMAP_ENABLE
 
 uint8_t keymap_layer_count(void) {
     return NUM_KEYMAP_LAYERS;
 }
 
-_Static_assert(NUM_KEYMAP_LAYERS <= MAX_LAYER, "Number of keymap layers exceeds maximum set by LAYER_STATE_(8|16|32)BIT");
+_Static_assert(NUM_KEYMAP_LAYERS <= MAX_LAYER, "Number of keymap layers exceeds maximum set by LAYER_STATE_(8|16|32|64)BIT");
 
 #if defined(ENCODER_ENABLE) && defined(ENCODER_MAP_ENABLE)
 
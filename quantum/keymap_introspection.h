@@ -7,6 +7,9 @@
 // Get the number of layers defined in the keymap
 uint8_t keymap_layer_count(void);
 
+// Get the keycode the static keymap has at a matrix location, either dense or sparse
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column);
+
 #if defined(ENCODER_ENABLE) && defined(ENCODER_MAP_ENABLE)
 
 // Get the number of layers defined in the encoder map
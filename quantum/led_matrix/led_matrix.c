@@ -385,8 +385,12 @@ void led_matrix_task(void) {
 }
 
 void led_matrix_indicators(void) {
+#ifndef NO_LED_MATRIX_INDICATORS_KB
     led_matrix_indicators_kb();
+#endif
+#ifndef NO_LED_MATRIX_INDICATORS_USER
     led_matrix_indicators_user();
+#endif
 }
 
 __attribute__((weak)) void led_matrix_indicators_kb(void) {}
@@ -394,21 +398,27 @@ __attribute__((weak)) void led_matrix_indicators_kb(void) {}
 __attribute__((weak)) void led_matrix_indicators_user(void) {}
 
 void led_matrix_indicators_advanced(effect_params_t *params) {
+#if !defined(NO_LED_MATRIX_INDICATORS_ADVANCED_KB) || !defined(NO_LED_MATRIX_INDICATORS_ADVANCED_USER)
     /* special handling is needed for "params->iter", since it's already been incremented.
      * Could move the invocations to led_task_render, but then it's missing a few checks
      * and not sure which would be better. Otherwise, this should be called from
      * led_task_render, right before the iter++ line.
      */
-#if defined(LED_MATRIX_LED_PROCESS_LIMIT) && LED_MATRIX_LED_PROCESS_LIMIT > 0 && LED_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#    if defined(LED_MATRIX_LED_PROCESS_LIMIT) && LED_MATRIX_LED_PROCESS_LIMIT > 0 && LED_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
     uint8_t min = LED_MATRIX_LED_PROCESS_LIMIT * (params->iter - 1);
     uint8_t max = min + LED_MATRIX_LED_PROCESS_LIMIT;
     if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
-#else
+#    else
     uint8_t min = 0;
     uint8_t max = DRIVER_LED_TOTAL;
-#endif
+#    endif
+#    ifndef NO_LED_MATRIX_INDICATORS_ADVANCED_KB
     led_matrix_indicators_advanced_kb(min, max);
+#    endif
+#    ifndef NO_LED_MATRIX_INDICATORS_ADVANCED_USER
     led_matrix_indicators_advanced_user(min, max);
+#    endif
+#endif
 }
 
 __attribute__((weak)) void led_matrix_indicators_advanced_kb(uint8_t led_min, uint8_t led_max) {}
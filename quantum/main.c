@@ -63,6 +63,11 @@ int main(void) {
         // Run Quantum Painter animations
         void qp_internal_animation_tick(void);
         qp_internal_animation_tick();
+#    ifdef QUANTUM_PAINTER_QUEUE_ENABLE
+        // Render queued Quantum Painter commands, within the configured time budget
+        void qp_internal_queue_tick(void);
+        qp_internal_queue_tick();
+#    endif // QUANTUM_PAINTER_QUEUE_ENABLE
 #endif
 
 #ifdef DEFERRED_EXEC_ENABLE
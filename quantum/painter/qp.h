@@ -48,6 +48,39 @@
 #    define QUANTUM_PAINTER_CONCURRENT_ANIMATIONS 4
 #endif // QUANTUM_PAINTER_CONCURRENT_ANIMATIONS
 
+#ifndef QUANTUM_PAINTER_QUEUE_SIZE
+/**
+ * @def This controls the maximum number of drawing commands that can be queued for asynchronous rendering using the
+ *      \ref qp_queue_rect family of APIs. Only relevant if `QUANTUM_PAINTER_QUEUE_ENABLE = yes` is set in rules.mk.
+ */
+#    define QUANTUM_PAINTER_QUEUE_SIZE 16
+#endif // QUANTUM_PAINTER_QUEUE_SIZE
+
+#ifndef QUANTUM_PAINTER_QUEUE_TEXT_LENGTH
+/**
+ * @def This controls the maximum length (in bytes, including the NUL terminator) of strings queued for asynchronous
+ *      rendering using \ref qp_queue_drawtext. Queued strings are copied, so increasing this increases RAM usage for
+ *      every queue slot.
+ */
+#    define QUANTUM_PAINTER_QUEUE_TEXT_LENGTH 32
+#endif // QUANTUM_PAINTER_QUEUE_TEXT_LENGTH
+
+#ifndef QUANTUM_PAINTER_QUEUE_TIME_BUDGET_MS
+/**
+ * @def This controls the number of milliseconds per main loop iteration which may be spent rendering queued drawing
+ *      commands. At least one unit of work is always performed, even if it exceeds the budget.
+ */
+#    define QUANTUM_PAINTER_QUEUE_TIME_BUDGET_MS 2
+#endif // QUANTUM_PAINTER_QUEUE_TIME_BUDGET_MS
+
+#ifndef QUANTUM_PAINTER_QUEUE_CHUNK_PIXELS
+/**
+ * @def This controls the approximate number of pixels rendered in one unit of work while rendering queued fills and
+ *      images. Smaller values reduce the worst-case latency added to the main loop, at the cost of more overhead.
+ */
+#    define QUANTUM_PAINTER_QUEUE_CHUNK_PIXELS 1024
+#endif // QUANTUM_PAINTER_QUEUE_CHUNK_PIXELS
+
 #ifndef QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE
 /**
  * @def This controls the maximum size of the pixel data buffer used for single blocks of transmission. Larger buffers
@@ -56,6 +89,15 @@
 #    define QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE 32
 #endif
 
+#ifndef QUANTUM_PAINTER_PALETTE_CACHE_SIZE
+/**
+ * @def This controls the number of converted native palettes which are cached for use with recolored images and fonts.
+ *      Redrawing text or images with the same foreground/background colors reuses the cached palette instead of
+ *      interpolating and converting it again. Each entry requires roughly 80 bytes of RAM; set to 0 to disable.
+ */
+#    define QUANTUM_PAINTER_PALETTE_CACHE_SIZE 4
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE
+
 #ifndef QUANTUM_PAINTER_SUPPORTS_256_PALETTE
 /**
  * @def This controls whether 256-color palettes are supported. This has relatively hefty requirements on RAM -- at
@@ -429,6 +471,119 @@ int16_t qp_drawtext(painter_device_t device, uint16_t x, uint16_t y, painter_fon
  */
 int16_t qp_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, painter_font_handle_t font, const char *str, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg);
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter Queued Rendering API
+
+#ifdef QUANTUM_PAINTER_QUEUE_ENABLE
+
+/**
+ * Queues a pixel to be set to the specified color. See \ref qp_setpixel.
+ *
+ * @note Queued commands are executed in order, a small amount at a time, from the main loop. Any image or font handles
+ *       supplied to the queued rendering APIs need to remain valid until the queue has drained.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, or the device is invalid
+ */
+bool qp_queue_setpixel(painter_device_t device, uint16_t x, uint16_t y, uint8_t hue, uint8_t sat, uint8_t val);
+
+/**
+ * Queues a line to be drawn using the specified color. See \ref qp_line.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, or the device is invalid
+ */
+bool qp_queue_line(painter_device_t device, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t hue, uint8_t sat, uint8_t val);
+
+/**
+ * Queues a rectangle to be drawn using the specified color, optionally filled. See \ref qp_rect.
+ *
+ * @note Filled rectangles are rendered in bands of rows, spread across multiple main loop iterations.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, or the device is invalid
+ */
+bool qp_queue_rect(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom, uint8_t hue, uint8_t sat, uint8_t val, bool filled);
+
+/**
+ * Queues a circle to be drawn using the specified color, optionally filled. See \ref qp_circle.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, or the device is invalid
+ */
+bool qp_queue_circle(painter_device_t device, uint16_t x, uint16_t y, uint16_t radius, uint8_t hue, uint8_t sat, uint8_t val, bool filled);
+
+/**
+ * Queues an ellipse to be drawn using the specified color, optionally filled. See \ref qp_ellipse.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, or the device is invalid
+ */
+bool qp_queue_ellipse(painter_device_t device, uint16_t x, uint16_t y, uint16_t sizex, uint16_t sizey, uint8_t hue, uint8_t sat, uint8_t val, bool filled);
+
+/**
+ * Queues an image to be drawn. See \ref qp_drawimage.
+ *
+ * @note Images are rendered in bands of rows, spread across multiple main loop iterations. Only the first frame of
+ *       animations is drawn.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, or the device is invalid
+ */
+bool qp_queue_drawimage(painter_device_t device, uint16_t x, uint16_t y, painter_image_handle_t image);
+
+/**
+ * Queues an image to be drawn, recoloring monochrome images to the desired foreground/background. See
+ * \ref qp_drawimage_recolor.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, or the device is invalid
+ */
+bool qp_queue_drawimage_recolor(painter_device_t device, uint16_t x, uint16_t y, painter_image_handle_t image, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg);
+
+/**
+ * Queues text to be drawn. See \ref qp_drawtext.
+ *
+ * @note The string is copied, and is rendered one glyph at a time. Strings of \ref QUANTUM_PAINTER_QUEUE_TEXT_LENGTH
+ *       bytes or longer are rejected.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, the string was too long, or the device is invalid
+ */
+bool qp_queue_drawtext(painter_device_t device, uint16_t x, uint16_t y, painter_font_handle_t font, const char *str);
+
+/**
+ * Queues text to be drawn, recoloring monochrome fonts to the desired foreground/background. See
+ * \ref qp_drawtext_recolor.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, the string was too long, or the device is invalid
+ */
+bool qp_queue_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, painter_font_handle_t font, const char *str, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg);
+
+/**
+ * Queues a flush of the device, once all previously-queued commands have been rendered. See \ref qp_flush.
+ *
+ * @return true if the command was queued
+ * @return false if the queue was full, or the device is invalid
+ */
+bool qp_queue_flush(painter_device_t device);
+
+/**
+ * Checks whether all queued commands have been rendered.
+ *
+ * @return true if the queue is empty
+ * @return false if there are commands still pending
+ */
+bool qp_queue_drained(void);
+
+/**
+ * Synchronously renders all outstanding queued commands, such as before entering suspend.
+ */
+void qp_queue_drain(void);
+
+#endif // QUANTUM_PAINTER_QUEUE_ENABLE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter Drivers
 
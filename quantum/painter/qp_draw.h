@@ -27,6 +27,29 @@ bool qp_internal_setpixel_impl(painter_device_t device, uint16_t x, uint16_t y);
 // qp_rect internal implementation, but uses the global pixdata buffer with pre-converted native pixels.
 bool qp_internal_fillrect_helper_impl(painter_device_t device, uint16_t l, uint16_t t, uint16_t r, uint16_t b);
 
+// Batches horizontal runs of pixels into rectangles so that they are transmitted together: runs on the same row are
+// joined when adjacent or overlapping, and runs of the same extent on adjacent rows are stacked, which also turns
+// vertical runs of single pixels into one transfer. Uses the global pixdata buffer with pre-converted native pixels --
+// the buffer should be completely filled beforehand.
+#define QP_SPAN_BATCH_SLOTS 8
+
+struct qp_internal_span {
+    int16_t l;
+    int16_t t;
+    int16_t r;
+    int16_t b;
+};
+
+struct qp_internal_span_batch {
+    painter_device_t        device;
+    uint8_t                 count;
+    struct qp_internal_span spans[QP_SPAN_BATCH_SLOTS];
+};
+
+void qp_internal_span_batch_init(struct qp_internal_span_batch* batch, painter_device_t device);
+bool qp_internal_span_batch_add(struct qp_internal_span_batch* batch, int16_t x0, int16_t x1, int16_t y);
+bool qp_internal_span_batch_flush(struct qp_internal_span_batch* batch);
+
 // Convert from input pixel data + palette to equivalent pixels
 typedef int16_t (*qp_internal_byte_input_callback)(void* cb_arg);
 typedef bool (*qp_internal_pixel_output_callback)(qp_pixel_t* palette, uint8_t index, void* cb_arg);
@@ -46,6 +69,11 @@ extern qp_pixel_t qp_internal_global_pixel_lookup_table[16];
 // As this uses a global, this may present a problem if using the same parameters but a different screen converts pixels -- use qp_internal_invalidate_palette() below to reset.
 bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps);
 
+// Generates a color-interpolated lookup table as per qp_internal_interpolate_palette(), then converts it to the device's native pixel format.
+// Converted palettes are kept in a small cache keyed by fg/bg color, number of entries, and device, so repeated renders with the same colors skip both steps.
+// Returns false if the palette could not be converted.
+bool qp_internal_interpolate_native_palette(painter_device_t device, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps);
+
 // Resets the global palette so that it can be regenerated. Only needed if the colors are identical, but a different display is used with a different internal pixel format.
 void qp_internal_invalidate_palette(void);
 
@@ -83,3 +111,53 @@ struct qp_internal_pixel_output_state {
 bool qp_internal_pixel_appender(qp_pixel_t* palette, uint8_t index, void* cb_arg);
 
 qp_internal_byte_input_callback qp_internal_prepare_input_state(struct qp_internal_byte_input_state* input_state, painter_compression_t compression);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter incremental shape rendering, used by the command queue
+
+// Progress through the midpoint circle algorithm. Zero-initialise before the first call.
+struct qp_internal_circle_state {
+    bool    started;
+    int16_t xcalc;
+    int16_t ycalc;
+    int16_t err;
+};
+
+// Draws up to max_steps further steps of the circle, each up to eight pixels or four fill lines. Sets done to true once the circle is complete.
+bool qp_internal_circle_incremental(struct qp_internal_circle_state* state, painter_device_t device, uint16_t x, uint16_t y, uint16_t radius, uint8_t hue, uint8_t sat, uint8_t val, bool filled, uint32_t max_steps, bool* done);
+
+// Progress through the midpoint ellipse algorithm. Zero-initialise before the first call.
+struct qp_internal_ellipse_state {
+    uint8_t phase; // 0 = not started, 1 = steep half, 2 = shallow half, 3 = complete
+    int16_t dx;
+    int16_t dy;
+    int16_t delta;
+};
+
+// Draws up to max_steps further steps of the ellipse, each up to four pixels or two fill lines. Sets done to true once the ellipse is complete.
+bool qp_internal_ellipse_incremental(struct qp_internal_ellipse_state* state, painter_device_t device, uint16_t x, uint16_t y, uint16_t sizex, uint16_t sizey, uint8_t hue, uint8_t sat, uint8_t val, bool filled, uint32_t max_steps, bool* done);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter incremental image rendering, used by the command queue
+
+struct qp_internal_image_render_state {
+    painter_device_t                    device;
+    painter_image_handle_t              image;
+    qp_pixel_t                          fg_hsv888;
+    qp_pixel_t                          bg_hsv888;
+    uint16_t                            left;
+    uint16_t                            top;
+    uint16_t                            right;
+    uint16_t                            bottom;
+    uint16_t                            next_row;
+    uint8_t                             bpp;
+    int32_t                             stream_pos;
+    qp_internal_byte_input_callback     input_callback;
+    struct qp_internal_byte_input_state input_state;
+};
+
+// Prepares the supplied state for rendering the first frame of an image over multiple calls to qp_internal_drawimage_incremental_continue().
+bool qp_internal_drawimage_incremental_begin(struct qp_internal_image_render_state* state, painter_device_t device, uint16_t x, uint16_t y, painter_image_handle_t image, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888);
+
+// Renders the next set of whole rows of the image, approximately max_pixels in size. Sets done to true once the last row has been rendered.
+bool qp_internal_drawimage_incremental_continue(struct qp_internal_image_render_state* state, uint32_t max_pixels, bool* done);
@@ -8,7 +8,7 @@
 #include "qp_draw.h"
 
 // Utilize 8-way symmetry to draw circles
-static bool qp_circle_helper_impl(painter_device_t device, uint16_t centerx, uint16_t centery, uint16_t offsetx, uint16_t offsety, bool filled) {
+static bool qp_circle_helper_impl(struct qp_internal_span_batch *batch, uint16_t centerx, uint16_t centery, uint16_t offsetx, uint16_t offsety, bool filled) {
     /*
     Circles have the property of 8-way symmetry, so eight pixels can be drawn
     for each computed [offsetx,offsety] given the center coordinates
@@ -17,6 +17,11 @@ static bool qp_circle_helper_impl(painter_device_t device, uint16_t centerx, uin
     For filled circles, we can draw horizontal lines between each pair of
     pixels with the same final value of y.
 
+    Everything is submitted as horizontal spans to the span batcher, which
+    merges adjacent pixels and repeated fill lines on the same row into the
+    longest possible runs, and stacks runs of the same extent on adjacent
+    rows, before transmitting them to the display.
+
     Two special cases exist and have been optimized:
     1) offsetx == offsety (the final point), makes half the coordinates
     equivalent, so we can omit them (and the corresponding fill lines)
@@ -36,84 +41,84 @@ static bool qp_circle_helper_impl(painter_device_t device, uint16_t centerx, uin
     int16_t ymy = ((int16_t)centery) - ((int16_t)offsety);
 
     if (offsetx == 0) {
-        if (!qp_internal_setpixel_impl(device, centerx, ypy)) {
+        if (!qp_internal_span_batch_add(batch, centerx, centerx, ypy)) {
             return false;
         }
-        if (!qp_internal_setpixel_impl(device, centerx, ymy)) {
+        if (!qp_internal_span_batch_add(batch, centerx, centerx, ymy)) {
             return false;
         }
         if (filled) {
-            if (!qp_internal_fillrect_helper_impl(device, xpy, centery, xmy, centery)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xmy, centery)) {
                 return false;
             }
         } else {
-            if (!qp_internal_setpixel_impl(device, xpy, centery)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xpy, centery)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xmy, centery)) {
+            if (!qp_internal_span_batch_add(batch, xmy, xmy, centery)) {
                 return false;
             }
         }
     } else if (offsetx == offsety) {
         if (filled) {
-            if (!qp_internal_fillrect_helper_impl(device, xpy, ypy, xmy, ypy)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xmy, ypy)) {
                 return false;
             }
-            if (!qp_internal_fillrect_helper_impl(device, xpy, ymy, xmy, ymy)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xmy, ymy)) {
                 return false;
             }
         } else {
-            if (!qp_internal_setpixel_impl(device, xpy, ypy)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xpy, ypy)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xmy, ypy)) {
+            if (!qp_internal_span_batch_add(batch, xmy, xmy, ypy)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xpy, ymy)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xpy, ymy)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xmy, ymy)) {
+            if (!qp_internal_span_batch_add(batch, xmy, xmy, ymy)) {
                 return false;
             }
         }
 
     } else {
         if (filled) {
-            if (!qp_internal_fillrect_helper_impl(device, xpx, ypy, xmx, ypy)) {
+            if (!qp_internal_span_batch_add(batch, xpx, xmx, ypy)) {
                 return false;
             }
-            if (!qp_internal_fillrect_helper_impl(device, xpx, ymy, xmx, ymy)) {
+            if (!qp_internal_span_batch_add(batch, xpx, xmx, ymy)) {
                 return false;
             }
-            if (!qp_internal_fillrect_helper_impl(device, xpy, ypx, xmy, ypx)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xmy, ypx)) {
                 return false;
             }
-            if (!qp_internal_fillrect_helper_impl(device, xpy, ymx, xmy, ymx)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xmy, ymx)) {
                 return false;
             }
         } else {
-            if (!qp_internal_setpixel_impl(device, xpx, ypy)) {
+            if (!qp_internal_span_batch_add(batch, xpx, xpx, ypy)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xmx, ypy)) {
+            if (!qp_internal_span_batch_add(batch, xmx, xmx, ypy)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xpx, ymy)) {
+            if (!qp_internal_span_batch_add(batch, xpx, xpx, ymy)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xmx, ymy)) {
+            if (!qp_internal_span_batch_add(batch, xmx, xmx, ymy)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xpy, ypx)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xpy, ypx)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xmy, ypx)) {
+            if (!qp_internal_span_batch_add(batch, xmy, xmy, ypx)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xpy, ymx)) {
+            if (!qp_internal_span_batch_add(batch, xpy, xpy, ymx)) {
                 return false;
             }
-            if (!qp_internal_setpixel_impl(device, xmy, ymx)) {
+            if (!qp_internal_span_batch_add(batch, xmy, xmy, ymx)) {
                 return false;
             }
         }
@@ -123,50 +128,65 @@ static bool qp_circle_helper_impl(painter_device_t device, uint16_t centerx, uin
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Quantum Painter External API: qp_circle
+// Quantum Painter Core API: qp_internal_circle_incremental
 
-bool qp_circle(painter_device_t device, uint16_t x, uint16_t y, uint16_t radius, uint8_t hue, uint8_t sat, uint8_t val, bool filled) {
-    qp_dprintf("qp_circle: entry\n");
+bool qp_internal_circle_incremental(struct qp_internal_circle_state *state, painter_device_t device, uint16_t x, uint16_t y, uint16_t radius, uint8_t hue, uint8_t sat, uint8_t val, bool filled, uint32_t max_steps, bool *done) {
     struct painter_driver_t *driver = (struct painter_driver_t *)device;
     if (!driver->validate_ok) {
         qp_dprintf("qp_circle: fail (validation_ok == false)\n");
         return false;
     }
 
-    // plot the initial set of points for x, y and r
-    int16_t xcalc = 0;
-    int16_t ycalc = (int16_t)radius;
-    int16_t err   = ((5 - (radius >> 2)) >> 2);
-
-    qp_internal_fill_pixdata(device, (radius * 2) + 1, hue, sat, val);
+    // Fill up the pixdata buffer so that horizontal runs can be transmitted together
+    qp_internal_fill_pixdata(device, qp_internal_num_pixels_in_buffer(device), hue, sat, val);
 
     if (!qp_comms_start(device)) {
         qp_dprintf("qp_circle: fail (could not start comms)\n");
         return false;
     }
 
+    struct qp_internal_span_batch batch;
+    qp_internal_span_batch_init(&batch, device);
+
     bool ret = true;
-    if (!qp_circle_helper_impl(device, x, y, xcalc, ycalc, filled)) {
-        ret = false;
+    if (!state->started) {
+        // plot the initial set of points for x, y and r
+        state->started = true;
+        state->xcalc   = 0;
+        state->ycalc   = (int16_t)radius;
+        state->err     = ((5 - (radius >> 2)) >> 2);
+        ret            = qp_circle_helper_impl(&batch, x, y, state->xcalc, state->ycalc, filled);
     }
 
-    if (ret) {
-        while (xcalc < ycalc) {
-            xcalc++;
-            if (err < 0) {
-                err += (xcalc << 1) + 1;
-            } else {
-                ycalc--;
-                err += ((xcalc - ycalc) << 1) + 1;
-            }
-            if (!qp_circle_helper_impl(device, x, y, xcalc, ycalc, filled)) {
-                ret = false;
-                break;
-            }
+    for (uint32_t step = 0; ret && step < max_steps && state->xcalc < state->ycalc; ++step) {
+        state->xcalc++;
+        if (state->err < 0) {
+            state->err += (state->xcalc << 1) + 1;
+        } else {
+            state->ycalc--;
+            state->err += ((state->xcalc - state->ycalc) << 1) + 1;
         }
+        ret = qp_circle_helper_impl(&batch, x, y, state->xcalc, state->ycalc, filled);
+    }
+    *done = state->xcalc >= state->ycalc;
+
+    // Transmit anything outstanding
+    if (ret && !qp_internal_span_batch_flush(&batch)) {
+        ret = false;
     }
 
-    qp_dprintf("qp_circle: %s\n", ret ? "ok" : "fail");
     qp_comms_stop(device);
     return ret;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_circle
+
+bool qp_circle(painter_device_t device, uint16_t x, uint16_t y, uint16_t radius, uint8_t hue, uint8_t sat, uint8_t val, bool filled) {
+    qp_dprintf("qp_circle: entry\n");
+    struct qp_internal_circle_state state = {0};
+    bool                            done  = false;
+    bool                            ret   = qp_internal_circle_incremental(&state, device, x, y, radius, hue, sat, val, filled, UINT32_MAX, &done);
+    qp_dprintf("qp_circle: %s\n", ret ? "ok" : "fail");
+    return ret;
+}
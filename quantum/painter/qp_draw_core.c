@@ -33,6 +33,26 @@ __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table
 __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table[16];
 #endif
 
+// The device whose native format the global lookup table was last converted to, if it holds an interpolated palette
+static painter_device_t native_palette_device = NULL;
+
+// Cache of previously-converted native palettes, keyed by fg/bg color, number of entries, and device
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+typedef struct qp_internal_palette_cache_entry_t {
+    painter_device_t device;
+    qp_pixel_t       fg_hsv888;
+    qp_pixel_t       bg_hsv888;
+    int16_t          steps;
+    uint16_t         last_used;
+    qp_pixel_t       native[16];
+} qp_internal_palette_cache_entry_t;
+
+__attribute__((__aligned__(4))) static qp_internal_palette_cache_entry_t palette_cache[QUANTUM_PAINTER_PALETTE_CACHE_SIZE];
+static uint16_t                                                          palette_cache_counter = 0;
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+static uint32_t palette_cache_hits   = 0;
+static uint32_t palette_cache_misses = 0;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Helpers
 
@@ -66,8 +86,74 @@ void qp_internal_fill_pixdata(painter_device_t device, uint32_t num_pixels, uint
 
 // Resets the global palette so that it can be regenerated. Only needed if the colors are identical, but a different display is used with a different internal pixel format.
 void qp_internal_invalidate_palette(void) {
-    generated_palette = false;
-    generated_steps   = -1;
+    generated_palette     = false;
+    generated_steps       = -1;
+    native_palette_device = NULL;
+}
+
+static inline bool qp_internal_palette_params_match(qp_pixel_t a_fg_hsv888, qp_pixel_t a_bg_hsv888, qp_pixel_t b_fg_hsv888, qp_pixel_t b_bg_hsv888) {
+    return memcmp(&a_fg_hsv888.hsv888, &b_fg_hsv888.hsv888, sizeof(a_fg_hsv888.hsv888)) == 0 && memcmp(&a_bg_hsv888.hsv888, &b_bg_hsv888.hsv888, sizeof(a_bg_hsv888.hsv888)) == 0;
+}
+
+// Interpolates between two colors and converts the result to the device's native pixel format, reusing previously-converted palettes where possible
+bool qp_internal_interpolate_native_palette(painter_device_t device, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, int16_t steps) {
+    struct painter_driver_t *driver = (struct painter_driver_t *)device;
+
+    // If the global lookup table already contains this exact palette for this device, there's nothing to do.
+    if (native_palette_device == device && generated_palette == true && generated_steps == steps && qp_internal_palette_params_match(interpolated_fg_hsv888, interpolated_bg_hsv888, fg_hsv888, bg_hsv888)) {
+        ++palette_cache_hits;
+        qp_dprintf("qp_internal_interpolate_native_palette: hit (current) -- hits: %lu, misses: %lu\n", (unsigned long)palette_cache_hits, (unsigned long)palette_cache_misses);
+        return true;
+    }
+
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    // Look for a matching entry in the cache, keeping track of the least-recently-used slot in case we need to replace it
+    qp_internal_palette_cache_entry_t *victim = &palette_cache[0];
+    for (int i = 0; i < QUANTUM_PAINTER_PALETTE_CACHE_SIZE; ++i) {
+        qp_internal_palette_cache_entry_t *entry = &palette_cache[i];
+        if (entry->device == device && entry->steps == steps && qp_internal_palette_params_match(entry->fg_hsv888, entry->bg_hsv888, fg_hsv888, bg_hsv888)) {
+            entry->last_used = ++palette_cache_counter;
+            memcpy(qp_internal_global_pixel_lookup_table, entry->native, steps * sizeof(qp_pixel_t));
+            generated_palette      = true;
+            generated_steps        = steps;
+            interpolated_fg_hsv888 = fg_hsv888;
+            interpolated_bg_hsv888 = bg_hsv888;
+            native_palette_device  = device;
+            ++palette_cache_hits;
+            qp_dprintf("qp_internal_interpolate_native_palette: hit (slot %d) -- hits: %lu, misses: %lu\n", i, (unsigned long)palette_cache_hits, (unsigned long)palette_cache_misses);
+            return true;
+        }
+        if (victim->device != NULL && (entry->device == NULL || (uint16_t)(palette_cache_counter - entry->last_used) > (uint16_t)(palette_cache_counter - victim->last_used))) {
+            victim = entry;
+        }
+    }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
+    ++palette_cache_misses;
+    qp_dprintf("qp_internal_interpolate_native_palette: miss -- hits: %lu, misses: %lu\n", (unsigned long)palette_cache_hits, (unsigned long)palette_cache_misses);
+
+    // Regenerate the palette from scratch, then convert it to the native format
+    qp_internal_invalidate_palette();
+    qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, steps);
+    if (!driver->driver_vtable->palette_convert(device, steps, qp_internal_global_pixel_lookup_table)) {
+        qp_internal_invalidate_palette();
+        return false;
+    }
+    native_palette_device = device;
+
+#if QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+    // Only palettes up to 4bpp are cached, 256-color palettes are too large to keep multiple copies around
+    if (steps <= (int16_t)(sizeof(victim->native) / sizeof(victim->native[0]))) {
+        victim->device    = device;
+        victim->fg_hsv888 = fg_hsv888;
+        victim->bg_hsv888 = bg_hsv888;
+        victim->steps     = steps;
+        victim->last_used = ++palette_cache_counter;
+        memcpy(victim->native, qp_internal_global_pixel_lookup_table, steps * sizeof(qp_pixel_t));
+    }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE_SIZE > 0
+
+    return true;
 }
 
 // Interpolates between two colors to generate a palette
@@ -140,6 +226,60 @@ bool qp_internal_load_qgf_palette(qp_stream_t *stream, uint8_t bpp) {
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Span batching
+
+void qp_internal_span_batch_init(struct qp_internal_span_batch *batch, painter_device_t device) {
+    batch->device = device;
+    batch->count  = 0;
+}
+
+static bool qp_internal_span_batch_emit(struct qp_internal_span_batch *batch, uint8_t idx) {
+    return qp_internal_fillrect_helper_impl(batch->device, batch->spans[idx].l, batch->spans[idx].t, batch->spans[idx].r, batch->spans[idx].b);
+}
+
+bool qp_internal_span_batch_add(struct qp_internal_span_batch *batch, int16_t x0, int16_t x1, int16_t y) {
+    int16_t l = QP_MIN(x0, x1);
+    int16_t r = QP_MAX(x0, x1);
+
+    for (uint8_t i = 0; i < batch->count; ++i) {
+        struct qp_internal_span *span = &batch->spans[i];
+        // Merge with a pending single row span on the same row that overlaps or is directly adjacent
+        if (span->t == y && span->b == y && l <= span->r + 1 && r >= span->l - 1) {
+            span->l = QP_MIN(span->l, l);
+            span->r = QP_MAX(span->r, r);
+            return true;
+        }
+        // Stack onto a pending span of the same extent on an overlapping or directly adjacent row
+        if (span->l == l && span->r == r && y >= span->t - 1 && y <= span->b + 1) {
+            span->t = QP_MIN(span->t, y);
+            span->b = QP_MAX(span->b, y);
+            return true;
+        }
+    }
+
+    // No room left, so transmit the oldest span to make some space
+    if (batch->count == QP_SPAN_BATCH_SLOTS) {
+        if (!qp_internal_span_batch_emit(batch, 0)) {
+            return false;
+        }
+        memmove(&batch->spans[0], &batch->spans[1], sizeof(struct qp_internal_span) * (QP_SPAN_BATCH_SLOTS - 1));
+        --batch->count;
+    }
+
+    batch->spans[batch->count++] = (struct qp_internal_span){.l = l, .t = y, .r = r, .b = y};
+    return true;
+}
+
+bool qp_internal_span_batch_flush(struct qp_internal_span_batch *batch) {
+    bool ret = true;
+    for (uint8_t i = 0; i < batch->count && ret; ++i) {
+        ret = qp_internal_span_batch_emit(batch, i);
+    }
+    batch->count = 0;
+    return ret;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_setpixel
 
@@ -185,7 +325,11 @@ bool qp_line(painter_device_t device, uint16_t x0, uint16_t y0, uint16_t x1, uin
         return false;
     }
 
-    qp_internal_fill_pixdata(device, 1, hue, sat, val);
+    // Fill up the pixdata buffer so that runs of pixels can be transmitted together
+    qp_internal_fill_pixdata(device, qp_internal_num_pixels_in_buffer(device), hue, sat, val);
+
+    struct qp_internal_span_batch batch;
+    qp_internal_span_batch_init(&batch, device);
 
     // draw angled line using Bresenham's algo
     int16_t x      = ((int16_t)x0);
@@ -200,7 +344,7 @@ bool qp_line(painter_device_t device, uint16_t x0, uint16_t y0, uint16_t x1, uin
 
     bool ret = true;
     while (x != x1 || y != y1) {
-        if (!qp_internal_setpixel_impl(device, x, y)) {
+        if (!qp_internal_span_batch_add(&batch, x, x, y)) {
             ret = false;
             break;
         }
@@ -214,8 +358,8 @@ bool qp_line(painter_device_t device, uint16_t x0, uint16_t y0, uint16_t x1, uin
             y += slopey;
         }
     }
-    // draw the last pixel
-    if (!qp_internal_setpixel_impl(device, x, y)) {
+    // draw the last pixel, then transmit anything outstanding
+    if (!ret || !qp_internal_span_batch_add(&batch, x, x, y) || !qp_internal_span_batch_flush(&batch)) {
         ret = false;
     }
 
@@ -7,7 +7,7 @@
 #include "qp_draw.h"
 
 // Utilize 4-way symmetry to draw an ellipse
-static bool qp_ellipse_helper_impl(painter_device_t device, uint16_t centerx, uint16_t centery, uint16_t offsetx, uint16_t offsety, bool filled) {
+static bool qp_ellipse_helper_impl(struct qp_internal_span_batch *batch, uint16_t centerx, uint16_t centery, uint16_t offsetx, uint16_t offsety, bool filled) {
     /*
     Ellipses have the property of 4-way symmetry, so four pixels can be drawn
     for each computed [offsetx,offsety] given the center coordinates
@@ -16,6 +16,11 @@ static bool qp_ellipse_helper_impl(painter_device_t device, uint16_t centerx, ui
     For filled ellipses, we can draw horizontal lines between each pair of
     pixels with the same final value of y.
 
+    Everything is submitted as horizontal spans to the span batcher, which
+    merges adjacent pixels and repeated fill lines on the same row into the
+    longest possible runs, and stacks runs of the same extent on adjacent
+    rows, before transmitting them to the display.
+
     When offsetx == 0 only two pixels can be drawn for filled or unfilled ellipses
     */
 
@@ -25,30 +30,30 @@ static bool qp_ellipse_helper_impl(painter_device_t device, uint16_t centerx, ui
     int16_t ymy = ((int16_t)centery) - ((int16_t)offsety);
 
     if (offsetx == 0) {
-        if (!qp_internal_setpixel_impl(device, xpx, ypy)) {
+        if (!qp_internal_span_batch_add(batch, xpx, xpx, ypy)) {
             return false;
         }
-        if (!qp_internal_setpixel_impl(device, xpx, ymy)) {
+        if (!qp_internal_span_batch_add(batch, xpx, xpx, ymy)) {
             return false;
         }
     } else if (filled) {
-        if (!qp_internal_fillrect_helper_impl(device, xpx, ypy, xmx, ypy)) {
+        if (!qp_internal_span_batch_add(batch, xpx, xmx, ypy)) {
             return false;
         }
-        if (offsety > 0 && !qp_internal_fillrect_helper_impl(device, xpx, ymy, xmx, ymy)) {
+        if (offsety > 0 && !qp_internal_span_batch_add(batch, xpx, xmx, ymy)) {
             return false;
         }
     } else {
-        if (!qp_internal_setpixel_impl(device, xpx, ypy)) {
+        if (!qp_internal_span_batch_add(batch, xpx, xpx, ypy)) {
             return false;
         }
-        if (!qp_internal_setpixel_impl(device, xpx, ymy)) {
+        if (!qp_internal_span_batch_add(batch, xpx, xpx, ymy)) {
             return false;
         }
-        if (!qp_internal_setpixel_impl(device, xmx, ypy)) {
+        if (!qp_internal_span_batch_add(batch, xmx, xmx, ypy)) {
             return false;
         }
-        if (!qp_internal_setpixel_impl(device, xmx, ymy)) {
+        if (!qp_internal_span_batch_add(batch, xmx, xmx, ymy)) {
             return false;
         }
     }
@@ -57,10 +62,9 @@ static bool qp_ellipse_helper_impl(painter_device_t device, uint16_t centerx, ui
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Quantum Painter External API: qp_ellipse
+// Quantum Painter Core API: qp_internal_ellipse_incremental
 
-bool qp_ellipse(painter_device_t device, uint16_t x, uint16_t y, uint16_t sizex, uint16_t sizey, uint8_t hue, uint8_t sat, uint8_t val, bool filled) {
-    qp_dprintf("qp_ellipse: entry\n");
+bool qp_internal_ellipse_incremental(struct qp_internal_ellipse_state *state, painter_device_t device, uint16_t x, uint16_t y, uint16_t sizex, uint16_t sizey, uint8_t hue, uint8_t sat, uint8_t val, bool filled, uint32_t max_steps, bool *done) {
     struct painter_driver_t *driver = (struct painter_driver_t *)device;
     if (!driver->validate_ok) {
         qp_dprintf("qp_ellipse: fail (validation_ok == false)\n");
@@ -72,45 +76,77 @@ bool qp_ellipse(painter_device_t device, uint16_t x, uint16_t y, uint16_t sizex,
     int16_t fa = 4 * ((int16_t)aa);
     int16_t fb = 4 * ((int16_t)bb);
 
-    int16_t dx = 0;
-    int16_t dy = ((int16_t)sizey);
-
-    qp_internal_fill_pixdata(device, QP_MAX(sizex, sizey), hue, sat, val);
+    // Fill up the pixdata buffer so that runs of pixels can be transmitted together
+    qp_internal_fill_pixdata(device, qp_internal_num_pixels_in_buffer(device), hue, sat, val);
 
     if (!qp_comms_start(device)) {
         qp_dprintf("qp_ellipse: fail (could not start comms)\n");
         return false;
     }
 
+    struct qp_internal_span_batch batch;
+    qp_internal_span_batch_init(&batch, device);
+
+    if (state->phase == 0) {
+        state->phase = 1;
+        state->dx    = 0;
+        state->dy    = ((int16_t)sizey);
+        state->delta = (2 * bb) + (aa * (1 - (2 * sizey)));
+    }
+
     bool ret = true;
-    for (int16_t delta = (2 * bb) + (aa * (1 - (2 * sizey))); bb * dx <= aa * dy; dx++) {
-        if (!qp_ellipse_helper_impl(device, x, y, dx, dy, filled)) {
-            ret = false;
-            break;
-        }
-        if (delta >= 0) {
-            delta += fa * (1 - dy);
-            dy--;
+    for (uint32_t step = 0; ret && step < max_steps && state->phase < 3;) {
+        if (state->phase == 1) {
+            // Steep half, stepping along x
+            if (bb * state->dx > aa * state->dy) {
+                state->phase = 2;
+                state->dx    = sizex;
+                state->dy    = 0;
+                state->delta = (2 * aa) + (bb * (1 - (2 * sizex)));
+                continue;
+            }
+            ret = qp_ellipse_helper_impl(&batch, x, y, state->dx, state->dy, filled);
+            if (state->delta >= 0) {
+                state->delta += fa * (1 - state->dy);
+                state->dy--;
+            }
+            state->delta += bb * (4 * state->dx + 6);
+            state->dx++;
+        } else {
+            // Shallow half, stepping along y
+            if (aa * state->dy > bb * state->dx) {
+                state->phase = 3;
+                break;
+            }
+            ret = qp_ellipse_helper_impl(&batch, x, y, state->dx, state->dy, filled);
+            if (state->delta >= 0) {
+                state->delta += fb * (1 - state->dx);
+                state->dx--;
+            }
+            state->delta += aa * (4 * state->dy + 6);
+            state->dy++;
         }
-        delta += bb * (4 * dx + 6);
+        ++step;
     }
+    *done = state->phase == 3;
 
-    dx = sizex;
-    dy = 0;
-
-    for (int16_t delta = (2 * aa) + (bb * (1 - (2 * sizex))); aa * dy <= bb * dx; dy++) {
-        if (!qp_ellipse_helper_impl(device, x, y, dx, dy, filled)) {
-            ret = false;
-            break;
-        }
-        if (delta >= 0) {
-            delta += fb * (1 - dx);
-            dx--;
-        }
-        delta += aa * (4 * dy + 6);
+    // Transmit anything outstanding
+    if (ret && !qp_internal_span_batch_flush(&batch)) {
+        ret = false;
     }
 
-    qp_dprintf("qp_ellipse: %s\n", ret ? "ok" : "fail");
     qp_comms_stop(device);
     return ret;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_ellipse
+
+bool qp_ellipse(painter_device_t device, uint16_t x, uint16_t y, uint16_t sizex, uint16_t sizey, uint8_t hue, uint8_t sat, uint8_t val, bool filled) {
+    qp_dprintf("qp_ellipse: entry\n");
+    struct qp_internal_ellipse_state state = {0};
+    bool                             done  = false;
+    bool                             ret   = qp_internal_ellipse_incremental(&state, device, x, y, sizex, sizey, hue, sat, val, filled, UINT32_MAX, &done);
+    qp_dprintf("qp_ellipse: %s\n", ret ? "ok" : "fail");
+    return ret;
+}
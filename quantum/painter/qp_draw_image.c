@@ -104,6 +104,7 @@ typedef struct qgf_frame_info_t {
     uint16_t              delay;
 } qgf_frame_info_t;
 
+// Leaves the stream positioned at the frame's pixel data. Comms are left untouched; callers start and stop them.
 static bool qp_drawimage_prepare_frame_for_stream_read(painter_device_t device, qgf_image_handle_t *qgf_image, uint16_t frame_number, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, qgf_frame_info_t *info) {
     struct painter_driver_t *driver = (struct painter_driver_t *)device;
 
@@ -128,35 +129,28 @@ static bool qp_drawimage_prepare_frame_for_stream_read(painter_device_t device,
         return false;
     }
 
-    // Ensure we aren't reusing any palette
-    qp_internal_invalidate_palette();
-
     if (!qp_internal_bpp_capable(info->bpp)) {
         qp_dprintf("qp_drawimage_recolor: fail (image bpp too high (%d), check QUANTUM_PAINTER_SUPPORTS_256_PALETTE)\n", (int)info->bpp);
-        qp_comms_stop(device);
         return false;
     }
 
     // Handle palette if needed
-    const uint16_t palette_entries  = 1u << info->bpp;
-    bool           needs_pixconvert = false;
+    const uint16_t palette_entries = 1u << info->bpp;
     if (info->has_palette) {
         // Load the palette from the stream
         if (!qp_internal_load_qgf_palette((qp_stream_t *)&qgf_image->stream, info->bpp)) {
             return false;
         }
 
-        needs_pixconvert = true;
-    } else {
-        // Interpolate from fg/bg
-        needs_pixconvert = qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, palette_entries);
-    }
-
-    if (needs_pixconvert) {
         // Convert the palette to native format
         if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
             qp_dprintf("qp_drawimage_recolor: fail (could not convert pixels to native)\n");
-            qp_comms_stop(device);
+            return false;
+        }
+    } else {
+        // Interpolate from fg/bg, reusing a cached native palette if available
+        if (!qp_internal_interpolate_native_palette(device, fg_hsv888, bg_hsv888, palette_entries)) {
+            qp_dprintf("qp_drawimage_recolor: fail (could not convert pixels to native)\n");
             return false;
         }
     }
@@ -264,6 +258,119 @@ bool qp_drawimage_recolor(painter_device_t device, uint16_t x, uint16_t y, paint
     return qp_drawimage_recolor_impl(device, x, y, image, 0, &frame_info, fg_hsv888, bg_hsv888);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter Core API: incremental image rendering, used by the command queue
+
+bool qp_internal_drawimage_incremental_begin(struct qp_internal_image_render_state *state, painter_device_t device, uint16_t x, uint16_t y, painter_image_handle_t image, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888) {
+    qp_dprintf("qp_internal_drawimage_incremental_begin: entry\n");
+    struct painter_driver_t *driver = (struct painter_driver_t *)device;
+    if (!driver->validate_ok) {
+        qp_dprintf("qp_internal_drawimage_incremental_begin: fail (validation_ok == false)\n");
+        return false;
+    }
+
+    qgf_image_handle_t *qgf_image = (qgf_image_handle_t *)image;
+    if (!qgf_image->validate_ok) {
+        qp_dprintf("qp_internal_drawimage_incremental_begin: fail (invalid image)\n");
+        return false;
+    }
+
+    qgf_frame_info_t frame_info = {0};
+    if (!qp_drawimage_prepare_frame_for_stream_read(device, qgf_image, 0, fg_hsv888, bg_hsv888, &frame_info)) {
+        qp_dprintf("qp_internal_drawimage_incremental_begin: fail (could not read frame 0)\n");
+        return false;
+    }
+
+    state->device      = device;
+    state->image       = image;
+    state->fg_hsv888   = fg_hsv888;
+    state->bg_hsv888   = bg_hsv888;
+    state->bpp         = frame_info.bpp;
+    state->next_row    = 0;
+    state->input_state    = (struct qp_internal_byte_input_state){.device = device, .src_stream = &qgf_image->stream};
+    state->input_callback = qp_internal_prepare_input_state(&state->input_state, frame_info.compression_scheme);
+    if (state->input_callback == NULL) {
+        qp_dprintf("qp_internal_drawimage_incremental_begin: fail (invalid image compression scheme)\n");
+        return false;
+    }
+
+    if (frame_info.is_delta) {
+        state->left   = x + frame_info.left;
+        state->top    = y + frame_info.top;
+        state->right  = x + frame_info.right - 1;
+        state->bottom = y + frame_info.bottom - 1;
+    } else {
+        state->left   = x;
+        state->top    = y;
+        state->right  = x + image->width - 1;
+        state->bottom = y + image->height - 1;
+    }
+
+    // Remember where the pixel data starts so that rendering can resume from here
+    state->stream_pos = qp_stream_tell(&qgf_image->stream);
+    qp_dprintf("qp_internal_drawimage_incremental_begin: ok\n");
+    return true;
+}
+
+bool qp_internal_drawimage_incremental_continue(struct qp_internal_image_render_state *state, uint32_t max_pixels, bool *done) {
+    struct painter_driver_t *driver    = (struct painter_driver_t *)state->device;
+    qgf_image_handle_t *     qgf_image = (qgf_image_handle_t *)state->image;
+    if (!qgf_image->validate_ok) {
+        qp_dprintf("qp_internal_drawimage_incremental_continue: fail (invalid image)\n");
+        return false;
+    }
+
+    // Work out how many rows we can render this time around. Each chunk needs to end on a byte boundary in the source
+    // data, as partially-consumed bytes cannot be resumed -- round up the row count until that's the case.
+    const uint16_t width           = state->right - state->left + 1;
+    const uint16_t height          = state->bottom - state->top + 1;
+    const uint8_t  pixels_per_byte = 8 / state->bpp;
+    uint16_t       rows            = QP_MAX(1, max_pixels / width);
+    while ((((uint32_t)rows) * width) % pixels_per_byte != 0) {
+        ++rows;
+    }
+    rows = QP_MIN(rows, height - state->next_row);
+
+    if (!qp_comms_start(state->device)) {
+        qp_dprintf("qp_internal_drawimage_incremental_continue: fail (could not start comms)\n");
+        return false;
+    }
+
+    // Other drawing may have happened in the meantime -- set the palette back up, then return to where we left off
+    qgf_frame_info_t frame_info = {0};
+    if (!qp_drawimage_prepare_frame_for_stream_read(state->device, qgf_image, 0, state->fg_hsv888, state->bg_hsv888, &frame_info)) {
+        qp_dprintf("qp_internal_drawimage_incremental_continue: fail (could not read frame 0)\n");
+        qp_comms_stop(state->device);
+        return false;
+    }
+    qp_stream_setpos(&qgf_image->stream, state->stream_pos);
+
+    uint16_t t = state->top + state->next_row;
+    uint16_t b = t + rows - 1;
+    if (!driver->driver_vtable->viewport(state->device, state->left, t, state->right, b)) {
+        qp_dprintf("qp_internal_drawimage_incremental_continue: fail (could not set viewport)\n");
+        qp_comms_stop(state->device);
+        return false;
+    }
+
+    // Decode the pixel data for this chunk and stream to the display
+    struct qp_internal_pixel_output_state output_state = {.device = state->device, .pixel_write_pos = 0, .max_pixels = qp_internal_num_pixels_in_buffer(state->device)};
+    bool                                  ret          = qp_internal_decode_palette(state->device, ((uint32_t)rows) * width, state->bpp, state->input_callback, &state->input_state, qp_internal_global_pixel_lookup_table, qp_internal_pixel_appender, &output_state);
+
+    // Any leftovers need transmission as well.
+    if (ret && output_state.pixel_write_pos > 0) {
+        ret &= driver->driver_vtable->pixdata(state->device, qp_internal_global_pixdata_buffer, output_state.pixel_write_pos);
+    }
+
+    state->stream_pos = qp_stream_tell(&qgf_image->stream);
+    state->next_row += rows;
+    *done = state->next_row >= height;
+
+    qp_comms_stop(state->device);
+    qp_dprintf("qp_internal_drawimage_incremental_continue: %s (%d of %d rows)\n", ret ? "ok" : "fail", (int)state->next_row, (int)height);
+    return ret;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_animate
 
@@ -0,0 +1,328 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <quantum.h>
+#include <utf8.h>
+
+#include "qp_internal.h"
+#include "qp_draw.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Queued command definitions
+
+typedef enum qp_queue_command_type_t {
+    QP_QUEUE_SETPIXEL,
+    QP_QUEUE_LINE,
+    QP_QUEUE_RECT,
+    QP_QUEUE_CIRCLE,
+    QP_QUEUE_ELLIPSE,
+    QP_QUEUE_DRAWIMAGE,
+    QP_QUEUE_DRAWTEXT,
+    QP_QUEUE_FLUSH,
+} qp_queue_command_type_t;
+
+typedef struct qp_queue_command_t {
+    painter_device_t        device;
+    qp_queue_command_type_t type;
+    bool                    started;
+    union {
+        // Primitives -- setpixel, line, rect, circle, ellipse
+        struct {
+            uint16_t x0;
+            uint16_t y0;
+            uint16_t x1;
+            uint16_t y1;
+            uint8_t  hue;
+            uint8_t  sat;
+            uint8_t  val;
+            bool     filled;
+            union {
+                uint16_t                         next_row; // rect only, the next row of the fill to be drawn
+                struct qp_internal_circle_state  circle;
+                struct qp_internal_ellipse_state ellipse;
+            };
+        } shape;
+
+        // Images
+        struct {
+            uint16_t                              x;
+            uint16_t                              y;
+            painter_image_handle_t                handle;
+            qp_pixel_t                            fg_hsv888;
+            qp_pixel_t                            bg_hsv888;
+            struct qp_internal_image_render_state render_state;
+        } image;
+
+        // Text
+        struct {
+            uint16_t              x;
+            uint16_t              y;
+            painter_font_handle_t font;
+            qp_pixel_t            fg_hsv888;
+            qp_pixel_t            bg_hsv888;
+            uint16_t              pos; // offset of the next codepoint to be drawn
+            char                  str[QUANTUM_PAINTER_QUEUE_TEXT_LENGTH];
+        } text;
+    };
+} qp_queue_command_t;
+
+// The queue head and count are stored as uint8_t
+_Static_assert(QUANTUM_PAINTER_QUEUE_SIZE <= 255, "QUANTUM_PAINTER_QUEUE_SIZE must be no more than 255");
+
+static qp_queue_command_t queue[QUANTUM_PAINTER_QUEUE_SIZE] = {0};
+static uint8_t            queue_head                        = 0;
+static uint8_t            queue_count                       = 0;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Queue helpers
+
+static qp_queue_command_t *qp_queue_alloc(painter_device_t device, qp_queue_command_type_t type) {
+    struct painter_driver_t *driver = (struct painter_driver_t *)device;
+    if (!driver->validate_ok) {
+        qp_dprintf("qp_queue: fail (validation_ok == false)\n");
+        return NULL;
+    }
+
+    if (queue_count >= QUANTUM_PAINTER_QUEUE_SIZE) {
+        qp_dprintf("qp_queue: fail (queue full)\n");
+        return NULL;
+    }
+
+    qp_queue_command_t *cmd = &queue[(queue_head + queue_count) % QUANTUM_PAINTER_QUEUE_SIZE];
+    memset(cmd, 0, sizeof(qp_queue_command_t));
+    cmd->device = device;
+    cmd->type   = type;
+    ++queue_count;
+    return cmd;
+}
+
+static bool qp_queue_shape(painter_device_t device, qp_queue_command_type_t type, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t hue, uint8_t sat, uint8_t val, bool filled) {
+    qp_queue_command_t *cmd = qp_queue_alloc(device, type);
+    if (!cmd) {
+        return false;
+    }
+
+    cmd->shape.x0     = x0;
+    cmd->shape.y0     = y0;
+    cmd->shape.x1     = x1;
+    cmd->shape.y1     = y1;
+    cmd->shape.hue    = hue;
+    cmd->shape.sat    = sat;
+    cmd->shape.val    = val;
+    cmd->shape.filled = filled;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Command execution
+//
+// Each invocation performs a bounded amount of work, returning true in `done` once the command has completed. Any
+// command which fails is considered complete, and is discarded.
+
+static bool qp_queue_execute_rect(qp_queue_command_t *cmd, bool *done) {
+    uint16_t l = QP_MIN(cmd->shape.x0, cmd->shape.x1);
+    uint16_t r = QP_MAX(cmd->shape.x0, cmd->shape.x1);
+    uint16_t t = QP_MIN(cmd->shape.y0, cmd->shape.y1);
+    uint16_t b = QP_MAX(cmd->shape.y0, cmd->shape.y1);
+
+    // Outlines are cheap, so don't bother splitting them up
+    if (!cmd->shape.filled) {
+        *done = true;
+        return qp_rect(cmd->device, l, t, r, b, cmd->shape.hue, cmd->shape.sat, cmd->shape.val, false);
+    }
+
+    // Fill a band of rows at a time
+    uint16_t rows = QP_MAX(1, QUANTUM_PAINTER_QUEUE_CHUNK_PIXELS / (r - l + 1));
+    uint16_t top  = t + cmd->shape.next_row;
+    uint16_t bot  = QP_MIN(b, top + rows - 1);
+    bool     ret  = qp_rect(cmd->device, l, top, r, bot, cmd->shape.hue, cmd->shape.sat, cmd->shape.val, true);
+    cmd->shape.next_row += rows;
+    *done = bot >= b;
+    return ret;
+}
+
+static bool qp_queue_execute_circle(qp_queue_command_t *cmd, bool *done) {
+    // Each step of the midpoint algorithm draws up to four fill lines, or eight pixels for an outline
+    uint32_t radius = cmd->shape.x1;
+    uint32_t steps  = QP_MAX(1, QUANTUM_PAINTER_QUEUE_CHUNK_PIXELS / (cmd->shape.filled ? 4 * (2 * radius + 1) : 8));
+    return qp_internal_circle_incremental(&cmd->shape.circle, cmd->device, cmd->shape.x0, cmd->shape.y0, cmd->shape.x1, cmd->shape.hue, cmd->shape.sat, cmd->shape.val, cmd->shape.filled, steps, done);
+}
+
+static bool qp_queue_execute_ellipse(qp_queue_command_t *cmd, bool *done) {
+    // Each step of the midpoint algorithm draws up to two fill lines, or four pixels for an outline
+    uint32_t widest = cmd->shape.x1;
+    uint32_t steps  = QP_MAX(1, QUANTUM_PAINTER_QUEUE_CHUNK_PIXELS / (cmd->shape.filled ? 2 * (2 * widest + 1) : 4));
+    return qp_internal_ellipse_incremental(&cmd->shape.ellipse, cmd->device, cmd->shape.x0, cmd->shape.y0, cmd->shape.x1, cmd->shape.y1, cmd->shape.hue, cmd->shape.sat, cmd->shape.val, cmd->shape.filled, steps, done);
+}
+
+static bool qp_queue_execute_drawimage(qp_queue_command_t *cmd, bool *done) {
+    if (!cmd->started) {
+        cmd->started = true;
+        if (!qp_internal_drawimage_incremental_begin(&cmd->image.render_state, cmd->device, cmd->image.x, cmd->image.y, cmd->image.handle, cmd->image.fg_hsv888, cmd->image.bg_hsv888)) {
+            *done = true;
+            return false;
+        }
+    }
+
+    return qp_internal_drawimage_incremental_continue(&cmd->image.render_state, QUANTUM_PAINTER_QUEUE_CHUNK_PIXELS, done);
+}
+
+static bool qp_queue_execute_drawtext(qp_queue_command_t *cmd, bool *done) {
+    // Draw one glyph at a time
+    const char *curr = &cmd->text.str[cmd->text.pos];
+    int32_t     code_point;
+    const char *next = decode_utf8(curr, &code_point);
+    if (code_point <= 0) {
+        *done = true;
+        return code_point == 0;
+    }
+
+    char    glyph[5] = {0};
+    uint8_t len      = QP_MIN(next - curr, (int)sizeof(glyph) - 1);
+    memcpy(glyph, curr, len);
+    int16_t width = qp_drawtext_recolor(cmd->device, cmd->text.x, cmd->text.y, cmd->text.font, glyph, cmd->text.fg_hsv888.hsv888.h, cmd->text.fg_hsv888.hsv888.s, cmd->text.fg_hsv888.hsv888.v, cmd->text.bg_hsv888.hsv888.h, cmd->text.bg_hsv888.hsv888.s, cmd->text.bg_hsv888.hsv888.v);
+
+    cmd->text.x += width;
+    cmd->text.pos += len;
+    *done = (width == 0) || (cmd->text.str[cmd->text.pos] == 0);
+    return width != 0;
+}
+
+static bool qp_queue_execute(qp_queue_command_t *cmd, bool *done) {
+    *done = true;
+    switch (cmd->type) {
+        case QP_QUEUE_SETPIXEL:
+            return qp_setpixel(cmd->device, cmd->shape.x0, cmd->shape.y0, cmd->shape.hue, cmd->shape.sat, cmd->shape.val);
+        case QP_QUEUE_LINE:
+            return qp_line(cmd->device, cmd->shape.x0, cmd->shape.y0, cmd->shape.x1, cmd->shape.y1, cmd->shape.hue, cmd->shape.sat, cmd->shape.val);
+        case QP_QUEUE_RECT:
+            return qp_queue_execute_rect(cmd, done);
+        case QP_QUEUE_CIRCLE:
+            return qp_queue_execute_circle(cmd, done);
+        case QP_QUEUE_ELLIPSE:
+            return qp_queue_execute_ellipse(cmd, done);
+        case QP_QUEUE_DRAWIMAGE:
+            return qp_queue_execute_drawimage(cmd, done);
+        case QP_QUEUE_DRAWTEXT:
+            return qp_queue_execute_drawtext(cmd, done);
+        case QP_QUEUE_FLUSH:
+            return qp_flush(cmd->device);
+        default:
+            return false;
+    }
+}
+
+// Performs a single bounded step of the command at the front of the queue. Returns false if the queue is empty.
+static bool qp_queue_step(void) {
+    if (queue_count == 0) {
+        return false;
+    }
+
+    qp_queue_command_t *cmd  = &queue[queue_head];
+    bool                done = true;
+    if (!qp_queue_execute(cmd, &done)) {
+        qp_dprintf("qp_queue: command %d failed, discarding\n", (int)cmd->type);
+        done = true;
+    }
+
+    if (done) {
+        queue_head = (queue_head + 1) % QUANTUM_PAINTER_QUEUE_SIZE;
+        --queue_count;
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_queue_*
+
+bool qp_queue_setpixel(painter_device_t device, uint16_t x, uint16_t y, uint8_t hue, uint8_t sat, uint8_t val) {
+    return qp_queue_shape(device, QP_QUEUE_SETPIXEL, x, y, x, y, hue, sat, val, true);
+}
+
+bool qp_queue_line(painter_device_t device, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t hue, uint8_t sat, uint8_t val) {
+    return qp_queue_shape(device, QP_QUEUE_LINE, x0, y0, x1, y1, hue, sat, val, true);
+}
+
+bool qp_queue_rect(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom, uint8_t hue, uint8_t sat, uint8_t val, bool filled) {
+    return qp_queue_shape(device, QP_QUEUE_RECT, left, top, right, bottom, hue, sat, val, filled);
+}
+
+bool qp_queue_circle(painter_device_t device, uint16_t x, uint16_t y, uint16_t radius, uint8_t hue, uint8_t sat, uint8_t val, bool filled) {
+    return qp_queue_shape(device, QP_QUEUE_CIRCLE, x, y, radius, radius, hue, sat, val, filled);
+}
+
+bool qp_queue_ellipse(painter_device_t device, uint16_t x, uint16_t y, uint16_t sizex, uint16_t sizey, uint8_t hue, uint8_t sat, uint8_t val, bool filled) {
+    return qp_queue_shape(device, QP_QUEUE_ELLIPSE, x, y, sizex, sizey, hue, sat, val, filled);
+}
+
+bool qp_queue_drawimage(painter_device_t device, uint16_t x, uint16_t y, painter_image_handle_t image) {
+    return qp_queue_drawimage_recolor(device, x, y, image, 0, 0, 255, 0, 0, 0);
+}
+
+bool qp_queue_drawimage_recolor(painter_device_t device, uint16_t x, uint16_t y, painter_image_handle_t image, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg) {
+    qp_queue_command_t *cmd = qp_queue_alloc(device, QP_QUEUE_DRAWIMAGE);
+    if (!cmd) {
+        return false;
+    }
+
+    cmd->image.x         = x;
+    cmd->image.y         = y;
+    cmd->image.handle    = image;
+    cmd->image.fg_hsv888 = (qp_pixel_t){.hsv888 = {.h = hue_fg, .s = sat_fg, .v = val_fg}};
+    cmd->image.bg_hsv888 = (qp_pixel_t){.hsv888 = {.h = hue_bg, .s = sat_bg, .v = val_bg}};
+    return true;
+}
+
+bool qp_queue_drawtext(painter_device_t device, uint16_t x, uint16_t y, painter_font_handle_t font, const char *str) {
+    return qp_queue_drawtext_recolor(device, x, y, font, str, 0, 0, 255, 0, 0, 0);
+}
+
+bool qp_queue_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, painter_font_handle_t font, const char *str, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg) {
+    if (strlen(str) >= QUANTUM_PAINTER_QUEUE_TEXT_LENGTH) {
+        qp_dprintf("qp_queue_drawtext_recolor: fail (string too long)\n");
+        return false;
+    }
+
+    qp_queue_command_t *cmd = qp_queue_alloc(device, QP_QUEUE_DRAWTEXT);
+    if (!cmd) {
+        return false;
+    }
+
+    cmd->text.x         = x;
+    cmd->text.y         = y;
+    cmd->text.font      = font;
+    cmd->text.fg_hsv888 = (qp_pixel_t){.hsv888 = {.h = hue_fg, .s = sat_fg, .v = val_fg}};
+    cmd->text.bg_hsv888 = (qp_pixel_t){.hsv888 = {.h = hue_bg, .s = sat_bg, .v = val_bg}};
+    strcpy(cmd->text.str, str);
+    return true;
+}
+
+bool qp_queue_flush(painter_device_t device) {
+    return qp_queue_alloc(device, QP_QUEUE_FLUSH) != NULL;
+}
+
+bool qp_queue_drained(void) {
+    return queue_count == 0;
+}
+
+void qp_queue_drain(void) {
+    while (qp_queue_step()) {
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter Core API: qp_internal_queue_tick
+
+void qp_internal_queue_tick(void) {
+    if (queue_count == 0) {
+        return;
+    }
+
+    // Always make some progress, then keep going until the time budget for this scan iteration has been used up
+    uint32_t start = timer_read32();
+    do {
+        if (!qp_queue_step()) {
+            break;
+        }
+    } while (timer_elapsed32(start) < QUANTUM_PAINTER_QUEUE_TIME_BUDGET_MS);
+}
@@ -1,6 +1,7 @@
 # Quantum Painter Configurables
 QUANTUM_PAINTER_DRIVERS ?=
 QUANTUM_PAINTER_ANIMATIONS_ENABLE ?= yes
+QUANTUM_PAINTER_QUEUE_ENABLE ?= no
 
 # The list of permissible drivers that can be listed in QUANTUM_PAINTER_DRIVERS
 VALID_QUANTUM_PAINTER_DRIVERS := ili9163_spi ili9341_spi ili9488_spi st7789_spi st7735_spi gc9a01_spi ssd1351_spi
@@ -29,6 +30,12 @@ ifeq ($(strip $(QUANTUM_PAINTER_ANIMATIONS_ENABLE)), yes)
     OPT_DEFS += -DQUANTUM_PAINTER_ANIMATIONS_ENABLE
 endif
 
+# Check if people want queued rendering
+ifeq ($(strip $(QUANTUM_PAINTER_QUEUE_ENABLE)), yes)
+    OPT_DEFS += -DQUANTUM_PAINTER_QUEUE_ENABLE
+    SRC += $(QUANTUM_DIR)/painter/qp_queue.c
+endif
+
 # Comms flags
 QUANTUM_PAINTER_NEEDS_COMMS_SPI ?= no
 
@@ -0,0 +1,616 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "qp.h"
+#include "qp_mock.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+void qp_internal_animation_tick(void);
+
+// The internal headers use the C11 spelling
+#define _Static_assert static_assert
+#include "qp_draw.h"
+#undef _Static_assert
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// QGF/QFF builders -- produce the same byte layout as `qmk painter-convert-graphics` and `qmk painter-make-font-image`
+
+namespace {
+
+enum { FORMAT_GRAYSCALE_1BPP = 0x00, FORMAT_GRAYSCALE_2BPP = 0x01, FORMAT_PALETTE_2BPP = 0x05 };
+enum { COMPRESSION_NONE = 0x00, COMPRESSION_RLE = 0x01 };
+
+struct hsv_t {
+    uint8_t h, s, v;
+};
+
+struct frame_t {
+    uint8_t              format;
+    uint8_t              compression;
+    uint16_t             delay;
+    std::vector<hsv_t>   palette;
+    std::vector<uint8_t> data;
+};
+
+void put_u8(std::vector<uint8_t> &v, uint8_t x) {
+    v.push_back(x);
+}
+
+void put_u16(std::vector<uint8_t> &v, uint16_t x) {
+    v.push_back(x & 0xFF);
+    v.push_back(x >> 8);
+}
+
+void put_u24(std::vector<uint8_t> &v, uint32_t x) {
+    v.push_back(x & 0xFF);
+    v.push_back((x >> 8) & 0xFF);
+    v.push_back((x >> 16) & 0xFF);
+}
+
+void put_u32(std::vector<uint8_t> &v, uint32_t x) {
+    put_u16(v, x & 0xFFFF);
+    put_u16(v, x >> 16);
+}
+
+void patch_u32(std::vector<uint8_t> &v, size_t offset, uint32_t x) {
+    for (int i = 0; i < 4; ++i) {
+        v[offset + i] = (x >> (i * 8)) & 0xFF;
+    }
+}
+
+void put_block_header(std::vector<uint8_t> &v, uint8_t type_id, uint32_t length) {
+    put_u8(v, type_id);
+    put_u8(v, ~type_id);
+    put_u24(v, length);
+}
+
+std::vector<uint8_t> make_qgf(uint16_t width, uint16_t height, const std::vector<frame_t> &frames) {
+    std::vector<uint8_t> v;
+
+    // Graphics descriptor
+    put_block_header(v, 0x00, 18);
+    put_u24(v, 0x464751);
+    put_u8(v, 0x01);
+    put_u32(v, 0); // total size, patched below
+    put_u32(v, 0); // negated total size, patched below
+    put_u16(v, width);
+    put_u16(v, height);
+    put_u16(v, frames.size());
+
+    // Frame offsets
+    put_block_header(v, 0x01, frames.size() * 4);
+    size_t offsets_pos = v.size();
+    for (size_t i = 0; i < frames.size(); ++i) {
+        put_u32(v, 0);
+    }
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const frame_t &f = frames[i];
+        patch_u32(v, offsets_pos + i * 4, v.size());
+
+        // Frame descriptor
+        put_block_header(v, 0x02, 6);
+        put_u8(v, f.format);
+        put_u8(v, 0);
+        put_u8(v, f.compression);
+        put_u8(v, 0);
+        put_u16(v, f.delay);
+
+        // Palette
+        if (!f.palette.empty()) {
+            put_block_header(v, 0x03, f.palette.size() * 3);
+            for (auto &e : f.palette) {
+                put_u8(v, e.h);
+                put_u8(v, e.s);
+                put_u8(v, e.v);
+            }
+        }
+
+        // Data
+        put_block_header(v, 0x05, f.data.size());
+        v.insert(v.end(), f.data.begin(), f.data.end());
+    }
+
+    patch_u32(v, 9, v.size());
+    patch_u32(v, 13, ~(uint32_t)v.size());
+    return v;
+}
+
+// 1bpp grayscale font with a line height of 5, 'A' is a solid 4x5 block and 'B' is a 2x5 left-aligned bar
+std::vector<uint8_t> make_test_qff(void) {
+    std::vector<uint8_t> v;
+
+    // Font descriptor
+    put_block_header(v, 0x00, 20);
+    put_u24(v, 0x464651);
+    put_u8(v, 0x01);
+    put_u32(v, 0); // total size, patched below
+    put_u32(v, 0); // negated total size, patched below
+    put_u8(v, 5);  // line height
+    put_u8(v, 1);  // has ascii table
+    put_u16(v, 0); // no unicode glyphs
+    put_u8(v, FORMAT_GRAYSCALE_1BPP);
+    put_u8(v, 0);
+    put_u8(v, COMPRESSION_NONE);
+    put_u8(v, 0);
+
+    // ASCII table -- 'A' at data offset 0, 'B' at data offset 3 (4x5 pixels at 1bpp rounds up to 3 bytes)
+    put_block_header(v, 0x01, 95 * 3);
+    for (int c = 0x20; c < 0x7F; ++c) {
+        uint32_t width = 0, offset = 0;
+        if (c == 'A') {
+            width  = 4;
+            offset = 0;
+        } else if (c == 'B') {
+            width  = 2;
+            offset = 3;
+        }
+        put_u24(v, width | (offset << 6));
+    }
+
+    // Glyph data
+    std::vector<uint8_t> data = {
+        0xFF, 0xFF, 0x0F, // 'A', 20 pixels all lit
+        0xFF, 0x03,       // 'B', 10 pixels all lit
+    };
+    put_block_header(v, 0x04, data.size());
+    v.insert(v.end(), data.begin(), data.end());
+
+    patch_u32(v, 9, v.size());
+    patch_u32(v, 13, ~(uint32_t)v.size());
+    return v;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Fixture
+
+class QuantumPainter : public ::testing::Test {
+   protected:
+    painter_device_t device;
+
+    void SetUp() override {
+        set_time(0);
+        device = qp_mock_make_device(64, 48);
+        ASSERT_TRUE(qp_init(device, QP_ROTATION_0));
+        qp_mock_reset_stats(device);
+    }
+
+    void TearDown() override {
+        // Optionally dump the canvas for visual inspection, e.g. `QP_MOCK_DUMP_DIR=/tmp make test:painter`
+        const char *dump_dir = getenv("QP_MOCK_DUMP_DIR");
+        if (dump_dir) {
+            std::string name = std::string(dump_dir) + "/" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".ppm";
+            qp_mock_dump_ppm(device, name.c_str());
+        }
+    }
+
+    bool is_white(uint16_t x, uint16_t y) {
+        return qp_mock_pixel_is(device, x, y, 255, 255, 255);
+    }
+
+    bool is_black(uint16_t x, uint16_t y) {
+        return qp_mock_pixel_is(device, x, y, 0, 0, 0);
+    }
+
+    std::vector<uint8_t> capture() {
+        std::vector<uint8_t> canvas;
+        for (uint16_t y = 0; y < 48; ++y) {
+            for (uint16_t x = 0; x < 64; ++x) {
+                const uint8_t *px = qp_mock_get_pixel(device, x, y);
+                canvas.insert(canvas.end(), px, px + 3);
+            }
+        }
+        return canvas;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Primitives
+
+TEST_F(QuantumPainter, SetPixel) {
+    EXPECT_TRUE(qp_setpixel(device, 3, 4, 0, 255, 255));
+    EXPECT_TRUE(qp_mock_pixel_is(device, 3, 4, 255, 0, 0));
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 1);
+
+    qp_mock_bus_stats_t stats = qp_mock_get_stats(device);
+    EXPECT_EQ(stats.viewport_calls, 1);
+    EXPECT_EQ(stats.pixdata_calls, 1);
+    EXPECT_EQ(stats.transactions, QP_MOCK_VIEWPORT_TRANSACTIONS + 1);
+    EXPECT_EQ(stats.bytes, QP_MOCK_VIEWPORT_BYTES + QP_MOCK_BYTES_PER_PIXEL);
+}
+
+TEST_F(QuantumPainter, RectFilled) {
+    EXPECT_TRUE(qp_rect(device, 10, 10, 19, 14, 0, 0, 255, true));
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 50);
+    EXPECT_TRUE(is_white(10, 10));
+    EXPECT_TRUE(is_white(19, 14));
+    EXPECT_TRUE(is_black(9, 10));
+    EXPECT_TRUE(is_black(20, 14));
+    EXPECT_TRUE(is_black(10, 15));
+
+    // A filled rect is a single viewport, with all of its pixels streamed in
+    qp_mock_bus_stats_t stats = qp_mock_get_stats(device);
+    EXPECT_EQ(stats.viewport_calls, 1);
+    EXPECT_EQ(stats.pixels, 50);
+}
+
+TEST_F(QuantumPainter, RectOutline) {
+    EXPECT_TRUE(qp_rect(device, 10, 10, 19, 19, 0, 0, 255, false));
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 36);
+    EXPECT_TRUE(is_white(10, 10));
+    EXPECT_TRUE(is_white(19, 19));
+    EXPECT_TRUE(is_black(15, 15));
+}
+
+TEST_F(QuantumPainter, LineHorizontalVerticalDiagonal) {
+    EXPECT_TRUE(qp_line(device, 0, 0, 9, 0, 0, 0, 255));
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 10);
+
+    EXPECT_TRUE(qp_line(device, 0, 2, 0, 11, 0, 0, 255));
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 20);
+
+    qp_mock_reset_stats(device);
+    EXPECT_TRUE(qp_line(device, 20, 20, 29, 29, 0, 0, 255));
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 30);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(is_white(20 + i, 20 + i));
+    }
+    EXPECT_EQ(qp_mock_get_stats(device).pixels, 10);
+}
+
+TEST_F(QuantumPainter, CircleFilledIsSymmetric) {
+    EXPECT_TRUE(qp_circle(device, 32, 24, 10, 0, 0, 255, true));
+    EXPECT_TRUE(is_white(32, 24));
+    EXPECT_TRUE(is_white(22, 24));
+    EXPECT_TRUE(is_white(42, 24));
+    EXPECT_TRUE(is_white(32, 14));
+    EXPECT_TRUE(is_white(32, 34));
+    EXPECT_TRUE(is_black(21, 24));
+    EXPECT_TRUE(is_black(43, 24));
+    EXPECT_TRUE(is_black(22, 14));
+    for (int dy = -10; dy <= 10; ++dy) {
+        for (int dx = -10; dx <= 10; ++dx) {
+            EXPECT_EQ(is_white(32 + dx, 24 + dy), is_white(32 - dx, 24 + dy));
+            EXPECT_EQ(is_white(32 + dx, 24 + dy), is_white(32 + dx, 24 - dy));
+        }
+    }
+}
+
+TEST_F(QuantumPainter, CircleOutlineBatchesSpans) {
+    EXPECT_TRUE(qp_circle(device, 32, 24, 20, 0, 0, 255, false));
+    uint32_t            lit   = qp_mock_count_lit_pixels(device);
+    qp_mock_bus_stats_t stats = qp_mock_get_stats(device);
+    EXPECT_GT(lit, 0);
+    EXPECT_TRUE(is_white(12, 24));
+    EXPECT_TRUE(is_white(52, 24));
+    EXPECT_TRUE(is_black(32, 24));
+
+    // Adjacent pixels on the same row are merged into spans, so there must be fewer viewport changes than pixels
+    EXPECT_LT(stats.viewport_calls, lit);
+}
+
+TEST_F(QuantumPainter, EllipseFilled) {
+    EXPECT_TRUE(qp_ellipse(device, 32, 24, 20, 10, 0, 0, 255, true));
+    EXPECT_TRUE(is_white(32, 24));
+    EXPECT_TRUE(is_white(12, 24));
+    EXPECT_TRUE(is_white(52, 24));
+    EXPECT_TRUE(is_white(32, 14));
+    EXPECT_TRUE(is_white(32, 34));
+    EXPECT_TRUE(is_black(11, 24));
+    EXPECT_TRUE(is_black(32, 13));
+    EXPECT_TRUE(is_black(32, 35));
+}
+
+/**
+ * Prints the bus traffic of circles, ellipses and lines, as a baseline for the span batching.
+ */
+TEST_F(QuantumPainter, ShapeTransferReport) {
+    // min_px_per_viewport is the batching each shape must reach; per-row or per-pixel windows fall well below it
+    struct shape_t {
+        const char *name;
+        bool (*draw)(painter_device_t device);
+        uint32_t min_px_per_viewport;
+    };
+    const shape_t shapes[] = {
+        {"filled circle r=20", [](painter_device_t d) { return qp_circle(d, 32, 24, 20, 0, 0, 255, true); }, 40},
+        {"circle outline r=20", [](painter_device_t d) { return qp_circle(d, 32, 24, 20, 0, 0, 255, false); }, 2},
+        {"filled ellipse 20x10", [](painter_device_t d) { return qp_ellipse(d, 32, 24, 20, 10, 0, 0, 255, true); }, 30},
+        {"ellipse outline 20x10", [](painter_device_t d) { return qp_ellipse(d, 32, 24, 20, 10, 0, 0, 255, false); }, 2},
+        {"shallow line 60x5", [](painter_device_t d) { return qp_line(d, 2, 20, 61, 24, 0, 0, 255); }, 10},
+        {"steep line 5x40", [](painter_device_t d) { return qp_line(d, 20, 4, 24, 43, 0, 0, 255); }, 8},
+        // 45 degree pixels touch only at corners, so no two of them can share a rectangle
+        {"diagonal line 30x30", [](painter_device_t d) { return qp_line(d, 10, 10, 39, 39, 0, 0, 255); }, 1},
+    };
+    for (const shape_t &shape : shapes) {
+        device = qp_mock_make_device(64, 48);
+        ASSERT_TRUE(qp_init(device, QP_ROTATION_0));
+        qp_mock_reset_stats(device);
+        EXPECT_TRUE(shape.draw(device));
+        qp_mock_bus_stats_t stats = qp_mock_get_stats(device);
+        printf("[ QP SHAPES  ] %-22s %4u px lit, %4u viewports, %5u transactions, %6u bytes\n", shape.name, qp_mock_count_lit_pixels(device), stats.viewport_calls, stats.transactions, stats.bytes);
+        EXPECT_LE(stats.viewport_calls * shape.min_px_per_viewport, qp_mock_count_lit_pixels(device)) << shape.name;
+    }
+}
+
+TEST_F(QuantumPainter, ClippingOutsidePanelIsIgnored) {
+    EXPECT_TRUE(qp_rect(device, 60, 44, 70, 50, 0, 0, 255, true));
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 4 * 4);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Images
+
+TEST_F(QuantumPainter, ImageGrayscale1bpp) {
+    // 8x2 checkerboard, pixels are packed LSB-first
+    auto                   qgf   = make_qgf(8, 2, {{FORMAT_GRAYSCALE_1BPP, COMPRESSION_NONE, 0, {}, {0x55, 0xAA}}});
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+    EXPECT_EQ(image->width, 8);
+    EXPECT_EQ(image->height, 2);
+
+    EXPECT_TRUE(qp_drawimage(device, 4, 4, image));
+    for (int x = 0; x < 8; ++x) {
+        EXPECT_EQ(is_white(4 + x, 4), (x % 2) == 0);
+        EXPECT_EQ(is_white(4 + x, 5), (x % 2) == 1);
+    }
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 8);
+    EXPECT_TRUE(qp_close_image(image));
+}
+
+TEST_F(QuantumPainter, ImageRecolor) {
+    auto                   qgf   = make_qgf(2, 1, {{FORMAT_GRAYSCALE_1BPP, COMPRESSION_NONE, 0, {}, {0x01}}});
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    EXPECT_TRUE(qp_drawimage_recolor(device, 0, 0, image, 0, 255, 255, 170, 255, 255));
+    EXPECT_TRUE(qp_mock_pixel_is(device, 0, 0, 255, 0, 0));
+    EXPECT_TRUE(qp_mock_pixel_is(device, 1, 0, 0, 0, 255));
+    EXPECT_TRUE(qp_close_image(image));
+}
+
+TEST_F(QuantumPainter, ImagePaletteRLE) {
+    // 2bpp palette of black/red/green/blue; 16 pixels: 8x red (repeated run), then blue, green, red, black repeated twice (non-repeated run)
+    std::vector<hsv_t>     palette = {{0, 0, 0}, {0, 255, 255}, {85, 255, 255}, {170, 255, 255}};
+    std::vector<uint8_t>   rle     = {0x02, 0x55, 0x81, 0x1B, 0x1B};
+    auto                   qgf     = make_qgf(8, 2, {{FORMAT_PALETTE_2BPP, COMPRESSION_RLE, 0, palette, rle}});
+    painter_image_handle_t image   = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    EXPECT_TRUE(qp_drawimage(device, 0, 0, image));
+    for (int x = 0; x < 8; ++x) {
+        EXPECT_TRUE(qp_mock_pixel_is(device, x, 0, 255, 0, 0));
+    }
+    EXPECT_TRUE(qp_mock_pixel_is(device, 0, 1, 0, 0, 255));
+    EXPECT_TRUE(qp_mock_pixel_is(device, 1, 1, 0, 255, 0));
+    EXPECT_TRUE(qp_mock_pixel_is(device, 2, 1, 255, 0, 0));
+    EXPECT_TRUE(qp_mock_pixel_is(device, 3, 1, 0, 0, 0));
+    EXPECT_TRUE(qp_mock_pixel_is(device, 4, 1, 0, 0, 255));
+    EXPECT_TRUE(qp_close_image(image));
+}
+
+TEST_F(QuantumPainter, ImageRejectsCorruptHeader) {
+    auto qgf = make_qgf(2, 1, {{FORMAT_GRAYSCALE_1BPP, COMPRESSION_NONE, 0, {}, {0x01}}});
+    qgf[1]   = 0x00; // break the negated type id
+    EXPECT_EQ(qp_load_image_mem(qgf.data()), nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Fonts
+
+TEST_F(QuantumPainter, FontAsciiGlyphs) {
+    auto                  qff  = make_test_qff();
+    painter_font_handle_t font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+    EXPECT_EQ(font->line_height, 5);
+    EXPECT_EQ(qp_textwidth(font, "AB"), 6);
+
+    EXPECT_EQ(qp_drawtext(device, 1, 1, font, "AB"), 6);
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 30);
+    EXPECT_TRUE(is_white(1, 1));
+    EXPECT_TRUE(is_white(4, 5));
+    EXPECT_TRUE(is_white(6, 5));
+    EXPECT_TRUE(is_black(7, 1));
+    EXPECT_TRUE(is_black(1, 6));
+    EXPECT_TRUE(qp_close_font(font));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Animations
+
+TEST_F(QuantumPainter, AnimationFollowsFrameDelays) {
+    // Two 2x2 frames -- all white for 100ms, then all black for 50ms
+    auto qgf = make_qgf(2, 2,
+                        {
+                            {FORMAT_GRAYSCALE_1BPP, COMPRESSION_NONE, 100, {}, {0x0F}},
+                            {FORMAT_GRAYSCALE_1BPP, COMPRESSION_NONE, 50, {}, {0x00}},
+                        });
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+    EXPECT_EQ(image->frame_count, 2);
+
+    deferred_token token = qp_animate(device, 0, 0, image);
+    ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 4);
+
+    advance_time(99);
+    qp_internal_animation_tick();
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 4);
+
+    advance_time(1);
+    qp_internal_animation_tick();
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 0);
+
+    advance_time(49);
+    qp_internal_animation_tick();
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 0);
+
+    advance_time(1);
+    qp_internal_animation_tick();
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 4);
+
+    qp_stop_animation(token);
+    qp_clear(device);
+    advance_time(100);
+    qp_internal_animation_tick();
+    EXPECT_EQ(qp_mock_count_lit_pixels(device), 0);
+    EXPECT_TRUE(qp_close_image(image));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Queued rendering
+
+TEST_F(QuantumPainter, QueueMatchesImmediateRendering) {
+    auto                   qgf   = make_qgf(8, 2, {{FORMAT_GRAYSCALE_1BPP, COMPRESSION_NONE, 0, {}, {0x55, 0xAA}}});
+    auto                   qff   = make_test_qff();
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    painter_font_handle_t  font  = qp_load_font_mem(qff.data());
+    ASSERT_NE(image, nullptr);
+    ASSERT_NE(font, nullptr);
+
+    auto draw_immediate = [&]() {
+        qp_rect(device, 2, 2, 40, 30, 170, 255, 255, true);
+        qp_circle(device, 30, 20, 12, 0, 255, 255, false);
+        qp_line(device, 0, 47, 63, 0, 85, 255, 255);
+        qp_drawimage(device, 44, 4, image);
+        qp_drawtext(device, 44, 10, font, "ABBA");
+    };
+
+    draw_immediate();
+    std::vector<uint8_t> expected;
+    for (uint16_t y = 0; y < 48; ++y) {
+        for (uint16_t x = 0; x < 64; ++x) {
+            const uint8_t *px = qp_mock_get_pixel(device, x, y);
+            expected.insert(expected.end(), px, px + 3);
+        }
+    }
+
+    qp_clear(device);
+    EXPECT_TRUE(qp_queue_rect(device, 2, 2, 40, 30, 170, 255, 255, true));
+    EXPECT_TRUE(qp_queue_circle(device, 30, 20, 12, 0, 255, 255, false));
+    EXPECT_TRUE(qp_queue_line(device, 0, 47, 63, 0, 85, 255, 255));
+    EXPECT_TRUE(qp_queue_drawimage(device, 44, 4, image));
+    EXPECT_TRUE(qp_queue_drawtext(device, 44, 10, font, "ABBA"));
+    EXPECT_FALSE(qp_queue_drained());
+    qp_queue_drain();
+    EXPECT_TRUE(qp_queue_drained());
+
+    std::vector<uint8_t> actual;
+    for (uint16_t y = 0; y < 48; ++y) {
+        for (uint16_t x = 0; x < 64; ++x) {
+            const uint8_t *px = qp_mock_get_pixel(device, x, y);
+            actual.insert(actual.end(), px, px + 3);
+        }
+    }
+    EXPECT_EQ(actual, expected);
+
+    EXPECT_TRUE(qp_close_font(font));
+    EXPECT_TRUE(qp_close_image(image));
+}
+
+TEST_F(QuantumPainter, QueuedCircleAndEllipseResumeAcrossSteps) {
+    qp_circle(device, 32, 24, 20, 0, 0, 255, true);
+    qp_ellipse(device, 32, 24, 30, 8, 170, 255, 255, false);
+    std::vector<uint8_t> expected = capture();
+    qp_clear(device);
+
+    // Drawing a couple of midpoint steps at a time must give the same result as drawing the whole shape at once
+    struct qp_internal_circle_state circle = {};
+    bool                            done   = false;
+    int                             calls  = 0;
+    while (!done) {
+        ASSERT_TRUE(qp_internal_circle_incremental(&circle, device, 32, 24, 20, 0, 0, 255, true, 2, &done));
+        ++calls;
+    }
+    EXPECT_GT(calls, 1);
+
+    struct qp_internal_ellipse_state ellipse = {};
+    done                                     = false;
+    calls                                    = 0;
+    while (!done) {
+        ASSERT_TRUE(qp_internal_ellipse_incremental(&ellipse, device, 32, 24, 30, 8, 170, 255, 255, false, 2, &done));
+        ++calls;
+    }
+    EXPECT_GT(calls, 1);
+    EXPECT_EQ(capture(), expected);
+
+    // The queue splits them up the same way
+    qp_clear(device);
+    EXPECT_TRUE(qp_queue_circle(device, 32, 24, 20, 0, 0, 255, true));
+    EXPECT_TRUE(qp_queue_ellipse(device, 32, 24, 30, 8, 170, 255, 255, false));
+    qp_queue_drain();
+    EXPECT_EQ(capture(), expected);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Output
+
+TEST_F(QuantumPainter, DumpPPM) {
+    qp_setpixel(device, 0, 0, 0, 255, 255);
+    std::string filename = ::testing::TempDir() + "qp_mock_dump.ppm";
+    ASSERT_TRUE(qp_mock_dump_ppm(device, filename.c_str()));
+
+    FILE *fp = fopen(filename.c_str(), "rb");
+    ASSERT_NE(fp, nullptr);
+    char header[16] = {0};
+    ASSERT_EQ(fread(header, 1, 13, fp), 13);
+    EXPECT_STREQ(header, "P6\n64 48\n255\n");
+    uint8_t rgb[3];
+    ASSERT_EQ(fread(rgb, 1, 3, fp), 3);
+    EXPECT_EQ(rgb[0], 255);
+    EXPECT_EQ(rgb[1], 0);
+    EXPECT_EQ(rgb[2], 0);
+    fseek(fp, 0, SEEK_END);
+    EXPECT_EQ(ftell(fp), 13 + 64 * 48 * 3);
+    fclose(fp);
+    remove(filename.c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmark -- reports simulated bus cost per draw call at a 20MHz SPI clock with 1us of per-transaction overhead
+
+TEST_F(QuantumPainter, BusCostReport) {
+    auto                   qff  = make_test_qff();
+    painter_font_handle_t  font = qp_load_font_mem(qff.data());
+    auto                   qgf  = make_qgf(8, 2, {{FORMAT_GRAYSCALE_1BPP, COMPRESSION_NONE, 0, {}, {0x55, 0xAA}}});
+    painter_image_handle_t img  = qp_load_image_mem(qgf.data());
+    ASSERT_NE(font, nullptr);
+    ASSERT_NE(img, nullptr);
+
+    struct {
+        const char *name;
+        bool (*draw)(painter_device_t, painter_font_handle_t, painter_image_handle_t);
+    } cases[] = {
+        {"setpixel", [](painter_device_t d, painter_font_handle_t, painter_image_handle_t) { return qp_setpixel(d, 1, 1, 0, 0, 255); }},
+        {"line", [](painter_device_t d, painter_font_handle_t, painter_image_handle_t) { return qp_line(d, 0, 0, 63, 47, 0, 0, 255); }},
+        {"rect", [](painter_device_t d, painter_font_handle_t, painter_image_handle_t) { return qp_rect(d, 0, 0, 63, 47, 0, 0, 255, true); }},
+        {"circle", [](painter_device_t d, painter_font_handle_t, painter_image_handle_t) { return qp_circle(d, 32, 24, 20, 0, 0, 255, false); }},
+        {"circle_filled", [](painter_device_t d, painter_font_handle_t, painter_image_handle_t) { return qp_circle(d, 32, 24, 20, 0, 0, 255, true); }},
+        {"ellipse", [](painter_device_t d, painter_font_handle_t, painter_image_handle_t) { return qp_ellipse(d, 32, 24, 30, 15, 0, 0, 255, false); }},
+        {"drawimage", [](painter_device_t d, painter_font_handle_t, painter_image_handle_t i) { return qp_drawimage(d, 0, 0, i); }},
+        {"drawtext", [](painter_device_t d, painter_font_handle_t f, painter_image_handle_t) { return qp_drawtext(d, 0, 0, f, "ABABAB") > 0; }},
+    };
+
+    for (auto &c : cases) {
+        qp_clear(device);
+        qp_mock_reset_stats(device);
+        EXPECT_TRUE(c.draw(device, font, img)) << c.name;
+        qp_mock_bus_stats_t stats = qp_mock_get_stats(device);
+        EXPECT_GT(stats.bytes, 0) << c.name;
+        printf("[ QP BUS   ] %-14s %6u transactions %8u bytes %6u pixels %6u us\n", c.name, (unsigned)stats.transactions, (unsigned)stats.bytes, (unsigned)stats.pixels, (unsigned)qp_mock_bus_time_us(&stats, 20000000, 1000));
+    }
+
+    EXPECT_TRUE(qp_close_font(font));
+    EXPECT_TRUE(qp_close_image(img));
+}
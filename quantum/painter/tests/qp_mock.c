@@ -0,0 +1,253 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stdio.h>
+#include <string.h>
+
+#include "color.h"
+#include "qp_internal.h"
+#include "qp_comms.h"
+#include "qp_mock.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Mock device definition
+
+typedef struct mock_painter_device_t {
+    struct painter_driver_t base; // must be first, so it can be cast to/from the painter_device_t* type
+
+    bool powered;
+
+    // Current viewport and write cursor
+    uint16_t viewport_left;
+    uint16_t viewport_top;
+    uint16_t viewport_right;
+    uint16_t viewport_bottom;
+    uint16_t cursor_x;
+    uint16_t cursor_y;
+
+    // Bus accounting
+    qp_mock_bus_stats_t stats;
+
+    // In-memory RGB888 canvas
+    uint8_t canvas[QP_MOCK_MAX_HEIGHT][QP_MOCK_MAX_WIDTH][QP_MOCK_BYTES_PER_PIXEL];
+} mock_painter_device_t;
+
+static mock_painter_device_t mock_device;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Comms -- nothing actually leaves the host, bus traffic is accounted for in the driver callbacks below
+
+static bool qp_mock_comms_init(painter_device_t device) {
+    return true;
+}
+
+static bool qp_mock_comms_start(painter_device_t device) {
+    return true;
+}
+
+static void qp_mock_comms_stop(painter_device_t device) {}
+
+static uint32_t qp_mock_comms_send(painter_device_t device, const void *data, uint32_t byte_count) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+    mock->stats.transactions++;
+    mock->stats.bytes += byte_count;
+    return byte_count;
+}
+
+static const struct painter_comms_vtable_t mock_comms_vtable = {
+    .comms_init  = qp_mock_comms_init,
+    .comms_start = qp_mock_comms_start,
+    .comms_stop  = qp_mock_comms_stop,
+    .comms_send  = qp_mock_comms_send,
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Driver
+
+static bool qp_mock_init(painter_device_t device, painter_rotation_t rotation) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+    memset(mock->canvas, 0, sizeof(mock->canvas));
+    mock->powered = true;
+    return true;
+}
+
+static bool qp_mock_power(painter_device_t device, bool power_on) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+    mock->powered               = power_on;
+    return true;
+}
+
+static bool qp_mock_clear(painter_device_t device) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+    memset(mock->canvas, 0, sizeof(mock->canvas));
+    return true;
+}
+
+static bool qp_mock_flush(painter_device_t device) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+    mock->stats.flushes++;
+    return true;
+}
+
+static bool qp_mock_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+
+    mock->viewport_left   = left + mock->base.offset_x;
+    mock->viewport_top    = top + mock->base.offset_y;
+    mock->viewport_right  = right + mock->base.offset_x;
+    mock->viewport_bottom = bottom + mock->base.offset_y;
+    mock->cursor_x        = mock->viewport_left;
+    mock->cursor_y        = mock->viewport_top;
+
+    mock->stats.viewport_calls++;
+    mock->stats.transactions += QP_MOCK_VIEWPORT_TRANSACTIONS;
+    mock->stats.bytes += QP_MOCK_VIEWPORT_BYTES;
+    return true;
+}
+
+static bool qp_mock_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
+    mock_painter_device_t *mock   = (mock_painter_device_t *)device;
+    const uint8_t *        pixels = (const uint8_t *)pixel_data;
+
+    for (uint32_t i = 0; i < native_pixel_count; ++i) {
+        // Pixels falling outside the panel are dropped, same as real hardware
+        if (mock->cursor_x < mock->base.panel_width && mock->cursor_y < mock->base.panel_height) {
+            memcpy(mock->canvas[mock->cursor_y][mock->cursor_x], &pixels[i * QP_MOCK_BYTES_PER_PIXEL], QP_MOCK_BYTES_PER_PIXEL);
+        }
+
+        // Advance the write cursor, wrapping within the viewport
+        if (mock->cursor_x++ >= mock->viewport_right) {
+            mock->cursor_x = mock->viewport_left;
+            if (mock->cursor_y++ >= mock->viewport_bottom) {
+                mock->cursor_y = mock->viewport_top;
+            }
+        }
+    }
+
+    mock->stats.pixdata_calls++;
+    mock->stats.pixels += native_pixel_count;
+    qp_comms_send(device, pixel_data, native_pixel_count * QP_MOCK_BYTES_PER_PIXEL);
+    return true;
+}
+
+static bool qp_mock_palette_convert(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    for (int16_t i = 0; i < palette_size; ++i) {
+        RGB rgb             = hsv_to_rgb_nocie((HSV){palette[i].hsv888.h, palette[i].hsv888.s, palette[i].hsv888.v});
+        palette[i].rgb888.r = rgb.r;
+        palette[i].rgb888.g = rgb.g;
+        palette[i].rgb888.b = rgb.b;
+    }
+    return true;
+}
+
+static bool qp_mock_append_pixels(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    for (uint32_t i = 0; i < pixel_count; ++i) {
+        target_buffer[(pixel_offset + i) * 3 + 0] = palette[palette_indices[i]].rgb888.r;
+        target_buffer[(pixel_offset + i) * 3 + 1] = palette[palette_indices[i]].rgb888.g;
+        target_buffer[(pixel_offset + i) * 3 + 2] = palette[palette_indices[i]].rgb888.b;
+    }
+    return true;
+}
+
+static const struct painter_driver_vtable_t mock_driver_vtable = {
+    .init            = qp_mock_init,
+    .power           = qp_mock_power,
+    .clear           = qp_mock_clear,
+    .flush           = qp_mock_flush,
+    .pixdata         = qp_mock_pixdata,
+    .viewport        = qp_mock_viewport,
+    .palette_convert = qp_mock_palette_convert,
+    .append_pixels   = qp_mock_append_pixels,
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Factory
+
+painter_device_t qp_mock_make_device(uint16_t panel_width, uint16_t panel_height) {
+    mock_painter_device_t *mock = &mock_device;
+    memset(mock, 0, sizeof(mock_painter_device_t));
+
+    if (panel_width > QP_MOCK_MAX_WIDTH || panel_height > QP_MOCK_MAX_HEIGHT) {
+        return NULL;
+    }
+
+    mock->base.driver_vtable         = &mock_driver_vtable;
+    mock->base.comms_vtable          = &mock_comms_vtable;
+    mock->base.native_bits_per_pixel = QP_MOCK_BYTES_PER_PIXEL * 8;
+    mock->base.panel_width           = panel_width;
+    mock->base.panel_height          = panel_height;
+    mock->base.rotation              = QP_ROTATION_0;
+    mock->base.offset_x              = 0;
+    mock->base.offset_y              = 0;
+    return (painter_device_t)mock;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Canvas inspection
+
+const uint8_t *qp_mock_get_pixel(painter_device_t device, uint16_t x, uint16_t y) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+    if (x >= mock->base.panel_width || y >= mock->base.panel_height) {
+        return NULL;
+    }
+    return mock->canvas[y][x];
+}
+
+bool qp_mock_pixel_is(painter_device_t device, uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b) {
+    const uint8_t *px = qp_mock_get_pixel(device, x, y);
+    return px && px[0] == r && px[1] == g && px[2] == b;
+}
+
+uint32_t qp_mock_count_lit_pixels(painter_device_t device) {
+    mock_painter_device_t *mock  = (mock_painter_device_t *)device;
+    uint32_t               count = 0;
+    for (uint16_t y = 0; y < mock->base.panel_height; ++y) {
+        for (uint16_t x = 0; x < mock->base.panel_width; ++x) {
+            const uint8_t *px = mock->canvas[y][x];
+            if (px[0] || px[1] || px[2]) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Bus statistics
+
+void qp_mock_reset_stats(painter_device_t device) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+    memset(&mock->stats, 0, sizeof(qp_mock_bus_stats_t));
+}
+
+qp_mock_bus_stats_t qp_mock_get_stats(painter_device_t device) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+    return mock->stats;
+}
+
+uint32_t qp_mock_bus_time_us(const qp_mock_bus_stats_t *stats, uint32_t bus_hz, uint32_t transaction_overhead_ns) {
+    uint64_t bit_time_ns         = ((uint64_t)stats->bytes * 8 * 1000000000ULL) / bus_hz;
+    uint64_t transaction_time_ns = (uint64_t)stats->transactions * transaction_overhead_ns;
+    return (uint32_t)((bit_time_ns + transaction_time_ns) / 1000);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Output
+
+bool qp_mock_dump_ppm(painter_device_t device, const char *filename) {
+    mock_painter_device_t *mock = (mock_painter_device_t *)device;
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        return false;
+    }
+
+    fprintf(fp, "P6\n%d %d\n255\n", (int)mock->base.panel_width, (int)mock->base.panel_height);
+    for (uint16_t y = 0; y < mock->base.panel_height; ++y) {
+        fwrite(mock->canvas[y], QP_MOCK_BYTES_PER_PIXEL, mock->base.panel_width, fp);
+    }
+
+    bool ok = !ferror(fp);
+    fclose(fp);
+    return ok;
+}
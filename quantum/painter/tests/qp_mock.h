@@ -0,0 +1,52 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qp.h"
+
+// Maximum canvas size supported by the mock device
+#define QP_MOCK_MAX_WIDTH 320
+#define QP_MOCK_MAX_HEIGHT 240
+
+// Simulated bus cost of a viewport change, modelled on a typical SPI TFT panel: column address, row address and
+// memory write commands, plus 2x 16-bit coordinates for each of the column and row windows.
+#define QP_MOCK_VIEWPORT_TRANSACTIONS 3
+#define QP_MOCK_VIEWPORT_BYTES (3 + 4 + 4)
+
+// Native pixel size on the bus, RGB888
+#define QP_MOCK_BYTES_PER_PIXEL 3
+
+typedef struct qp_mock_bus_stats_t {
+    uint32_t transactions;   // number of distinct bus transfers
+    uint32_t bytes;          // total number of bytes sent on the bus
+    uint32_t viewport_calls; // number of viewport changes
+    uint32_t pixdata_calls;  // number of pixel data transfers
+    uint32_t pixels;         // number of pixels transferred
+    uint32_t flushes;        // number of flush requests
+} qp_mock_bus_stats_t;
+
+// Creates (or resets) the mock painter device with a black canvas of the supplied size
+painter_device_t qp_mock_make_device(uint16_t panel_width, uint16_t panel_height);
+
+// Canvas access; returns a pointer to the RGB888 triplet for the pixel, or NULL if out of bounds
+const uint8_t *qp_mock_get_pixel(painter_device_t device, uint16_t x, uint16_t y);
+
+// Returns true if the pixel at the specified location matches the supplied RGB value
+bool qp_mock_pixel_is(painter_device_t device, uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b);
+
+// Counts the number of pixels on the canvas which are not black
+uint32_t qp_mock_count_lit_pixels(painter_device_t device);
+
+// Bus statistics
+void                qp_mock_reset_stats(painter_device_t device);
+qp_mock_bus_stats_t qp_mock_get_stats(painter_device_t device);
+
+// Simulated time spent on the bus for the supplied stats, given a bus clock and a per-transaction setup overhead
+uint32_t qp_mock_bus_time_us(const qp_mock_bus_stats_t *stats, uint32_t bus_hz, uint32_t transaction_overhead_ns);
+
+// Writes the canvas out as a binary PPM (P6) file
+bool qp_mock_dump_ppm(painter_device_t device, const char *filename);
@@ -0,0 +1,23 @@
+painter_DEFS := -DQUANTUM_PAINTER_ENABLE -DQUANTUM_PAINTER_ANIMATIONS_ENABLE -DQUANTUM_PAINTER_QUEUE_ENABLE -DDEFERRED_EXEC_ENABLE
+painter_CONFIG := $(QUANTUM_PATH)/painter/tests/config_mock.h
+painter_INC := $(QUANTUM_PATH)/painter
+
+painter_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/utf8.c \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/deferred_exec.c \
+	$(QUANTUM_PATH)/painter/qp.c \
+	$(QUANTUM_PATH)/painter/qp_comms.c \
+	$(QUANTUM_PATH)/painter/qp_stream.c \
+	$(QUANTUM_PATH)/painter/qgf.c \
+	$(QUANTUM_PATH)/painter/qff.c \
+	$(QUANTUM_PATH)/painter/qp_draw_core.c \
+	$(QUANTUM_PATH)/painter/qp_draw_codec.c \
+	$(QUANTUM_PATH)/painter/qp_draw_circle.c \
+	$(QUANTUM_PATH)/painter/qp_draw_ellipse.c \
+	$(QUANTUM_PATH)/painter/qp_draw_image.c \
+	$(QUANTUM_PATH)/painter/qp_draw_text.c \
+	$(QUANTUM_PATH)/painter/qp_queue.c \
+	$(QUANTUM_PATH)/painter/tests/qp_mock.c \
+	$(QUANTUM_PATH)/painter/tests/painter_tests.cpp
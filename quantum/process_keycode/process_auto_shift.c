@@ -66,8 +66,8 @@ __attribute__((weak)) bool get_custom_auto_shifted_key(uint16_t keycode, keyreco
     return false;
 }
 
-/** \brief Called on physical press, returns whether is Auto Shift key */
-__attribute__((weak)) bool get_auto_shifted_key(uint16_t keycode, keyrecord_t *record) {
+/** \brief The default of get_auto_shifted_key(), also used in its place when it is not overridden */
+static inline bool auto_shifted_key_default(uint16_t keycode, keyrecord_t *record) {
     switch (keycode) {
 #    ifndef NO_AUTO_SHIFT_ALPHA
         case AUTO_SHIFT_ALPHA:
@@ -80,9 +80,25 @@ __attribute__((weak)) bool get_auto_shifted_key(uint16_t keycode, keyrecord_t *r
 #    endif
             return true;
     }
+#    ifdef NO_GET_CUSTOM_AUTO_SHIFTED_KEY
+    return false;
+#    else
     return get_custom_auto_shifted_key(keycode, record);
+#    endif
+}
+
+/** \brief Called on physical press, returns whether is Auto Shift key */
+__attribute__((weak)) bool get_auto_shifted_key(uint16_t keycode, keyrecord_t *record) {
+    return auto_shifted_key_default(keycode, record);
 }
 
+/* hook left at its default, see builddefs/detect_hooks.mk */
+#    ifdef NO_GET_AUTO_SHIFTED_KEY
+#        define GET_AUTO_SHIFTED_KEY(keycode, record) auto_shifted_key_default(keycode, record)
+#    else
+#        define GET_AUTO_SHIFTED_KEY(keycode, record) get_auto_shifted_key(keycode, record)
+#    endif
+
 /** \brief Called to check whether defines should apply if PER_KEY is set for it */
 __attribute__((weak)) bool get_auto_shift_repeat(uint16_t keycode, keyrecord_t *record) {
     return true;
@@ -471,7 +487,7 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
     if (!autoshift_flags.enabled) {
         return true;
     }
-    if (get_auto_shifted_key(keycode, record)) {
+    if (GET_AUTO_SHIFTED_KEY(keycode, record)) {
         if (record->event.pressed) {
             return autoshift_press(keycode, now, record);
         } else {
@@ -178,7 +178,7 @@ static inline uint16_t _get_wait_time(uint16_t combo_index, combo_t *combo) {
 }
 
 static inline uint16_t _get_combo_term(uint16_t combo_index, combo_t *combo) {
-#if defined(COMBO_TERM_PER_COMBO)
+#if defined(COMBO_TERM_PER_COMBO) && !defined(NO_GET_COMBO_TERM)
     return get_combo_term(combo_index, combo);
 #endif
 
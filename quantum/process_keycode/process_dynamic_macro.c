@@ -84,6 +84,9 @@ void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_
     layer_clear();
 
     while (macro_buffer != macro_end) {
+        /* Resolve the keycode against the layers active now, not the
+         * ones at the time the key was recorded or last played. */
+        macro_buffer->lookup.resolved = false;
         process_record(macro_buffer);
         macro_buffer += direction;
 #ifdef DYNAMIC_MACRO_DELAY
@@ -131,13 +131,16 @@ void steno_init() {
     if (!eeconfig_is_enabled()) {
         eeconfig_init();
     }
-    mode = eeprom_read_byte(EECONFIG_STENOMODE);
+    uint8_t stored_mode;
+    eeconfig_read_block(&stored_mode, EECONFIG_STENOMODE, sizeof(stored_mode));
+    mode = stored_mode;
 }
 
 void steno_set_mode(steno_mode_t new_mode) {
     steno_clear_chord();
     mode = new_mode;
-    eeprom_update_byte(EECONFIG_STENOMODE, mode);
+    uint8_t stored_mode = mode;
+    eeconfig_update_block(&stored_mode, EECONFIG_STENOMODE, sizeof(stored_mode));
 }
 #endif // STENO_ENABLE_ALL
 
@@ -15,7 +15,7 @@
  */
 
 #include "process_unicode_common.h"
-#include "eeprom.h"
+#include "eeconfig.h"
 #include "utf8.h"
 
 unicode_config_t unicode_config;
@@ -30,7 +30,7 @@ static int8_t  selected_index;
 #endif
 
 void unicode_input_mode_init(void) {
-    unicode_config.raw = eeprom_read_byte(EECONFIG_UNICODEMODE);
+    eeconfig_read_block(&unicode_config.raw, EECONFIG_UNICODEMODE, sizeof(unicode_config.raw));
 #if UNICODE_SELECTED_MODES != -1
 #    if UNICODE_CYCLE_PERSIST
     // Find input_mode in selected modes
@@ -78,7 +78,8 @@ void cycle_unicode_input_mode(int8_t offset) {
 }
 
 void persist_unicode_input_mode(void) {
-    eeprom_update_byte(EECONFIG_UNICODEMODE, unicode_config.input_mode);
+    uint8_t input_mode = unicode_config.input_mode;
+    eeconfig_update_block(&input_mode, EECONFIG_UNICODEMODE, sizeof(input_mode));
 }
 
 __attribute__((weak)) void unicode_input_start(void) {
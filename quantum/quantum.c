@@ -36,6 +36,18 @@
 #    include "haptic.h"
 #endif
 
+#ifdef WEAR_LEVELING_ENABLE
+#    include "wear_leveling.h"
+#endif
+
+#ifdef EEPROM_I2C
+#    include "eeprom_i2c.h"
+#endif
+
+#ifdef EEPROM_STM32_FLASH_EMULATED
+#    include "eeprom_stm32.h"
+#endif
+
 #ifdef AUDIO_ENABLE
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -154,6 +166,22 @@ void shutdown_quantum(void) {
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
 #endif
+#if EECONFIG_FLUSH_DELAY_MS > 0
+    // Make sure any deferred configuration changes are written out before resetting
+    eeconfig_flush();
+#endif
+#ifdef WEAR_LEVELING_ENABLE
+    // Make sure any buffered EEPROM writes hit the backing store before resetting
+    wear_leveling_flush();
+#endif
+#ifdef EEPROM_I2C
+    // Make sure any cached EEPROM writes hit the EEPROM before resetting
+    eeprom_i2c_flush();
+#endif
+#ifdef EEPROM_STM32_FLASH_EMULATED
+    // Don't reset with the emulated EEPROM flash half compacted
+    EEPROM_Flush();
+#endif
 }
 
 void reset_keyboard(void) {
@@ -166,14 +194,37 @@ void soft_reset_keyboard(void) {
     mcu_reset();
 }
 
-/* Convert record into usable keycode via the contained event. */
+/* Convert event into a keycode and the layer it was found on. */
+static uint16_t resolve_event_keycode(keyevent_t event, bool update_layer_cache, uint8_t *layer) {
+#if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
+    if (!disable_action_cache) {
+        if (event.pressed && update_layer_cache) {
+            uint16_t keycode = layer_switch_get_keycode(event.key, layer);
+            update_source_layers_cache(event.key, *layer);
+            return keycode;
+        }
+        *layer = read_source_layers_cache(event.key);
+        return keymap_key_to_keycode(*layer, event.key);
+    }
+#endif
+    return layer_switch_get_keycode(event.key, layer);
+}
+
+/* Convert record into usable keycode via the contained event. The keycode is
+ * resolved once, the first time it is asked for, and kept in the record so the
+ * tapping logic, per key callbacks and process_record handlers all share it.
+ */
 uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) {
 #ifdef COMBO_ENABLE
     if (record->keycode) {
         return record->keycode;
     }
 #endif
-    return get_event_keycode(record->event, update_layer_cache);
+    if (!record->lookup.resolved) {
+        record->lookup.keycode  = resolve_event_keycode(record->event, update_layer_cache, &record->lookup.layer);
+        record->lookup.resolved = true;
+    }
+    return record->lookup.keycode;
 }
 
 /* Convert event into usable keycode. Checks the layer cache to ensure that it
@@ -183,41 +234,38 @@ uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) {
  * from triggering properly.
  */
 uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
-#if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
-    /* TODO: Use store_or_get_action() or a similar function. */
-    if (!disable_action_cache) {
-        uint8_t layer;
-
-        if (event.pressed && update_layer_cache) {
-            layer = layer_switch_get_layer(event.key);
-            update_source_layers_cache(event.key, layer);
-        } else {
-            layer = read_source_layers_cache(event.key);
-        }
-        return keymap_key_to_keycode(layer, event.key);
-    } else
-#endif
-        return keymap_key_to_keycode(layer_switch_get_layer(event.key), event.key);
+    uint8_t layer;
+    return resolve_event_keycode(event, update_layer_cache, &layer);
 }
 
 /* Get keycode, and then process pre tapping functionality */
 bool pre_process_record_quantum(keyrecord_t *record) {
-    if (!(
 #ifdef COMBO_ENABLE
-            process_combo(get_record_keycode(record, true), record) &&
-#endif
-            true)) {
+    bool process = process_combo(get_record_keycode(record, true), record);
+    // The tapping logic may still hold the record back while layers change,
+    // so it is resolved again once it is actually processed
+    record->lookup.resolved = false;
+    if (!process) {
         return false;
     }
+#endif
     return true; // continue processing
 }
 
 /* Get keycode, and then call keyboard function */
 void post_process_record_quantum(keyrecord_t *record) {
+#if !defined(NO_POST_PROCESS_RECORD_KB) || !defined(NO_POST_PROCESS_RECORD_USER)
     uint16_t keycode = get_record_keycode(record, false);
     post_process_record_kb(keycode, record);
+#endif
 }
 
+/* Handlers wrapped in these only act on keycodes of their own range, and
+   are skipped for every other keycode, so that a plain keypress only calls
+   the handlers that look at all keys. The order of the chain is kept.   */
+#define IS_QUANTUM_KEYCODE(code) (QK_BOOTLOADER <= (code) && (code) < QK_MOD_TAP)
+#define IS_STENO_KEYCODE(code) (QK_STENO <= (code) && (code) <= QK_STENO_MAX)
+
 /* Core keycode function, hands off handling to other functions,
     then processes internal quantum keycodes, and then processes
     ACTIONs.                                                      */
@@ -270,26 +318,28 @@ bool process_record_quantum(keyrecord_t *record) {
             process_haptic(keycode, record) &&
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_record_via(keycode, record)) &&
 #endif
+#if !defined(NO_PROCESS_RECORD_KB) || !defined(NO_PROCESS_RECORD_USER)
             process_record_kb(keycode, record) &&
+#endif
 #if defined(SECURE_ENABLE)
             process_secure(keycode, record) &&
 #endif
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_sequencer(keycode, record)) &&
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_midi(keycode, record)) &&
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_audio(keycode, record)) &&
 #endif
 #if defined(BACKLIGHT_ENABLE) || defined(LED_MATRIX_ENABLE)
-            process_backlight(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_backlight(keycode, record)) &&
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+            (!IS_STENO_KEYCODE(keycode) || process_steno(keycode, record)) &&
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
             process_music(keycode, record) &&
@@ -316,25 +366,25 @@ bool process_record_quantum(keyrecord_t *record) {
             process_auto_shift(keycode, record) &&
 #endif
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
-            process_dynamic_tapping_term(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_dynamic_tapping_term(keycode, record)) &&
 #endif
 #ifdef SPACE_CADET_ENABLE
             process_space_cadet(keycode, record) &&
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_magic(keycode, record)) &&
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_grave_esc(keycode, record)) &&
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_rgb(keycode, record)) &&
 #endif
 #ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_joystick(keycode, record)) &&
 #endif
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-            process_programmable_button(keycode, record) &&
+            (!IS_QUANTUM_KEYCODE(keycode) || process_programmable_button(keycode, record)) &&
 #endif
             true)) {
         return false;
@@ -445,7 +495,9 @@ void matrix_init_quantum() {
     matrix_init_kb();
 }
 void matrix_scan_quantum() {
+#if !defined(NO_MATRIX_SCAN_KB) || !defined(NO_MATRIX_SCAN_USER)
     matrix_scan_kb();
+#endif
 }
 
 //------------------------------------------------------------------------------
@@ -458,6 +510,22 @@ __attribute__((weak)) void shutdown_user() {}
 
 void suspend_power_down_quantum(void) {
     suspend_power_down_kb();
+#if EECONFIG_FLUSH_DELAY_MS > 0
+    // Power may be removed while suspended, so write out deferred configuration changes
+    eeconfig_flush();
+#endif
+#ifdef WEAR_LEVELING_ENABLE
+    // Power may be removed while suspended, so don't leave any EEPROM writes buffered
+    wear_leveling_flush();
+#endif
+#ifdef EEPROM_I2C
+    // Power may be removed while suspended, so don't leave any EEPROM writes cached
+    eeprom_i2c_flush();
+#endif
+#ifdef EEPROM_STM32_FLASH_EMULATED
+    // Power may be removed while suspended, so finish any background compaction
+    EEPROM_Flush();
+#endif
 #ifndef NO_SUSPEND_POWER_DOWN
 // Turn off backlight
 #    ifdef BACKLIGHT_ENABLE
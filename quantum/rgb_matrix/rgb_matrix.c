@@ -447,8 +447,12 @@ void rgb_matrix_task(void) {
 }
 
 void rgb_matrix_indicators(void) {
+#ifndef NO_RGB_MATRIX_INDICATORS_KB
     rgb_matrix_indicators_kb();
+#endif
+#ifndef NO_RGB_MATRIX_INDICATORS_USER
     rgb_matrix_indicators_user();
+#endif
 }
 
 __attribute__((weak)) void rgb_matrix_indicators_kb(void) {}
@@ -456,21 +460,27 @@ __attribute__((weak)) void rgb_matrix_indicators_kb(void) {}
 __attribute__((weak)) void rgb_matrix_indicators_user(void) {}
 
 void rgb_matrix_indicators_advanced(effect_params_t *params) {
+#if !defined(NO_RGB_MATRIX_INDICATORS_ADVANCED_KB) || !defined(NO_RGB_MATRIX_INDICATORS_ADVANCED_USER)
     /* special handling is needed for "params->iter", since it's already been incremented.
      * Could move the invocations to rgb_task_render, but then it's missing a few checks
      * and not sure which would be better. Otherwise, this should be called from
      * rgb_task_render, right before the iter++ line.
      */
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#    if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
     uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * (params->iter - 1);
     uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;
     if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
-#else
+#    else
     uint8_t min = 0;
     uint8_t max = DRIVER_LED_TOTAL;
-#endif
+#    endif
+#    ifndef NO_RGB_MATRIX_INDICATORS_ADVANCED_KB
     rgb_matrix_indicators_advanced_kb(min, max);
+#    endif
+#    ifndef NO_RGB_MATRIX_INDICATORS_ADVANCED_USER
     rgb_matrix_indicators_advanced_user(min, max);
+#    endif
+#endif
 }
 
 __attribute__((weak)) void rgb_matrix_indicators_advanced_kb(uint8_t led_min, uint8_t led_max) {}
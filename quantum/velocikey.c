@@ -14,14 +14,14 @@
 uint8_t typing_speed = 0;
 
 bool velocikey_enabled(void) {
-    return eeprom_read_byte(EECONFIG_VELOCIKEY) == 1;
+    uint8_t enabled;
+    eeconfig_read_block(&enabled, EECONFIG_VELOCIKEY, sizeof(enabled));
+    return enabled == 1;
 }
 
 void velocikey_toggle(void) {
-    if (velocikey_enabled())
-        eeprom_update_byte(EECONFIG_VELOCIKEY, 0);
-    else
-        eeprom_update_byte(EECONFIG_VELOCIKEY, 1);
+    uint8_t enabled = velocikey_enabled() ? 0 : 1;
+    eeconfig_update_block(&enabled, EECONFIG_VELOCIKEY, sizeof(enabled));
 }
 
 void velocikey_accelerate(void) {
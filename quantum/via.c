@@ -51,6 +51,7 @@
 #include "eeprom.h"
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 #include "via_ensure_keycode.h"
+#include <string.h>
 
 // Forward declare some helpers.
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
@@ -78,7 +79,9 @@ bool via_eeprom_is_valid(void) {
     uint8_t magic1 = ((p[5] & 0x0F) << 4) | (p[6] & 0x0F);
     uint8_t magic2 = ((p[8] & 0x0F) << 4) | (p[9] & 0x0F);
 
-    return (eeprom_read_byte((void *)VIA_EEPROM_MAGIC_ADDR + 0) == magic0 && eeprom_read_byte((void *)VIA_EEPROM_MAGIC_ADDR + 1) == magic1 && eeprom_read_byte((void *)VIA_EEPROM_MAGIC_ADDR + 2) == magic2);
+    uint8_t magic[3];
+    eeconfig_read_block(magic, (void *)VIA_EEPROM_MAGIC_ADDR, sizeof(magic));
+    return (magic[0] == magic0 && magic[1] == magic1 && magic[2] == magic2);
 }
 
 // Sets VIA/keyboard level usage of EEPROM to valid/invalid
@@ -89,9 +92,13 @@ void via_eeprom_set_valid(bool valid) {
     uint8_t magic1 = ((p[5] & 0x0F) << 4) | (p[6] & 0x0F);
     uint8_t magic2 = ((p[8] & 0x0F) << 4) | (p[9] & 0x0F);
 
-    eeprom_update_byte((void *)VIA_EEPROM_MAGIC_ADDR + 0, valid ? magic0 : 0xFF);
-    eeprom_update_byte((void *)VIA_EEPROM_MAGIC_ADDR + 1, valid ? magic1 : 0xFF);
-    eeprom_update_byte((void *)VIA_EEPROM_MAGIC_ADDR + 2, valid ? magic2 : 0xFF);
+    uint8_t magic[3] = {valid ? magic0 : 0xFF, valid ? magic1 : 0xFF, valid ? magic2 : 0xFF};
+    if (!valid) {
+        // Invalidation guards the direct EEPROM writes that follow, so it has
+        // to reach EEPROM now rather than wait for the eeconfig image flush
+        eeprom_update_block(magic, (void *)VIA_EEPROM_MAGIC_ADDR, sizeof(magic));
+    }
+    eeconfig_update_block(magic, (void *)VIA_EEPROM_MAGIC_ADDR, sizeof(magic));
 }
 
 // Override this at the keyboard code level to check
@@ -132,13 +139,13 @@ void eeconfig_init_via(void) {
 // This is generalized so the layout options EEPROM usage can be
 // variable, between 1 and 4 bytes.
 uint32_t via_get_layout_options(void) {
+    uint8_t buf[VIA_EEPROM_LAYOUT_OPTIONS_SIZE];
+    eeconfig_read_block(buf, (void *)(VIA_EEPROM_LAYOUT_OPTIONS_ADDR), sizeof(buf));
     uint32_t value = 0;
     // Start at the most significant byte
-    void *source = (void *)(VIA_EEPROM_LAYOUT_OPTIONS_ADDR);
     for (uint8_t i = 0; i < VIA_EEPROM_LAYOUT_OPTIONS_SIZE; i++) {
         value = value << 8;
-        value |= eeprom_read_byte(source);
-        source++;
+        value |= buf[i];
     }
     return value;
 }
@@ -147,13 +154,13 @@ __attribute__((weak)) void via_set_layout_options_kb(uint32_t value) {}
 
 void via_set_layout_options(uint32_t value) {
     via_set_layout_options_kb(value);
+    uint8_t buf[VIA_EEPROM_LAYOUT_OPTIONS_SIZE];
     // Start at the least significant byte
-    void *target = (void *)(VIA_EEPROM_LAYOUT_OPTIONS_ADDR + VIA_EEPROM_LAYOUT_OPTIONS_SIZE - 1);
-    for (uint8_t i = 0; i < VIA_EEPROM_LAYOUT_OPTIONS_SIZE; i++) {
-        eeprom_update_byte(target, value & 0xFF);
-        value = value >> 8;
-        target--;
+    for (uint8_t i = VIA_EEPROM_LAYOUT_OPTIONS_SIZE; i > 0; i--) {
+        buf[i - 1] = value & 0xFF;
+        value      = value >> 8;
     }
+    eeconfig_update_block(buf, (void *)(VIA_EEPROM_LAYOUT_OPTIONS_ADDR), sizeof(buf));
 }
 
 // Called by QMK core to process VIA-specific keycodes.
@@ -195,6 +202,283 @@ bool process_record_via(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+#ifdef VIA_STREAM_ENABLE
+_Static_assert(VIA_STREAM_WINDOW > 0 && VIA_STREAM_WINDOW < 128, "VIA_STREAM_WINDOW must be between 1 and 127");
+
+// Raw HID packets are RAW_EPSIZE, 32 bytes on every platform
+#    define VIA_STREAM_PACKET_SIZE 32
+
+enum via_stream_mode {
+    VIA_STREAM_IDLE,
+    VIA_STREAM_READING,
+    VIA_STREAM_WRITING,
+};
+
+static struct {
+    uint8_t  mode;
+    uint8_t  region;
+    uint8_t  payload;
+    bool     gap_reported;
+    uint16_t offset;
+    uint16_t length;
+    uint16_t packets;
+    uint16_t next_packet;
+    uint16_t send_packet; // next data packet of the current window to send, from via_task()
+    uint16_t send_end;
+    uint16_t last_send;
+    uint16_t staged_offset;
+    uint16_t staged_length;
+} via_stream;
+
+static uint8_t via_stream_buffer[VIA_STREAM_BUFFER_SIZE];
+
+static uint16_t via_stream_region_size(uint8_t region) {
+    switch (region) {
+        case id_stream_region_keymap:
+            return dynamic_keymap_get_buffer_size();
+        case id_stream_region_macros:
+            return dynamic_keymap_macro_get_buffer_size();
+        default:
+            return 0;
+    }
+}
+
+static void via_stream_region_read(uint8_t region, uint16_t offset, uint16_t size, uint8_t *data) {
+    if (region == id_stream_region_keymap) {
+        dynamic_keymap_get_buffer(offset, size, data);
+    } else {
+        dynamic_keymap_macro_get_buffer(offset, size, data);
+    }
+}
+
+static void via_stream_region_write(uint8_t region, uint16_t offset, uint16_t size, uint8_t *data) {
+    if (region == id_stream_region_keymap) {
+        dynamic_keymap_set_buffer(offset, size, data);
+    } else {
+        dynamic_keymap_macro_set_buffer(offset, size, data);
+    }
+}
+
+static bool via_stream_range_valid(uint8_t region, uint16_t offset, uint16_t length) {
+    uint16_t size = via_stream_region_size(region);
+    return size > 0 && offset <= size && length <= size - offset;
+}
+
+// CRC-16/CCITT-FALSE, as commonly available to host applications
+static uint16_t via_stream_checksum(uint8_t region, uint16_t offset, uint16_t length) {
+    uint16_t crc = 0xFFFF;
+    uint8_t  chunk[32];
+    while (length > 0) {
+        uint16_t count = length < sizeof(chunk) ? length : sizeof(chunk);
+        via_stream_region_read(region, offset, count, chunk);
+        for (uint8_t i = 0; i < count; i++) {
+            crc ^= (uint16_t)chunk[i] << 8;
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+            }
+        }
+        offset += count;
+        length -= count;
+    }
+    return crc;
+}
+
+static void via_stream_flush(void) {
+    if (via_stream.staged_length > 0) {
+        via_stream_region_write(via_stream.region, via_stream.staged_offset, via_stream.staged_length, via_stream_buffer);
+        via_stream.staged_length = 0;
+    }
+}
+
+// Appends written data to the staging buffer, writing it out once it can no longer be extended
+static void via_stream_stage(uint16_t offset, uint8_t *data, uint8_t size) {
+    if (via_stream.staged_length > 0 && (offset != via_stream.staged_offset + via_stream.staged_length || via_stream.staged_length + size > VIA_STREAM_BUFFER_SIZE)) {
+        via_stream_flush();
+    }
+    if (size > VIA_STREAM_BUFFER_SIZE) {
+        via_stream_region_write(via_stream.region, offset, size, data);
+        return;
+    }
+    if (via_stream.staged_length == 0) {
+        via_stream.staged_offset = offset;
+    }
+    memcpy(&via_stream_buffer[via_stream.staged_length], data, size);
+    via_stream.staged_length += size;
+}
+
+// Starts a transfer, returning the stream status
+static uint8_t via_stream_begin(uint8_t mode, uint8_t *command_data, uint8_t length) {
+    uint8_t  region = command_data[1];
+    uint16_t offset = (command_data[2] << 8) | command_data[3];
+    uint16_t size   = (command_data[4] << 8) | command_data[5];
+
+    via_stream_flush();
+    via_stream.mode        = VIA_STREAM_IDLE;
+    via_stream.send_packet = 0;
+    via_stream.send_end    = 0;
+    if (length <= 3 || length > VIA_STREAM_PACKET_SIZE || !via_stream_range_valid(region, offset, size)) {
+        return id_stream_error_range;
+    }
+
+    via_stream.mode          = mode;
+    via_stream.region        = region;
+    via_stream.payload       = length - 3;
+    via_stream.gap_reported  = false;
+    via_stream.offset        = offset;
+    via_stream.length        = size;
+    via_stream.packets       = (size + via_stream.payload - 1) / via_stream.payload;
+    via_stream.next_packet   = 0;
+    via_stream.staged_length = 0;
+    return id_stream_ok;
+}
+
+static uint8_t via_stream_packet_size(uint16_t packet) {
+    uint16_t start = packet * via_stream.payload;
+    return (via_stream.length - start < via_stream.payload) ? via_stream.length - start : via_stream.payload;
+}
+
+// Queues a window of data packets, starting at the given packet, for via_task() to send
+static void via_stream_send_window(uint16_t packet) {
+    uint16_t end = packet + VIA_STREAM_WINDOW;
+    if (end > via_stream.packets) {
+        end = via_stream.packets;
+    }
+    via_stream.send_packet = packet;
+    via_stream.send_end    = end;
+    via_stream.next_packet = end;
+}
+
+// Sends the next queued data packet. Sending the whole window at once would
+// block the main loop on ChibiOS, and lose most of it on LUFA's single bank
+// endpoint, so it goes out one packet per call.
+void via_task(void) {
+    if (via_stream.mode != VIA_STREAM_READING || via_stream.send_packet >= via_stream.send_end || timer_elapsed(via_stream.last_send) < VIA_STREAM_SEND_INTERVAL) {
+        return;
+    }
+    uint8_t  length = via_stream.payload + 3;
+    uint16_t packet = via_stream.send_packet++;
+    uint8_t  data[VIA_STREAM_PACKET_SIZE];
+    memset(data, 0, length);
+    data[0] = id_bulk_stream;
+    data[1] = id_stream_data;
+    data[2] = packet & 0xFF;
+    via_stream_region_read(via_stream.region, via_stream.offset + packet * via_stream.payload, via_stream_packet_size(packet), &data[3]);
+    raw_hid_send(data, length);
+    via_stream.last_send = timer_read();
+}
+
+// Maps an 8-bit sequence number onto the packets sent so far
+static uint16_t via_stream_resolve_seq(uint8_t seq) {
+    return via_stream.next_packet - (uint8_t)(via_stream.next_packet - seq);
+}
+
+// Handles id_bulk_stream, returning whether the (modified) packet should be sent back
+static bool via_stream_receive(uint8_t *data, uint8_t length) {
+    uint8_t *command_data = &(data[1]);
+    uint8_t *reply        = &(data[2]);
+
+    switch (command_data[0]) {
+        case id_stream_info: {
+            uint16_t size = via_stream_region_size(command_data[1]);
+            reply[0]      = size > 0 ? id_stream_ok : id_stream_error_range;
+            reply[1]      = size >> 8;
+            reply[2]      = size & 0xFF;
+            reply[3]      = length - 3;
+            reply[4]      = VIA_STREAM_WINDOW;
+            return true;
+        }
+        case id_stream_checksum: {
+            uint8_t  region = command_data[1];
+            uint16_t offset = (command_data[2] << 8) | command_data[3];
+            uint16_t size   = (command_data[4] << 8) | command_data[5];
+            via_stream_flush();
+            if (!via_stream_range_valid(region, offset, size)) {
+                reply[0] = id_stream_error_range;
+                return true;
+            }
+            uint16_t crc = via_stream_checksum(region, offset, size);
+            reply[0]     = id_stream_ok;
+            reply[1]     = crc >> 8;
+            reply[2]     = crc & 0xFF;
+            return true;
+        }
+        case id_stream_read: {
+            uint8_t status = via_stream_begin(VIA_STREAM_READING, command_data, length);
+            if (status != id_stream_ok) {
+                reply[0] = status;
+                return true;
+            }
+            via_stream_send_window(0);
+            return false;
+        }
+        case id_stream_ack: {
+            if (via_stream.mode != VIA_STREAM_READING) {
+                reply[0] = id_stream_error_state;
+                return true;
+            }
+            uint16_t packet = via_stream_resolve_seq(command_data[1]);
+            if (packet >= via_stream.packets) {
+                via_stream.mode = VIA_STREAM_IDLE;
+                reply[0]        = id_stream_ok;
+                return true;
+            }
+            via_stream_send_window(packet);
+            return false;
+        }
+        case id_stream_write: {
+            uint8_t status = via_stream_begin(VIA_STREAM_WRITING, command_data, length);
+            reply[0]       = status;
+            reply[1]       = length - 3;
+            reply[2]       = VIA_STREAM_WINDOW;
+            return true;
+        }
+        case id_stream_data: {
+            uint8_t seq = command_data[1];
+            if (via_stream.mode != VIA_STREAM_WRITING) {
+                reply[0] = via_stream.next_packet & 0xFF;
+                reply[1] = id_stream_error_state;
+            } else if (seq != (via_stream.next_packet & 0xFF) || via_stream.next_packet >= via_stream.packets) {
+                // Only report each gap once, the host resends everything from the expected packet
+                if (via_stream.gap_reported) {
+                    return false;
+                }
+                via_stream.gap_reported = true;
+                reply[0]                = via_stream.next_packet & 0xFF;
+                reply[1]                = id_stream_error_sequence;
+            } else {
+                uint16_t packet = via_stream.next_packet++;
+                via_stream_stage(via_stream.offset + packet * via_stream.payload, &data[3], via_stream_packet_size(packet));
+                via_stream.gap_reported = false;
+                if (via_stream.next_packet % VIA_STREAM_WINDOW != 0 && via_stream.next_packet != via_stream.packets) {
+                    return false;
+                }
+                reply[0] = via_stream.next_packet & 0xFF;
+                reply[1] = id_stream_ok;
+            }
+            command_data[0] = id_stream_ack;
+            return true;
+        }
+        case id_stream_commit: {
+            if (via_stream.mode != VIA_STREAM_WRITING || via_stream.next_packet != via_stream.packets) {
+                reply[0] = id_stream_error_state;
+                return true;
+            }
+            via_stream_flush();
+            via_stream.mode = VIA_STREAM_IDLE;
+            uint16_t crc    = via_stream_checksum(via_stream.region, via_stream.offset, via_stream.length);
+            reply[0]        = id_stream_ok;
+            reply[1]        = crc >> 8;
+            reply[2]        = crc & 0xFF;
+            return true;
+        }
+        default: {
+            *data = id_unhandled;
+            return true;
+        }
+    }
+}
+#endif
+
 // Keyboard level code can override this to handle custom messages from VIA.
 // See raw_hid_receive() implementation.
 // DO NOT call raw_hid_send() in the override function.
@@ -242,16 +526,10 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
                     uint8_t i = 1;
                     for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
                         matrix_row_t value = matrix_get_row(row);
-#    if (MATRIX_COLS > 24)
-                        command_data[i++] = (value >> 24) & 0xFF;
-#    endif
-#    if (MATRIX_COLS > 16)
-                        command_data[i++] = (value >> 16) & 0xFF;
-#    endif
-#    if (MATRIX_COLS > 8)
-                        command_data[i++] = (value >> 8) & 0xFF;
-#    endif
-                        command_data[i++] = value & 0xFF;
+                        // most significant byte first, as many bytes as the columns need
+                        for (int8_t shift = ((MATRIX_COLS - 1) / 8) * 8; shift >= 0; shift -= 8) {
+                            command_data[i++] = (value >> shift) & 0xFF;
+                        }
                     }
 #endif
                     break;
@@ -397,6 +675,14 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             dynamic_keymap_set_buffer(offset, size, &command_data[3]);
             break;
         }
+#ifdef VIA_STREAM_ENABLE
+        case id_bulk_stream: {
+            if (!via_stream_receive(data, length)) {
+                return;
+            }
+            break;
+        }
+#endif
 #ifdef ENCODER_MAP_ENABLE
         case id_dynamic_keymap_get_encoder: {
             uint16_t keycode = dynamic_keymap_get_encoder(command_data[0], command_data[1], command_data[2] != 0);
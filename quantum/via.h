@@ -56,8 +56,28 @@
 
 #define VIA_EEPROM_CONFIG_END (VIA_EEPROM_CUSTOM_CONFIG_ADDR + VIA_EEPROM_CUSTOM_CONFIG_SIZE)
 
-// This is changed only when the command IDs change,
-// so VIA Configurator can detect compatible firmware.
+// Number of stream packets sent or received between acknowledgements
+#ifndef VIA_STREAM_WINDOW
+#    define VIA_STREAM_WINDOW 8
+#endif
+
+// Minimum time in milliseconds between two streamed data packets. LUFA drops
+// packets sent while the previous one has not been collected by the host yet,
+// which takes up to one 1ms USB frame.
+#ifndef VIA_STREAM_SEND_INTERVAL
+#    define VIA_STREAM_SEND_INTERVAL 2
+#endif
+
+// RAM used to coalesce streamed writes into larger EEPROM updates.
+// Sizing this to the whole keymap makes a streamed upload a single update.
+#ifndef VIA_STREAM_BUFFER_SIZE
+#    define VIA_STREAM_BUFFER_SIZE 128
+#endif
+
+// This is changed only when existing command IDs change, so VIA Configurator
+// can detect compatible firmware. Optional commands added since, such as
+// id_bulk_stream, are probed for instead: firmware without them replies
+// id_unhandled.
 #define VIA_PROTOCOL_VERSION 0x000A
 
 enum via_command_id {
@@ -82,9 +102,55 @@ enum via_command_id {
     id_dynamic_keymap_set_buffer            = 0x13,
     id_dynamic_keymap_get_encoder           = 0x14,
     id_dynamic_keymap_set_encoder           = 0x15,
+    id_bulk_stream                          = 0x16,
     id_unhandled                            = 0xFF,
 };
 
+// Streaming transfers of the dynamic keymap and macro buffers.
+//
+// Every packet starts with id_bulk_stream and a via_stream_command.
+// Streaming is only built with VIA_STREAM_ENABLE = yes. Firmware without it
+// replies id_unhandled, so hosts can probe for it and fall back to
+// id_dynamic_keymap_get_buffer/set_buffer.
+//
+//   info       host: region                   reply: status, size (BE16), payload size, window
+//   checksum   host: region, offset, length   reply: status, CRC-16/CCITT-FALSE (BE16)
+//   read       host: region, offset, length   reply: up to window data packets, or status on error
+//   ack        host: seq                      reply: next window of data packets, or status when done
+//
+// Data packets of a read are sent from via_task(), one per call and at least
+// VIA_STREAM_SEND_INTERVAL apart, rather than all at once from the command.
+//   write      host: region, offset, length   reply: status, payload size, window
+//   data       host: seq, payload             reply: ack (seq, status) after each window or on a gap
+//   commit     host: -                        reply: status, CRC-16 of the written range (BE16)
+//
+// Data packets carry the packet sequence number (modulo 256) followed by
+// length - 3 bytes of payload. Acknowledgements carry the sequence number of
+// the next packet expected; any packets after a gap are resent from there.
+// Writes are staged and coalesced into as few EEPROM updates as possible,
+// the final update happens on commit.
+enum via_stream_command {
+    id_stream_info     = 0x01,
+    id_stream_checksum = 0x02,
+    id_stream_read     = 0x03,
+    id_stream_ack      = 0x04,
+    id_stream_write    = 0x05,
+    id_stream_data     = 0x06,
+    id_stream_commit   = 0x07,
+};
+
+enum via_stream_region {
+    id_stream_region_keymap = 0x00,
+    id_stream_region_macros = 0x01,
+};
+
+enum via_stream_status {
+    id_stream_ok             = 0x00,
+    id_stream_error_range    = 0x01,
+    id_stream_error_state    = 0x02,
+    id_stream_error_sequence = 0x03,
+};
+
 enum via_keyboard_value_id {
     id_uptime              = 0x01, //
     id_layout_options      = 0x02,
@@ -160,6 +226,9 @@ void via_eeprom_set_valid(bool valid);
 void eeconfig_init_via(void);
 void via_init(void);
 
+// Called by QMK core every loop with VIA_STREAM_ENABLE, sends the pending streamed data packets
+void via_task(void);
+
 // Used by VIA to store and retrieve the layout options.
 uint32_t via_get_layout_options(void);
 void     via_set_layout_options(uint32_t value);
@@ -14,9 +14,12 @@ void MockBackingStore::reset_instance() {
 
     locked = true;
 
-    backing_erasure_count     = 0;
-    backing_max_write_count   = 0;
-    backing_total_write_count = 0;
+    backing_erasure_count         = 0;
+    backing_range_erasure_count   = 0;
+    backing_range_erased_elements = 0;
+    backing_max_write_count       = 0;
+    backing_total_write_count     = 0;
+    backing_total_read_count      = 0;
 
     backing_init_invoke_count   = 0;
     backing_unlock_invoke_count = 0;
@@ -24,6 +27,9 @@ void MockBackingStore::reset_instance() {
     backing_write_invoke_count  = 0;
     backing_lock_invoke_count   = 0;
 
+    backing_read_invoke_count      = 0;
+    backing_read_bulk_invoke_count = 0;
+
     init_success_callback   = [](std::uint64_t) { return true; };
     erase_success_callback  = [](std::uint64_t) { return true; };
     unlock_success_callback = [](std::uint64_t) { return true; };
@@ -33,6 +39,23 @@ void MockBackingStore::reset_instance() {
     write_log.clear();
 }
 
+void MockBackingStore::reset_counts() {
+    backing_erasure_count         = 0;
+    backing_range_erasure_count   = 0;
+    backing_range_erased_elements = 0;
+    backing_total_write_count     = 0;
+    backing_total_read_count      = 0;
+
+    backing_init_invoke_count   = 0;
+    backing_unlock_invoke_count = 0;
+    backing_erase_invoke_count  = 0;
+    backing_write_invoke_count  = 0;
+    backing_lock_invoke_count   = 0;
+
+    backing_read_invoke_count      = 0;
+    backing_read_bulk_invoke_count = 0;
+}
+
 bool MockBackingStore::init(void) {
     ++backing_init_invoke_count;
 
@@ -75,6 +98,28 @@ bool MockBackingStore::erase(void) {
     return true;
 }
 
+bool MockBackingStore::erase_range(uint32_t address, uint32_t length) {
+    ++backing_erase_invoke_count;
+
+    EXPECT_TRUE(address % BACKING_STORE_WRITE_SIZE == 0 && length % BACKING_STORE_WRITE_SIZE == 0) << "Supplied range was not aligned with the backing store integral size";
+    EXPECT_TRUE(address + length <= WEAR_LEVELING_BACKING_SIZE) << "Range would result of out-of-bounds access";
+    EXPECT_FALSE(is_locked()) << "Erase was attempted without being unlocked first";
+
+    // Erase each slot in the range
+    for (std::size_t i = address / BACKING_STORE_WRITE_SIZE; i < (address + length) / BACKING_STORE_WRITE_SIZE; ++i) {
+        // Drop out of erase early with failure if we need to, leaving the range partially erased
+        if (erase_success_callback && !erase_success_callback(backing_erase_invoke_count)) {
+            return false;
+        }
+
+        backing_storage[i].erase();
+        ++backing_range_erased_elements;
+    }
+
+    ++backing_range_erasure_count;
+    return true;
+}
+
 bool MockBackingStore::write(uint32_t address, backing_store_int_t value) {
     ++backing_write_invoke_count;
 
@@ -114,6 +159,21 @@ bool MockBackingStore::lock(void) {
 }
 
 bool MockBackingStore::read(uint32_t address, backing_store_int_t& value) const {
+    ++backing_read_invoke_count;
+    return read_element(address, value);
+}
+
+bool MockBackingStore::read_bulk(uint32_t address, backing_store_int_t* values, std::size_t item_count) const {
+    ++backing_read_bulk_invoke_count;
+    for (std::size_t i = 0; i < item_count; ++i) {
+        if (!read_element(address + (i * BACKING_STORE_WRITE_SIZE), values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MockBackingStore::read_element(uint32_t address, backing_store_int_t& value) const {
     // precondition: value's buffer size already matches BACKING_STORE_WRITE_SIZE
     EXPECT_TRUE(address % BACKING_STORE_WRITE_SIZE == 0) << "Supplied address was not aligned with the backing store integral size";
     EXPECT_TRUE(address + BACKING_STORE_WRITE_SIZE <= WEAR_LEVELING_BACKING_SIZE) << "Address would result of out-of-bounds access";
@@ -122,6 +182,9 @@ bool MockBackingStore::read(uint32_t address, backing_store_int_t& value) const
     std::size_t index = address / BACKING_STORE_WRITE_SIZE;
     value             = ~backing_storage[index].get();
 
+    // Keep track of the total number of reads from the backing store
+    ++backing_total_read_count;
+
     return true;
 }
 
@@ -141,6 +204,10 @@ extern "C" bool backing_store_erase(void) {
     return MockBackingStore::Instance().erase();
 }
 
+extern "C" bool backing_store_erase_range(uint32_t address, uint32_t length) {
+    return MockBackingStore::Instance().erase_range(address, length);
+}
+
 extern "C" bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return MockBackingStore::Instance().write(address, value);
 }
@@ -152,3 +219,7 @@ extern "C" bool backing_store_lock(void) {
 extern "C" bool backing_store_read(uint32_t address, backing_store_int_t* value) {
     return MockBackingStore::Instance().read(address, *value);
 }
+
+extern "C" bool backing_store_read_bulk(uint32_t address, backing_store_int_t* values, size_t item_count) {
+    return MockBackingStore::Instance().read_bulk(address, values, item_count);
+}
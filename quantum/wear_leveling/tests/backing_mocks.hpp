@@ -27,18 +27,21 @@ class MockBackingStoreElement {
     backing_store_int_t value;
     std::size_t         writes;
     std::size_t         erases;
+    std::size_t         erase_cycles;
 
    public:
-    MockBackingStoreElement() : value(BACKING_STORE_INTEGRAL_COMPLEMENT::value), writes(0), erases(0) {}
+    MockBackingStoreElement() : value(BACKING_STORE_INTEGRAL_COMPLEMENT::value), writes(0), erases(0), erase_cycles(0) {}
     void reset() {
         erase();
-        writes = 0;
-        erases = 0;
+        writes       = 0;
+        erases       = 0;
+        erase_cycles = 0;
     }
     void erase() {
         if (!is_erased()) {
             ++erases;
         }
+        ++erase_cycles;
         value = BACKING_STORE_INTEGRAL_COMPLEMENT::value;
     }
     backing_store_int_t get() const {
@@ -55,6 +58,9 @@ class MockBackingStoreElement {
     std::size_t num_erases() const {
         return erases;
     }
+    std::size_t num_erase_cycles() const {
+        return erase_cycles;
+    }
     bool is_erased() const {
         return value == BACKING_STORE_INTEGRAL_COMPLEMENT::value;
     }
@@ -83,19 +89,27 @@ class MockBackingStore {
     storage_t backing_storage;
     // The number of erase cycles that have occurred
     std::uint64_t backing_erasure_count;
+    // The number of partial erases that have occurred
+    std::uint64_t backing_range_erasure_count;
+    // The total number of elements erased by partial erases
+    std::uint64_t backing_range_erased_elements;
     // The max number of writes to an element of the backing store
     std::uint64_t backing_max_write_count;
     // The total number of writes to all elements of the backing store
     std::uint64_t backing_total_write_count;
+    // The total number of elements read from the backing store
+    mutable std::uint64_t backing_total_read_count;
     // The write log for the backing store
     std::vector<MockBackingStoreLogEntry> write_log;
 
     // The number of times each API was invoked
-    std::uint64_t backing_init_invoke_count;
-    std::uint64_t backing_unlock_invoke_count;
-    std::uint64_t backing_erase_invoke_count;
-    std::uint64_t backing_write_invoke_count;
-    std::uint64_t backing_lock_invoke_count;
+    std::uint64_t         backing_init_invoke_count;
+    std::uint64_t         backing_unlock_invoke_count;
+    std::uint64_t         backing_erase_invoke_count;
+    std::uint64_t         backing_write_invoke_count;
+    std::uint64_t         backing_lock_invoke_count;
+    mutable std::uint64_t backing_read_invoke_count;
+    mutable std::uint64_t backing_read_bulk_invoke_count;
 
     // Whether init should succeed
     std::function<bool(std::uint64_t)> init_success_callback;
@@ -108,6 +122,9 @@ class MockBackingStore {
     // Whether locks should succeed
     std::function<bool(std::uint64_t)> lock_success_callback;
 
+    // Reads a single element, without affecting the invocation counts
+    bool read_element(std::uint32_t address, backing_store_int_t& value) const;
+
     template <typename... Args>
     void append_log(Args&&... args) {
         if (write_log.size() < MOCK_WRITE_LOG_MAX_ENTRIES::value) {
@@ -124,12 +141,21 @@ class MockBackingStore {
     std::uint64_t erasure_count() const {
         return backing_erasure_count;
     }
+    std::uint64_t range_erasure_count() const {
+        return backing_range_erasure_count;
+    }
+    std::uint64_t range_erased_elements() const {
+        return backing_range_erased_elements;
+    }
     std::uint64_t max_write_count() const {
         return backing_max_write_count;
     }
     std::uint64_t total_write_count() const {
         return backing_total_write_count;
     }
+    std::uint64_t total_read_count() const {
+        return backing_total_read_count;
+    }
 
     // The number of times each API was invoked
     std::uint64_t init_invoke_count() const {
@@ -147,10 +173,19 @@ class MockBackingStore {
     std::uint64_t lock_invoke_count() const {
         return backing_lock_invoke_count;
     }
+    std::uint64_t read_invoke_count() const {
+        return backing_read_invoke_count;
+    }
+    std::uint64_t read_bulk_invoke_count() const {
+        return backing_read_bulk_invoke_count;
+    }
 
     // Clear out the internal data for the next run
     void reset_instance();
 
+    // Clear out the read/write/invocation counts, keeping the backing store contents
+    void reset_counts();
+
     bool is_locked() const {
         return locked;
     }
@@ -159,9 +194,11 @@ class MockBackingStore {
     bool init();
     bool unlock();
     bool erase();
+    bool erase_range(std::uint32_t address, std::uint32_t length);
     bool write(std::uint32_t address, backing_store_int_t value);
     bool lock();
     bool read(std::uint32_t address, backing_store_int_t& value) const;
+    bool read_bulk(std::uint32_t address, backing_store_int_t* values, std::size_t item_count) const;
 
     // Control over when init/writes/erases should succeed
     void set_init_callback(std::function<bool(std::uint64_t)> callback) {
@@ -63,4 +63,129 @@ wear_leveling_8byte_SRC := \
 	$(wear_leveling_common_SRC) \
 	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_8byte.cpp
 wear_leveling_8byte_INC := \
-	$(wear_leveling_common_INC)
\ No newline at end of file
+	$(wear_leveling_common_INC)
+
+wear_leveling_playback_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=8192 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=1024
+wear_leveling_playback_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_playback.cpp
+wear_leveling_playback_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_checkpoint_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=8192 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=1024 \
+	-DWEAR_LEVELING_CHECKPOINT_INTERVAL=2048
+wear_leveling_checkpoint_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_playback.cpp
+wear_leveling_checkpoint_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_write_buffer_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=2048 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=1024 \
+	-DWEAR_LEVELING_WRITE_BUFFER
+wear_leveling_write_buffer_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_write_buffer.cpp
+wear_leveling_write_buffer_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_two_bank_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=4096 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=512 \
+	-DWEAR_LEVELING_TWO_BANK \
+	-DWEAR_LEVELING_ERASE_SIZE=256
+wear_leveling_two_bank_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_two_bank.cpp
+wear_leveling_two_bank_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_sim_2byte_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=8192 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=2048
+wear_leveling_sim_2byte_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_sim.cpp
+wear_leveling_sim_2byte_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_sim_4byte_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=4 \
+	-DWEAR_LEVELING_BACKING_SIZE=8192 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=2048
+wear_leveling_sim_4byte_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_sim.cpp
+wear_leveling_sim_4byte_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_sim_8byte_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=8 \
+	-DWEAR_LEVELING_BACKING_SIZE=8192 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=2048
+wear_leveling_sim_8byte_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_sim.cpp
+wear_leveling_sim_8byte_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_sim_checkpoint_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=16384 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=2048 \
+	-DWEAR_LEVELING_CHECKPOINT_INTERVAL=4096
+wear_leveling_sim_checkpoint_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_sim.cpp
+wear_leveling_sim_checkpoint_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_sim_write_buffer_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=8192 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=2048 \
+	-DWEAR_LEVELING_WRITE_BUFFER
+wear_leveling_sim_write_buffer_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_sim.cpp
+wear_leveling_sim_write_buffer_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_sim_two_bank_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=16384 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=2048 \
+	-DWEAR_LEVELING_TWO_BANK \
+	-DWEAR_LEVELING_ERASE_SIZE=2048
+wear_leveling_sim_two_bank_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_sim.cpp
+wear_leveling_sim_two_bank_INC := \
+	$(wear_leveling_common_INC)
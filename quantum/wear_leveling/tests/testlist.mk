@@ -3,4 +3,14 @@ TEST_LIST += \
 	wear_leveling_2byte_optimized_writes \
 	wear_leveling_2byte \
 	wear_leveling_4byte \
-	wear_leveling_8byte
+	wear_leveling_8byte \
+	wear_leveling_playback \
+	wear_leveling_checkpoint \
+	wear_leveling_write_buffer \
+	wear_leveling_two_bank \
+	wear_leveling_sim_2byte \
+	wear_leveling_sim_4byte \
+	wear_leveling_sim_8byte \
+	wear_leveling_sim_checkpoint \
+	wear_leveling_sim_write_buffer \
+	wear_leveling_sim_two_bank
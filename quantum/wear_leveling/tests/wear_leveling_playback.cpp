@@ -0,0 +1,230 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <cstdio>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+class WearLevelingPlayback : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+        model.fill(0);
+        counter = 0;
+    }
+
+    // Performs a single-byte write outside of the optimized address range, which results in a 4-byte log entry
+    wear_leveling_status_t write_entry() {
+        std::uint32_t address = 64 + ((counter * 37) % (WEAR_LEVELING_LOGICAL_SIZE - 64));
+        std::uint8_t  value   = (std::uint8_t)(model[address] + 1 + (counter % 3));
+        if (value == 0) {
+            value = 1;
+        }
+        model[address] = value;
+        ++counter;
+        return wear_leveling_write(address, &value, sizeof(value));
+    }
+
+    void write_entries(std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            EXPECT_NE(write_entry(), WEAR_LEVELING_FAILED) << "Write failed";
+        }
+    }
+
+    // Fills the write log to the supplied percentage of the backing store, without consolidating
+    void fill_to(std::size_t percent) {
+        std::size_t target = (WEAR_LEVELING_BACKING_SIZE * percent) / 100;
+        while (log_end() + 8 < target) {
+            write_entries(1);
+        }
+    }
+
+    // Determines the end of the write log by inspecting the backing store directly
+    std::uint32_t log_end() {
+        auto&         inst = MockBackingStore::Instance();
+        std::uint32_t end  = WEAR_LEVELING_BACKING_SIZE;
+        while (end > WEAR_LEVELING_LOG_START && (inst.storage_begin() + (end / BACKING_STORE_WRITE_SIZE) - 1)->is_erased()) {
+            end -= BACKING_STORE_WRITE_SIZE;
+        }
+        return end;
+    }
+
+    void verify_contents() {
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        EXPECT_EQ(wear_leveling_read(0, readback.data(), readback.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        EXPECT_EQ(readback, model) << "Readback mismatch";
+    }
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> model;
+    std::size_t                                          counter;
+};
+
+/**
+ * This test verifies that the log is played back correctly at all fill levels, including across consolidation.
+ */
+TEST_F(WearLevelingPlayback, ReplaysAllFillLevels) {
+    for (std::size_t i = 0; i < 3 * (WEAR_LEVELING_BACKING_SIZE / 4); i += 97) {
+        write_entries(97);
+        EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Init failed";
+        verify_contents();
+    }
+}
+
+/**
+ * This test verifies that the write location after playback is immediately after the last entry, by checking that
+ * subsequent writes don't trip the "write to non-empty location" check in the mock.
+ */
+TEST_F(WearLevelingPlayback, ResumesAtEndOfLog) {
+    for (std::size_t i = 0; i < 50; ++i) {
+        write_entries(i);
+        EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Init failed";
+    }
+    verify_contents();
+}
+
+/**
+ * This test verifies that playback reads the backing store in chunks, rather than one read per log entry.
+ */
+TEST_F(WearLevelingPlayback, ChunkedReads) {
+    auto& inst = MockBackingStore::Instance();
+    fill_to(50);
+    std::uint32_t used = log_end() - WEAR_LEVELING_LOG_START;
+
+    inst.reset_counts();
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    verify_contents();
+
+    std::uint64_t transactions = inst.read_invoke_count() + inst.read_bulk_invoke_count();
+    EXPECT_LT(transactions, 2 * (used / WEAR_LEVELING_PLAYBACK_CHUNK_SIZE) + 64) << "Too many read transactions";
+    EXPECT_EQ(inst.total_read_count() * BACKING_STORE_WRITE_SIZE > WEAR_LEVELING_BACKING_SIZE, false) << "Read beyond the end of the log";
+}
+
+/**
+ * This test verifies that a zero-valued trailing write within the last log entry doesn't cause the end of the log to be misidentified.
+ */
+TEST_F(WearLevelingPlayback, TrailingZeroWithinLastEntry) {
+    uint8_t data[5] = {0x00, 0x00, 0x00, 0x00, 0x00};
+    uint8_t ones[5] = {0x01, 0x01, 0x01, 0x01, 0x01};
+    EXPECT_EQ(wear_leveling_write(0x100, ones, sizeof(ones)), WEAR_LEVELING_SUCCESS);
+    EXPECT_EQ(wear_leveling_write(0x100, data, sizeof(data)), WEAR_LEVELING_SUCCESS);
+    std::uint32_t end = log_end();
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    verify_contents();
+
+    // Next write should occur directly after the entry containing zeros, not inside it
+    uint8_t value = 0x42;
+    model[0x200]  = value;
+    EXPECT_EQ(wear_leveling_write(0x200, &value, sizeof(value)), WEAR_LEVELING_SUCCESS);
+    EXPECT_GT(log_end(), end) << "Write did not append to the log";
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    verify_contents();
+}
+
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+/**
+ * This test verifies that checkpoints are written at the expected locations.
+ */
+TEST_F(WearLevelingPlayback, CheckpointsWritten) {
+    auto& inst = MockBackingStore::Instance();
+    fill_to(95);
+
+    const auto marker = LOG_ENTRY_MAKE_CHECKPOINT();
+    for (std::uint32_t i = 1; i <= WEAR_LEVELING_CHECKPOINT_COUNT; ++i) {
+        backing_store_int_t value;
+        inst.read(WEAR_LEVELING_CHECKPOINT_ADDRESS(i), value);
+        EXPECT_EQ(value, LOG_ENTRY_FIRST_SLOT(marker)) << "Checkpoint " << i << " missing";
+    }
+}
+
+/**
+ * This test verifies that only the log entries after the latest checkpoint are read during init.
+ */
+TEST_F(WearLevelingPlayback, CheckpointSkipsEarlierEntries) {
+    auto& inst = MockBackingStore::Instance();
+    fill_to(95);
+
+    inst.reset_counts();
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    verify_contents();
+
+    // Consolidated area, the latest checkpoint, and the entries after it
+    std::uint32_t after_checkpoint = log_end() - (WEAR_LEVELING_CHECKPOINT_ADDRESS(WEAR_LEVELING_CHECKPOINT_COUNT) + WEAR_LEVELING_CHECKPOINT_SIZE);
+    std::uint32_t expected         = WEAR_LEVELING_LOG_START + WEAR_LEVELING_CHECKPOINT_SIZE + after_checkpoint;
+    EXPECT_LT(inst.total_read_count() * BACKING_STORE_WRITE_SIZE, expected + 256) << "Read more than expected";
+}
+
+/**
+ * This test verifies that a corrupted checkpoint is ignored, falling back to the previous checkpoint and playing back the log from there.
+ */
+TEST_F(WearLevelingPlayback, CorruptCheckpointFallsBack) {
+    auto& inst = MockBackingStore::Instance();
+    fill_to(95);
+
+    // Flip a value within the logical data of the latest checkpoint
+    auto element = inst.storage_begin() + (WEAR_LEVELING_CHECKPOINT_ADDRESS(WEAR_LEVELING_CHECKPOINT_COUNT) / BACKING_STORE_WRITE_SIZE) + 10;
+    if (element->is_erased()) {
+        element->set(0x1234);
+    } else {
+        element->erase();
+    }
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    verify_contents();
+
+    // Subsequent writes continue after the corrupted checkpoint
+    write_entries(10);
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    verify_contents();
+}
+
+/**
+ * This test verifies that an incomplete checkpoint (i.e. power loss during write) is ignored.
+ */
+TEST_F(WearLevelingPlayback, IncompleteCheckpointIgnored) {
+    auto& inst = MockBackingStore::Instance();
+    fill_to(30);
+
+    // Allow the marker and part of the checkpoint to be written, then fail
+    std::uint32_t checkpoint = WEAR_LEVELING_CHECKPOINT_ADDRESS(1);
+    inst.set_write_callback([checkpoint](std::uint64_t, std::uint32_t address) { return address < checkpoint + 64; });
+    auto                   saved = model;
+    wear_leveling_status_t status;
+    do {
+        saved  = model;
+        status = write_entry();
+    } while (status != WEAR_LEVELING_FAILED && log_end() <= checkpoint);
+    EXPECT_EQ(status, WEAR_LEVELING_FAILED) << "Checkpoint write should have failed";
+    inst.set_write_callback([](std::uint64_t, std::uint32_t) { return true; });
+
+    // The write that triggered the checkpoint was lost
+    model = saved;
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    verify_contents();
+
+    // Subsequent writes continue after the incomplete checkpoint
+    write_entries(10);
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    verify_contents();
+}
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+
+/**
+ * Reports the cost of init at various write log fill levels.
+ */
+TEST_F(WearLevelingPlayback, InitCostReport) {
+    auto& inst = MockBackingStore::Instance();
+    for (std::size_t percent : {0, 25, 50, 75, 95}) {
+        inst.reset_instance();
+        wear_leveling_init();
+        model.fill(0);
+        fill_to(percent);
+
+        std::uint32_t used = log_end() - WEAR_LEVELING_LOG_START;
+        inst.reset_counts();
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+        verify_contents();
+        printf("[ WL INIT  ] %3d%% full: %5d read transactions, %6d bytes read (%d bytes of write log)\n", (int)percent, (int)(inst.read_invoke_count() + inst.read_bulk_invoke_count()), (int)(inst.total_read_count() * BACKING_STORE_WRITE_SIZE), (int)used);
+    }
+}
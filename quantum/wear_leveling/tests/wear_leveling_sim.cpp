@@ -0,0 +1,278 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// Simulated cost of backing store operations, modelled on STM32F303 embedded flash
+static const double BACKING_WRITE_US         = 60.0;
+static const double BACKING_SECTOR_ERASE_US  = 20000.0;
+static const double BACKING_READ_US          = 0.1;
+static const double BACKING_READ_TRANSFER_US = 0.5;
+static const double FLASH_ENDURANCE_CYCLES   = 10000.0;
+
+// Size of a backing store sector, for the purposes of erase accounting
+#ifdef WEAR_LEVELING_ERASE_SIZE
+static const std::uint32_t SIM_SECTOR_SIZE = WEAR_LEVELING_ERASE_SIZE;
+#else
+static const std::uint32_t SIM_SECTOR_SIZE = std::min<std::uint32_t>(2048, WEAR_LEVELING_BACKING_SIZE);
+#endif
+
+// Logical layout, mirroring eeconfig and VIA's dynamic keymap
+static const std::uint32_t EECONFIG_DEBUG_ADDR         = 2;
+static const std::uint32_t EECONFIG_DEFAULT_LAYER_ADDR = 3;
+static const std::uint32_t EECONFIG_KEYMAP_ADDR        = 4;
+static const std::uint32_t EECONFIG_BACKLIGHT_ADDR     = 6;
+static const std::uint32_t EECONFIG_AUDIO_ADDR         = 7;
+static const std::uint32_t EECONFIG_USER_ADDR          = 19;
+static const std::uint32_t EECONFIG_RGB_MATRIX_ADDR    = 28;
+static const std::uint32_t EECONFIG_RGB_EXTENDED_ADDR  = 32;
+static const std::uint32_t DYNAMIC_KEYMAP_ADDR         = 39;
+static const std::uint32_t DYNAMIC_KEYMAP_KEYS         = std::min<std::uint32_t>(4 * 6 * 17, (WEAR_LEVELING_LOGICAL_SIZE - DYNAMIC_KEYMAP_ADDR) / 2);
+
+// Number of logical writes per workload, override with the WEAR_LEVELING_SIM_WRITES environment variable
+static const std::uint64_t DEFAULT_SIM_WRITES = 100000;
+// Number of logical writes between simulated reboots
+static const std::uint64_t REBOOT_INTERVAL    = 2500;
+
+class WearLevelingSimulator : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+        model.fill(0);
+        rng.seed(0x514D4B);
+        writes          = 0;
+        changed_bytes   = 0;
+        max_write_us    = 0;
+        max_task_us     = 0;
+        max_boot_us     = 0;
+        total_boot_us   = 0;
+        boots           = 0;
+        const char* env = std::getenv("WEAR_LEVELING_SIM_WRITES");
+        target_writes   = env ? std::strtoull(env, nullptr, 10) : DEFAULT_SIM_WRITES;
+    }
+
+    // Simulated time spent in the backing store by the supplied operation
+    template <typename F>
+    double measure(F&& func) {
+        auto&         inst   = MockBackingStore::Instance();
+        std::uint64_t before = inst.total_write_count();
+        std::uint64_t erased = sector_erases();
+        func();
+        return (inst.total_write_count() - before) * BACKING_WRITE_US + (sector_erases() - erased) * BACKING_SECTOR_ERASE_US;
+    }
+
+    // Total number of sector erases performed so far
+    std::uint64_t sector_erases() {
+        auto&         inst  = MockBackingStore::Instance();
+        std::uint64_t total = 0;
+        for (auto it = inst.storage_begin(); it != inst.storage_end(); it += SIM_SECTOR_SIZE / BACKING_STORE_WRITE_SIZE) {
+            total += it->num_erase_cycles();
+        }
+        return total;
+    }
+
+    // Performs a logical write, as the EEPROM driver would
+    void write(std::uint32_t address, const void* data, std::size_t length) {
+        const std::uint8_t* p = (const std::uint8_t*)data;
+        for (std::size_t i = 0; i < length; ++i) {
+            changed_bytes += model[address + i] != p[i] ? 1 : 0;
+        }
+        std::copy(p, p + length, model.begin() + address);
+        double us = measure([&] { EXPECT_NE(wear_leveling_write(address, data, length), WEAR_LEVELING_FAILED) << "Write failed"; });
+        max_write_us = std::max(max_write_us, us);
+        ++writes;
+        if (writes % REBOOT_INTERVAL == 0) {
+            reboot();
+        }
+        advance_time(1);
+    }
+
+    void write_byte(std::uint32_t address, std::uint8_t value) {
+        write(address, &value, sizeof(value));
+    }
+
+    // Emulates the main loop running for the supplied duration, invoking the periodic task every few milliseconds
+    void idle(std::uint32_t ms) {
+        for (std::uint32_t elapsed = 0; elapsed < ms; elapsed += 10) {
+            double us   = measure([] { wear_leveling_task(); });
+            max_task_us = std::max(max_task_us, us);
+            advance_time(10);
+        }
+    }
+
+    // Emulates an orderly reboot, measuring the time taken to replay the write log
+    void reboot() {
+        auto& inst = MockBackingStore::Instance();
+        EXPECT_NE(wear_leveling_flush(), WEAR_LEVELING_FAILED) << "Flush failed";
+        std::uint64_t reads        = inst.total_read_count();
+        std::uint64_t transactions = inst.read_invoke_count() + inst.read_bulk_invoke_count();
+        double        us           = measure([] { EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Init failed"; });
+        us += (inst.total_read_count() - reads) * BACKING_READ_US + (inst.read_invoke_count() + inst.read_bulk_invoke_count() - transactions) * BACKING_READ_TRANSFER_US;
+        max_boot_us = std::max(max_boot_us, us);
+        total_boot_us += us;
+        ++boots;
+    }
+
+    // VIA keymap editing: individual key changes, with an occasional full keymap upload
+    void via_keymap_event() {
+        if (rng() % 200 == 0) {
+            for (std::uint32_t key = 0; key < DYNAMIC_KEYMAP_KEYS; ++key) {
+                std::uint16_t keycode = random_keycode();
+                write_byte(DYNAMIC_KEYMAP_ADDR + key * 2 + 0, keycode >> 8);
+                write_byte(DYNAMIC_KEYMAP_ADDR + key * 2 + 1, keycode & 0xFF);
+            }
+            idle(1000);
+            return;
+        }
+
+        std::uint32_t key     = rng() % DYNAMIC_KEYMAP_KEYS;
+        std::uint16_t keycode = random_keycode();
+        write_byte(DYNAMIC_KEYMAP_ADDR + key * 2 + 0, keycode >> 8);
+        write_byte(DYNAMIC_KEYMAP_ADDR + key * 2 + 1, keycode & 0xFF);
+        idle(2000);
+    }
+
+    // RGB configuration: holding down a hue/value/speed key, stepping every 50ms
+    void rgb_config_event() {
+        std::uint32_t steps = 1 + rng() % 20;
+        std::uint8_t  field = rng() % 3;
+        for (std::uint32_t i = 0; i < steps; ++i) {
+            std::uint8_t config[4];
+            std::copy(model.begin() + EECONFIG_RGB_MATRIX_ADDR, model.begin() + EECONFIG_RGB_MATRIX_ADDR + sizeof(config), config);
+            config[0] |= 0x01;
+            if (field == 2) {
+                std::uint8_t extended[2] = {(std::uint8_t)(model[EECONFIG_RGB_EXTENDED_ADDR] + 16), model[EECONFIG_RGB_EXTENDED_ADDR + 1]};
+                write(EECONFIG_RGB_EXTENDED_ADDR, extended, sizeof(extended));
+            } else {
+                config[1 + field] += 8;
+                write(EECONFIG_RGB_MATRIX_ADDR, config, sizeof(config));
+            }
+            idle(50);
+        }
+        idle(5000);
+    }
+
+    // Assorted eeconfig updates: magic keycodes, layer changes, audio/backlight toggles, user config
+    void eeconfig_event() {
+        switch (rng() % 5) {
+            case 0:
+                write_byte(EECONFIG_KEYMAP_ADDR, model[EECONFIG_KEYMAP_ADDR] ^ (1 << (rng() % 8)));
+                break;
+            case 1:
+                write_byte(EECONFIG_DEFAULT_LAYER_ADDR, 1 << (rng() % 4));
+                break;
+            case 2:
+                write_byte(EECONFIG_AUDIO_ADDR, model[EECONFIG_AUDIO_ADDR] ^ 0x01);
+                break;
+            case 3:
+                write_byte(EECONFIG_BACKLIGHT_ADDR, (std::uint8_t)((model[EECONFIG_BACKLIGHT_ADDR] + 1) % 8));
+                break;
+            case 4: {
+                std::uint8_t user[4] = {(std::uint8_t)rng(), 0, 0, 0};
+                write(EECONFIG_USER_ADDR, user, sizeof(user));
+            } break;
+        }
+        write_byte(EECONFIG_DEBUG_ADDR, 0);
+        idle(1000);
+    }
+
+    std::uint16_t random_keycode() {
+        std::uint32_t r = rng() % 10;
+        if (r < 2) {
+            return 0x0001; // KC_TRANSPARENT
+        } else if (r < 3) {
+            return 0x0000; // KC_NO
+        }
+        return (std::uint16_t)(0x0004 + rng() % 0x1000);
+    }
+
+    // Runs the supplied workload until the target number of logical writes have been performed, then reports
+    void simulate(const char* name, std::function<void(void)> event) {
+        auto& inst = MockBackingStore::Instance();
+        SetUp();
+        inst.reset_counts();
+        std::uint64_t format_erases = sector_erases();
+        while (writes < target_writes) {
+            event();
+        }
+        reboot();
+
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        EXPECT_EQ(wear_leveling_read(0, readback.data(), readback.size()), WEAR_LEVELING_SUCCESS) << "Read failed";
+        EXPECT_EQ(readback, model) << "Readback mismatch after simulation of " << name;
+
+        // Per-sector erase counts, excluding the initial format
+        std::uint64_t min_erases = UINT64_MAX;
+        std::uint64_t max_erases = 0;
+        for (auto it = inst.storage_begin(); it != inst.storage_end(); it += SIM_SECTOR_SIZE / BACKING_STORE_WRITE_SIZE) {
+            min_erases = std::min<std::uint64_t>(min_erases, it->num_erase_cycles());
+            max_erases = std::max<std::uint64_t>(max_erases, it->num_erase_cycles());
+        }
+        const std::uint32_t sectors        = WEAR_LEVELING_BACKING_SIZE / SIM_SECTOR_SIZE;
+        const double        consolidations = (double)(sector_erases() - format_erases) / (WEAR_LEVELING_BANK_SIZE / SIM_SECTOR_SIZE);
+        const double        amplification  = changed_bytes ? (double)(inst.total_write_count() * BACKING_STORE_WRITE_SIZE) / changed_bytes : 0;
+        const double        lifetime       = max_erases ? FLASH_ENDURANCE_CYCLES * writes / max_erases : 0;
+
+        printf("[ WL SIM   ] %-16s: %8llu writes, %8llu bytes changed, write amplification %6.2fx\n", name, (unsigned long long)writes, (unsigned long long)changed_bytes, amplification);
+        printf("[ WL SIM   ] %-16s: %2u sectors of %5u bytes, erases per sector min %6llu max %6llu, %8.1f writes per consolidation\n", name, (unsigned)sectors, (unsigned)SIM_SECTOR_SIZE, (unsigned long long)min_erases, (unsigned long long)max_erases, consolidations > 0 ? writes / consolidations : (double)writes);
+        printf("[ WL SIM   ] %-16s: boot replay avg %8.0f us max %8.0f us, worst-case write %8.0f us, task %8.0f us, ~%.3g writes to %.0f cycles\n", name, boots ? total_boot_us / boots : 0, max_boot_us, max_write_us, max_task_us, lifetime, FLASH_ENDURANCE_CYCLES);
+    }
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> model;
+    std::mt19937                                         rng;
+    std::uint64_t                                        target_writes;
+    std::uint64_t                                        writes;
+    std::uint64_t                                        changed_bytes;
+    double                                               max_write_us;
+    double                                               max_task_us;
+    double                                               max_boot_us;
+    double                                               total_boot_us;
+    std::uint64_t                                        boots;
+};
+
+/**
+ * Replays each workload, reporting flash wear and latency for the configuration this target was built with.
+ */
+TEST_F(WearLevelingSimulator, EnduranceReport) {
+    std::string options;
+#ifdef WEAR_LEVELING_WRITE_BUFFER
+    options += " WRITE_BUFFER";
+#endif
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+    options += " CHECKPOINT_INTERVAL=" + std::to_string(WEAR_LEVELING_CHECKPOINT_INTERVAL);
+#endif
+#ifdef WEAR_LEVELING_TWO_BANK
+    options += " TWO_BANK";
+#endif
+    printf("[ WL SIM   ] BACKING_STORE_WRITE_SIZE=%d WEAR_LEVELING_BACKING_SIZE=%d WEAR_LEVELING_LOGICAL_SIZE=%d%s\n", (int)BACKING_STORE_WRITE_SIZE, (int)WEAR_LEVELING_BACKING_SIZE, (int)WEAR_LEVELING_LOGICAL_SIZE, options.c_str());
+
+    simulate("VIA keymap", [this] { via_keymap_event(); });
+    simulate("RGB config", [this] { rgb_config_event(); });
+    simulate("eeconfig", [this] { eeconfig_event(); });
+    simulate("mixed", [this] {
+        switch (rng() % 4) {
+            case 0:
+                via_keymap_event();
+                break;
+            case 1:
+                rgb_config_event();
+                break;
+            default:
+                eeconfig_event();
+                break;
+        }
+    });
+}
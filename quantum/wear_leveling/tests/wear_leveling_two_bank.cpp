@@ -0,0 +1,273 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <cstdio>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+// Simulated cost of backing store operations, modelled on STM32F303 embedded flash
+static const std::uint32_t BACKING_WRITE_US      = 60;
+static const std::uint32_t BACKING_PAGE_ERASE_US = 20000;
+
+class WearLevelingTwoBank : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+        model.fill(0);
+        counter = 0;
+    }
+
+    // Performs a single-byte write within the first 64 bytes, which results in a single-write log entry
+    wear_leveling_status_t write_entry() {
+        pending_address = (counter * 7) % 64;
+        pending_value   = (std::uint8_t)(model[pending_address] + 1);
+        ++counter;
+        wear_leveling_status_t status = wear_leveling_write(pending_address, &pending_value, sizeof(pending_value));
+        if (status != WEAR_LEVELING_FAILED) {
+            model[pending_address] = pending_value;
+        }
+        return status;
+    }
+
+    // Fills the write log of the active bank until background consolidation would be started
+    void fill_to_headroom() {
+        while (remaining_log() >= WEAR_LEVELING_CONSOLIDATION_HEADROOM) {
+            EXPECT_NE(write_entry(), WEAR_LEVELING_FAILED) << "Write failed";
+        }
+    }
+
+    // Reads the sequence number of the bank at the supplied address, or zero if not valid
+    std::uint32_t bank_sequence(std::uint32_t bank_base) {
+        auto&             inst   = MockBackingStore::Instance();
+        write_log_entry_t header = {.raw64 = 0};
+        for (std::uint32_t i = 0; i < 8 / BACKING_STORE_WRITE_SIZE; ++i) {
+            inst.read(bank_base + i * BACKING_STORE_WRITE_SIZE, ((backing_store_int_t*)header.raw8)[i]);
+        }
+        return header.raw32[1] == WEAR_LEVELING_BANK_MAGIC ? header.raw32[0] : 0;
+    }
+
+    // Determines the active bank by inspecting the backing store directly
+    std::uint32_t active_bank() {
+        std::uint32_t sequence0 = bank_sequence(0);
+        std::uint32_t sequence1 = bank_sequence(WEAR_LEVELING_BANK_SIZE);
+        return sequence1 > sequence0 ? WEAR_LEVELING_BANK_SIZE : 0;
+    }
+
+    // Determines the amount of free space left in the write log of the active bank
+    std::uint32_t remaining_log() {
+        auto&         inst = MockBackingStore::Instance();
+        std::uint32_t base = active_bank();
+        std::uint32_t end  = base + WEAR_LEVELING_BANK_SIZE;
+        while (end > base + WEAR_LEVELING_LOG_START && (inst.storage_begin() + (end / BACKING_STORE_WRITE_SIZE) - 1)->is_erased()) {
+            end -= BACKING_STORE_WRITE_SIZE;
+        }
+        return base + WEAR_LEVELING_BANK_SIZE - end;
+    }
+
+    bool contents_match(const std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE>& expected) {
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        EXPECT_EQ(wear_leveling_read(0, readback.data(), readback.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        return readback == expected;
+    }
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> model;
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> committed;
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> in_flight;
+    std::size_t                                          counter;
+    std::uint32_t                                        pending_address;
+    std::uint8_t                                         pending_value;
+};
+
+/**
+ * This test verifies that a blank backing store is formatted with the first bank active.
+ */
+TEST_F(WearLevelingTwoBank, FormatsOnFirstBoot) {
+    EXPECT_EQ(bank_sequence(0), 1) << "First bank not marked active";
+    EXPECT_EQ(bank_sequence(WEAR_LEVELING_BANK_SIZE), 0) << "Second bank should not be valid";
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    EXPECT_TRUE(contents_match(model)) << "Readback mismatch";
+}
+
+/**
+ * This test verifies that the periodic task consolidates into the alternate bank in bounded steps, without ever
+ * erasing the entire backing store.
+ */
+TEST_F(WearLevelingTwoBank, TaskConsolidatesIncrementally) {
+    auto& inst = MockBackingStore::Instance();
+    fill_to_headroom();
+    inst.reset_counts();
+
+    std::size_t steps = 0;
+    while (active_bank() == 0) {
+        std::uint64_t writes = inst.total_write_count();
+        std::uint64_t erased = inst.range_erased_elements();
+        wear_leveling_task();
+        EXPECT_LE((inst.range_erased_elements() - erased) * BACKING_STORE_WRITE_SIZE, WEAR_LEVELING_ERASE_SIZE) << "Erased too much in a single step";
+        EXPECT_LE((inst.total_write_count() - writes) * BACKING_STORE_WRITE_SIZE, WEAR_LEVELING_CONSOLIDATION_STEP_SIZE) << "Wrote too much in a single step";
+        ASSERT_LT(++steps, 1000) << "Consolidation did not complete";
+    }
+    EXPECT_EQ(inst.erasure_count(), 0) << "Backing store should not have been fully erased";
+    EXPECT_EQ(bank_sequence(WEAR_LEVELING_BANK_SIZE), 2) << "Second bank not marked active";
+
+    // Steady state, nothing further to do
+    std::uint64_t writes = inst.total_write_count();
+    wear_leveling_task();
+    EXPECT_EQ(inst.total_write_count(), writes) << "Unexpected writes once consolidated";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    EXPECT_TRUE(contents_match(model)) << "Readback mismatch";
+}
+
+/**
+ * This test verifies that writes made while consolidation is in progress are carried over to the new bank.
+ */
+TEST_F(WearLevelingTwoBank, WritesDuringConsolidationSurvive) {
+    fill_to_headroom();
+    for (int round = 0; round < 4; ++round) {
+        std::uint32_t bank = active_bank();
+        while (active_bank() == bank) {
+            EXPECT_NE(write_entry(), WEAR_LEVELING_FAILED) << "Write failed";
+            std::uint8_t data[5] = {(std::uint8_t)counter, 1, 2, 3, (std::uint8_t)round};
+            std::copy(std::begin(data), std::end(data), model.begin() + 0x100 + (counter % 32) * 4);
+            EXPECT_NE(wear_leveling_write(0x100 + (counter % 32) * 4, data, sizeof(data)), WEAR_LEVELING_FAILED) << "Write failed";
+            wear_leveling_task();
+        }
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+        EXPECT_TRUE(contents_match(model)) << "Readback mismatch after round " << round;
+    }
+}
+
+/**
+ * This test verifies that consolidation still occurs if the periodic task is never invoked.
+ */
+TEST_F(WearLevelingTwoBank, FullLogConsolidatesSynchronously) {
+    auto& inst = MockBackingStore::Instance();
+    inst.reset_counts();
+    for (std::uint32_t sequence = 2; sequence < 6; ++sequence) {
+        while (bank_sequence(0) < sequence && bank_sequence(WEAR_LEVELING_BANK_SIZE) < sequence) {
+            EXPECT_NE(write_entry(), WEAR_LEVELING_FAILED) << "Write failed";
+        }
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+        EXPECT_TRUE(contents_match(model)) << "Readback mismatch";
+    }
+    EXPECT_EQ(inst.erasure_count(), 0) << "Backing store should not have been fully erased";
+}
+
+/**
+ * This test verifies that the newest bank is ignored if its consolidated data is corrupt.
+ */
+TEST_F(WearLevelingTwoBank, CorruptBankFallsBack) {
+    fill_to_headroom();
+    while (active_bank() == 0) {
+        wear_leveling_task();
+    }
+    auto saved = model;
+    EXPECT_NE(write_entry(), WEAR_LEVELING_FAILED) << "Write failed";
+
+    // Flip a value within the consolidated data of the new bank
+    auto element = MockBackingStore::Instance().storage_begin() + ((WEAR_LEVELING_BANK_SIZE + WEAR_LEVELING_BANK_HEADER_SIZE) / BACKING_STORE_WRITE_SIZE) + 10;
+    if (element->is_erased()) {
+        element->set(0x1234);
+    } else {
+        element->erase();
+    }
+
+    // Writes made before consolidation began are retained in the previous bank
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    EXPECT_TRUE(contents_match(saved)) << "Readback mismatch";
+}
+
+/**
+ * This test verifies that a power loss at any point during incremental consolidation results in either the previous
+ * or the new contents being read back after restart.
+ */
+TEST_F(WearLevelingTwoBank, PowerLossAtEveryStep) {
+    auto&       inst      = MockBackingStore::Instance();
+    bool        lost      = false;
+    std::size_t remaining = SIZE_MAX;
+    auto        power     = [&](void) {
+        if (lost || remaining-- == 0) {
+            lost = true;
+        }
+        return !lost;
+    };
+
+    // Runs a workload spanning an entire consolidation, returning the number of backing store operations performed
+    auto run = [&](std::size_t budget) {
+        SetUp();
+        fill_to_headroom();
+        lost      = false;
+        remaining = budget;
+        inst.reset_counts();
+        inst.set_write_callback([&](std::uint64_t, std::uint32_t) { return power(); });
+        inst.set_erase_callback([&](std::uint64_t) { return power(); });
+
+        committed = model;
+        for (int i = 0; i < 64 && !lost; ++i) {
+            wear_leveling_status_t status = write_entry();
+            if (!lost) {
+                EXPECT_NE(status, WEAR_LEVELING_FAILED) << "Write failed";
+                committed = model;
+            } else {
+                in_flight                  = committed;
+                in_flight[pending_address] = pending_value;
+                break;
+            }
+            wear_leveling_task();
+            if (lost) {
+                in_flight = committed;
+            }
+        }
+        inst.set_write_callback([](std::uint64_t, std::uint32_t) { return true; });
+        inst.set_erase_callback([](std::uint64_t) { return true; });
+        return inst.total_write_count() + inst.range_erased_elements();
+    };
+
+    const std::size_t total = run(SIZE_MAX);
+    EXPECT_NE(active_bank(), 0) << "Workload did not complete consolidation";
+
+    for (std::size_t budget = 0; budget < total; ++budget) {
+        run(budget);
+        ASSERT_TRUE(lost) << "Power loss was not simulated";
+
+        // Restart, then make sure the device continues to function afterwards
+        ASSERT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed after power loss at step " << budget;
+        ASSERT_TRUE(contents_match(committed) || contents_match(in_flight)) << "Readback mismatch after power loss at step " << budget;
+        wear_leveling_read(0, model.data(), model.size());
+        for (int i = 0; i < 8; ++i) {
+            ASSERT_NE(write_entry(), WEAR_LEVELING_FAILED) << "Write failed after power loss at step " << budget;
+            wear_leveling_task();
+        }
+        ASSERT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed after power loss at step " << budget;
+        ASSERT_TRUE(contents_match(model)) << "Readback mismatch after recovering from power loss at step " << budget;
+    }
+}
+
+/**
+ * Reports the worst-case stall caused by consolidation, with and without the periodic task.
+ */
+TEST_F(WearLevelingTwoBank, ConsolidationStallReport) {
+    auto& inst = MockBackingStore::Instance();
+    for (bool use_task : {false, true}) {
+        SetUp();
+        inst.reset_counts();
+        std::uint32_t max_stall_us = 0;
+        auto          measure      = [&](std::function<void(void)> func) {
+            std::uint64_t writes = inst.total_write_count();
+            std::uint64_t pages  = inst.range_erasure_count();
+            func();
+            std::uint32_t stall_us = (std::uint32_t)((inst.total_write_count() - writes) * BACKING_WRITE_US + (inst.range_erasure_count() - pages) * BACKING_PAGE_ERASE_US);
+            if (stall_us > max_stall_us) {
+                max_stall_us = stall_us;
+            }
+        };
+        while (bank_sequence(0) < 3) {
+            measure([&] { EXPECT_NE(write_entry(), WEAR_LEVELING_FAILED) << "Write failed"; });
+            if (use_task) {
+                measure([&] { wear_leveling_task(); });
+            }
+        }
+        printf("[ WL BANKS ] %-12s: %5d writes until two consolidations, worst-case stall %6d us\n", use_task ? "with task" : "without task", (int)counter, (int)max_stall_us);
+    }
+}
@@ -0,0 +1,220 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <cstdio>
+#include <numeric>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// Simulated cost of backing store operations, modelled on STM32F303 embedded flash
+static const std::uint32_t BACKING_WRITE_US = 60;
+static const std::uint32_t BACKING_ERASE_US = 20000;
+
+class WearLevelingWriteBuffer : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+        max_stall_us = 0;
+    }
+
+    // Invokes the supplied operation, keeping track of the worst-case time spent in the backing store
+    template <typename F>
+    void measure(F&& func) {
+        auto&         inst   = MockBackingStore::Instance();
+        std::uint64_t writes = inst.total_write_count();
+        std::uint64_t erases = inst.erasure_count();
+        func();
+        std::uint32_t stall_us = (std::uint32_t)((inst.total_write_count() - writes) * BACKING_WRITE_US + (inst.erasure_count() - erases) * BACKING_ERASE_US);
+        if (stall_us > max_stall_us) {
+            max_stall_us = stall_us;
+        }
+    }
+
+    // Emulates the main loop for the supplied duration
+    void run_for(std::uint32_t ms) {
+        for (std::uint32_t i = 0; i < ms; ++i) {
+            measure([] { wear_leveling_task(); });
+            advance_time(1);
+        }
+    }
+
+    // Writes a byte, optionally flushing immediately to emulate unbuffered behaviour
+    void write_byte(std::uint32_t address, std::uint8_t value, bool unbuffered) {
+        measure([&] {
+            EXPECT_NE(wear_leveling_write(address, &value, sizeof(value)), WEAR_LEVELING_FAILED) << "Write failed";
+            if (unbuffered) {
+                EXPECT_NE(wear_leveling_flush(), WEAR_LEVELING_FAILED) << "Flush failed";
+            }
+        });
+    }
+
+    std::uint32_t max_stall_us;
+};
+
+/**
+ * This test verifies that buffered writes are immediately visible to reads, without touching the backing store.
+ */
+TEST_F(WearLevelingWriteBuffer, ReadsSeeBufferedWrites) {
+    auto&   inst  = MockBackingStore::Instance();
+    uint8_t value = 0x5A;
+    EXPECT_EQ(wear_leveling_write(0x80, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write failed";
+    EXPECT_EQ(inst.write_invoke_count(), 0) << "Buffered write should not reach the backing store";
+
+    uint8_t readback = 0;
+    EXPECT_EQ(wear_leveling_read(0x80, &readback, sizeof(readback)), WEAR_LEVELING_SUCCESS) << "Read failed";
+    EXPECT_EQ(readback, value) << "Readback mismatch";
+}
+
+/**
+ * This test verifies that flushed writes survive a re-init, and that unflushed writes do not.
+ */
+TEST_F(WearLevelingWriteBuffer, FlushPersists) {
+    uint8_t value = 0x5A;
+    EXPECT_EQ(wear_leveling_write(0x80, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write failed";
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_SUCCESS) << "Flush failed";
+    value = 0xA5;
+    EXPECT_EQ(wear_leveling_write(0x81, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write failed";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    uint8_t readback[2];
+    EXPECT_EQ(wear_leveling_read(0x80, readback, sizeof(readback)), WEAR_LEVELING_SUCCESS) << "Read failed";
+    EXPECT_EQ(readback[0], 0x5A) << "Flushed write was lost";
+    EXPECT_EQ(readback[1], 0x00) << "Unflushed write should have been discarded";
+}
+
+/**
+ * This test verifies that overlapping and adjacent writes are merged into a single range.
+ */
+TEST_F(WearLevelingWriteBuffer, AdjacentWritesMerged) {
+    auto& inst = MockBackingStore::Instance();
+    for (std::uint32_t i = 0; i < 20; ++i) {
+        write_byte(0x100 + i, (std::uint8_t)(i + 1), false);
+    }
+    write_byte(0x105, 0x55, false);
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_SUCCESS) << "Flush failed";
+
+    // 20 bytes is 4x 5-byte multibyte entries, each of which takes 4 backing writes
+    EXPECT_EQ(inst.write_invoke_count(), 16) << "Writes were not merged";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    std::uint8_t readback[20];
+    EXPECT_EQ(wear_leveling_read(0x100, readback, sizeof(readback)), WEAR_LEVELING_SUCCESS) << "Read failed";
+    for (std::uint32_t i = 0; i < 20; ++i) {
+        EXPECT_EQ(readback[i], i == 5 ? 0x55 : i + 1) << "Readback mismatch at " << i;
+    }
+}
+
+/**
+ * This test verifies that pending writes are flushed once writes have been idle for long enough.
+ */
+TEST_F(WearLevelingWriteBuffer, IdleFlush) {
+    auto& inst = MockBackingStore::Instance();
+    write_byte(0x100, 0x01, false);
+    run_for(WEAR_LEVELING_WRITE_BUFFER_IDLE_MS - 1);
+    EXPECT_EQ(inst.write_invoke_count(), 0) << "Flushed too early";
+    run_for(2);
+    EXPECT_GT(inst.write_invoke_count(), 0) << "Idle flush did not occur";
+}
+
+/**
+ * This test verifies that continuous writes are still flushed once the oldest pending write is too stale.
+ */
+TEST_F(WearLevelingWriteBuffer, MaxStaleness) {
+    auto&         inst    = MockBackingStore::Instance();
+    std::uint32_t elapsed = 0;
+    std::uint8_t  value   = 0;
+    while (inst.write_invoke_count() == 0 && elapsed < 2 * WEAR_LEVELING_WRITE_BUFFER_MAX_STALENESS_MS) {
+        write_byte(0x100, ++value, false);
+        run_for(WEAR_LEVELING_WRITE_BUFFER_IDLE_MS / 2);
+        elapsed += WEAR_LEVELING_WRITE_BUFFER_IDLE_MS / 2;
+    }
+    EXPECT_GE(elapsed, WEAR_LEVELING_WRITE_BUFFER_MAX_STALENESS_MS) << "Flushed too early";
+    EXPECT_LE(elapsed, WEAR_LEVELING_WRITE_BUFFER_MAX_STALENESS_MS + WEAR_LEVELING_WRITE_BUFFER_IDLE_MS / 2) << "Staleness limit exceeded";
+}
+
+/**
+ * This test verifies that running out of ranges forces a flush.
+ */
+TEST_F(WearLevelingWriteBuffer, RangeLimitForcesFlush) {
+    auto& inst = MockBackingStore::Instance();
+    for (std::uint32_t i = 0; i < WEAR_LEVELING_WRITE_BUFFER_RANGES; ++i) {
+        write_byte(0x100 + i * 16, 0x01, false);
+    }
+    EXPECT_EQ(inst.write_invoke_count(), 0) << "Flushed too early";
+    write_byte(0x100 + WEAR_LEVELING_WRITE_BUFFER_RANGES * 16, 0x01, false);
+    EXPECT_EQ(inst.write_invoke_count(), WEAR_LEVELING_WRITE_BUFFER_RANGES * 2) << "Full buffer was not flushed";
+}
+
+/**
+ * This test verifies that consolidation during a flush still results in all pending data being stored.
+ */
+TEST_F(WearLevelingWriteBuffer, ConsolidationDuringFlush) {
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> model;
+    model.fill(0);
+    for (std::uint32_t round = 0; round < 64; ++round) {
+        for (std::uint32_t i = 0; i < WEAR_LEVELING_WRITE_BUFFER_RANGES; ++i) {
+            std::uint32_t address = 0x40 + ((round * 131 + i * 67) % (WEAR_LEVELING_LOGICAL_SIZE - 0x48));
+            std::uint8_t  data[5];
+            std::iota(std::begin(data), std::end(data), (std::uint8_t)(round + i + 1));
+            std::copy(std::begin(data), std::end(data), model.begin() + address);
+            EXPECT_NE(wear_leveling_write(address, data, sizeof(data)), WEAR_LEVELING_FAILED) << "Write failed";
+        }
+        EXPECT_NE(wear_leveling_flush(), WEAR_LEVELING_FAILED) << "Flush failed";
+    }
+    EXPECT_GT(MockBackingStore::Instance().erasure_count(), 0) << "Expected consolidation to occur";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init failed";
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+    EXPECT_EQ(wear_leveling_read(0, readback.data(), readback.size()), WEAR_LEVELING_SUCCESS) << "Read failed";
+    EXPECT_EQ(readback, model) << "Readback mismatch";
+}
+
+/**
+ * Reports backing store usage for typical bursts of writes, with and without buffering.
+ */
+TEST_F(WearLevelingWriteBuffer, BurstCostReport) {
+    auto& inst = MockBackingStore::Instance();
+
+    struct workload_t {
+        const char* name;
+        std::function<void(bool)> run;
+    };
+
+    const workload_t workloads[] = {
+        // VIA setting 4 layers of a 5x15 keymap through dynamic_keymap_set_buffer(), one byte at a time
+        {"VIA keymap upload", [this](bool unbuffered) {
+             for (std::uint32_t i = 0; i < 4 * 5 * 15 * 2; ++i) {
+                 write_byte(0x80 + i, (std::uint8_t)(i % 2 ? 0x00 : 0x04 + (i % 100)), unbuffered);
+                 if (i % 28 == 27) {
+                     run_for(5); // 28-byte chunks arrive over raw HID every few milliseconds
+                 }
+             }
+             run_for(WEAR_LEVELING_WRITE_BUFFER_IDLE_MS);
+         }},
+        // Holding down hue-increase, stepping the RGB config every 50ms for 3 seconds
+        {"RGB hue stepping", [this](bool unbuffered) {
+             for (std::uint32_t i = 0; i < 60; ++i) {
+                 write_byte(0x09, (std::uint8_t)(i * 8 + 1), unbuffered);
+                 run_for(50);
+             }
+             run_for(WEAR_LEVELING_WRITE_BUFFER_IDLE_MS);
+         }},
+    };
+
+    for (const auto& workload : workloads) {
+        for (bool unbuffered : {true, false}) {
+            SetUp();
+            for (int repeat = 0; repeat < 10; ++repeat) {
+                workload.run(unbuffered);
+            }
+            printf("[ WL BURST ] %-18s %-10s: %5d backing writes, %2d erases, worst-case stall %6d us\n", workload.name, unbuffered ? "unbuffered" : "buffered", (int)inst.total_write_count(), (int)inst.erasure_count(), (int)max_stall_us);
+        }
+    }
+}
@@ -5,6 +5,10 @@
 #include "wear_leveling.h"
 #include "wear_leveling_internal.h"
 
+#ifdef WEAR_LEVELING_WRITE_BUFFER
+#    include "timer.h"
+#endif // WEAR_LEVELING_WRITE_BUFFER
+
 /*
     This wear leveling algorithm is adapted from algorithms from previous
     implementations in QMK, namely:
@@ -61,12 +65,54 @@
             to other subsystems performing reads/writes. This must be a multiple
             of the write size.
 
+        - WEAR_LEVELING_PLAYBACK_CHUNK_SIZE: The number of bytes read from the
+            backing store at a time when playing back the write log. Defaults
+            to 64, and must be a multiple of 8.
+
+        - WEAR_LEVELING_WRITE_BUFFER: Optional. If defined, writes only
+            update the cache and are tracked as pending ranges, merged with
+            any overlapping or adjacent pending ranges. Pending ranges are
+            written to the log once no writes have occurred for
+            WEAR_LEVELING_WRITE_BUFFER_IDLE_MS, once the oldest has been
+            pending for WEAR_LEVELING_WRITE_BUFFER_MAX_STALENESS_MS, when more
+            than WEAR_LEVELING_WRITE_BUFFER_RANGES are required, or when
+            wear_leveling_flush() is invoked. Ranges separated by up to
+            WEAR_LEVELING_WRITE_BUFFER_MERGE_DISTANCE bytes are also merged.
+
+        - WEAR_LEVELING_CHECKPOINT_INTERVAL: Optional. If defined, a copy of
+            the logical data is written into the write log every this many
+            bytes, such that startup only needs to play back the entries
+            written after the latest checkpoint. Must be a multiple of the
+            write size, and larger than the logical size + 8 + the write size.
+
+        - WEAR_LEVELING_TWO_BANK: Optional. If defined, the backing store is
+            split into two banks, and consolidation is performed incrementally
+            into the inactive bank by wear_leveling_task(). The backing store
+            must implement backing_store_erase_range(). Cannot be combined
+            with WEAR_LEVELING_CHECKPOINT_INTERVAL.
+
+        - WEAR_LEVELING_ERASE_SIZE: The number of bytes erased per step of
+            two-bank consolidation, generally the sector size of the backing
+            store. Defaults to the size of a bank. Every step must cover whole
+            sectors; backing stores fail to initialise or erase otherwise, as
+            a partial sector cannot be erased without touching its neighbours.
+
+        - WEAR_LEVELING_CONSOLIDATION_STEP_SIZE: The number of bytes of logical
+            data copied per step of two-bank consolidation. Defaults to 64.
+
+        - WEAR_LEVELING_CONSOLIDATION_HEADROOM: Two-bank consolidation starts
+            once less than this many bytes of write log remain in the active
+            bank. Defaults to half of the write log.
+
     General algorithm:
 
         During initialization:
             * The contents of the consolidated data section are read into cache.
-            * The contents of the write log are "played back" and update the
-                cache accordingly.
+            * If checkpoints are enabled, the latest valid checkpoint is loaded
+                into cache.
+            * The end of the write log is located using a binary search.
+            * The contents of the write log are "played back" in chunks and
+                update the cache accordingly.
 
         During reads:
             * Logical data is served from the cache.
@@ -153,7 +199,67 @@
         ║  │Address >> 1 ║
         ║  └── Value: 1  ║
         ╚════════════════╝
-        0 <= Address <= 0x3FFE (16382) */
+        0 <= Address <= 0x3FFE (16382)
+
+    Locating the end of the write log:
+
+        The first backing store write of every log entry is non-zero, and no
+        log entry contains more than (8 / BACKING_STORE_WRITE_SIZE - 1) zero
+        writes after its first. As such, the first location followed by
+        (8 / BACKING_STORE_WRITE_SIZE) zero writes is at most one entry before
+        the end of the log, and can be found with a binary search. This only
+        dictates how much of the backing store is read during playback -- the
+        actual end of the log is still determined by playing back entries.
+
+    Checkpoints:
+
+        If WEAR_LEVELING_CHECKPOINT_INTERVAL is defined, checkpoints are placed
+        at fixed locations in the write log, every interval bytes after the
+        start of the log. Before a log entry would overlap a checkpoint
+        location, the remaining space is filled with padding entries and a
+        checkpoint is written, containing a copy of the cache followed by its
+        FNV1a_64 hash. The multi-byte entry type is reused for both, with
+        lengths that are otherwise invalid:
+
+        ╔ Padding ═══════╗   ╔ Checkpoint ═════╦══════════════╦══════════╗
+        ║00111000 ... 00 ║   ║00110000 ... 00  ║ Logical data ║ FNV1a_64 ║
+        ╚════════════════╝   ╚═════════════════╩══════════════╩══════════╝
+          one write            one write         logical size   8 bytes
+
+        Checkpoints are written in order, so the latest one can be found with
+        a binary search over the checkpoint locations. If its hash does not
+        match, earlier checkpoints are tried in turn, followed by the
+        consolidated data. During playback, any checkpoints encountered are
+        skipped over as the cache already contains the same data.
+
+    Two-bank consolidation:
+
+        If WEAR_LEVELING_TWO_BANK is defined, each half of the backing store
+        is a bank containing a header, the consolidated data, its FNV1a_64
+        hash, and a write log. Offsets described above are relative to the
+        start of the active bank.
+
+        ╔ Bank Header ═══════╦═════════════════╗
+        ║ Sequence (32 bits) ║ Magic (32 bits) ║
+        ╚════════════════════╩═════════════════╝
+
+        The active bank is the one with the latest sequence number whose
+        consolidated data matches its hash. If neither is valid, the backing
+        store is erased and the first bank is marked active.
+
+        Once the active bank's write log is running low on space, the periodic
+        task erases the inactive bank one WEAR_LEVELING_ERASE_SIZE at a time,
+        then copies the cache into it in WEAR_LEVELING_CONSOLIDATION_STEP_SIZE
+        chunks. From the start of copying, every write log entry appended to
+        the active bank is also mirrored into the inactive bank's write log,
+        as the copied data may not include it. Finally, the hash and the header
+        (with the next sequence number) are written, which atomically switches
+        the active bank. The previously-active bank is untouched until the
+        next consolidation, so a power loss at any point leaves a valid bank.
+
+        If the active bank's write log fills up before the periodic task has
+        completed consolidation, the remaining steps are performed immediately.
+        Log entries are never split across the end of a bank. */
 
 /**
  * Storage area for the wear-leveling cache.
@@ -162,8 +268,60 @@ static struct __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) {
     __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) uint8_t cache[(WEAR_LEVELING_LOGICAL_SIZE)];
     uint32_t                                                       write_address;
     bool                                                           unlocked;
+#ifdef WEAR_LEVELING_TWO_BANK
+    uint32_t bank_base;
+#endif // WEAR_LEVELING_TWO_BANK
 } wear_leveling;
 
+/**
+ * Extents of the active bank -- the entire backing store unless two-bank mode is enabled.
+ */
+#ifdef WEAR_LEVELING_TWO_BANK
+#    define WEAR_LEVELING_BANK_BASE (wear_leveling.bank_base)
+#else
+#    define WEAR_LEVELING_BANK_BASE 0
+#endif // WEAR_LEVELING_TWO_BANK
+#define WEAR_LEVELING_BANK_END ((WEAR_LEVELING_BANK_BASE) + (WEAR_LEVELING_BANK_SIZE))
+#define WEAR_LEVELING_CONSOLIDATED_ADDRESS ((WEAR_LEVELING_BANK_BASE) + (WEAR_LEVELING_BANK_HEADER_SIZE))
+#define WEAR_LEVELING_CHECKSUM_ADDRESS ((WEAR_LEVELING_CONSOLIDATED_ADDRESS) + (WEAR_LEVELING_LOGICAL_SIZE))
+
+#ifdef WEAR_LEVELING_TWO_BANK
+/**
+ * Incremental consolidation into the alternate bank.
+ */
+typedef enum wear_leveling_bank_state_t {
+    BANK_STATE_IDLE = 0,
+    BANK_STATE_ERASING,
+    BANK_STATE_COPYING,
+    BANK_STATE_COMMITTING,
+} wear_leveling_bank_state_t;
+
+static struct {
+    uint32_t sequence;      // sequence number of the active bank
+    uint8_t  state;         // current wear_leveling_bank_state_t
+    uint32_t progress;      // number of bytes erased or copied so far in the current state
+    uint32_t write_address; // next write location of the mirrored write log in the alternate bank
+    uint64_t checksum;      // running FNV1a_64 of the logical data copied so far
+} wear_leveling_bank;
+
+#    define WEAR_LEVELING_ALTERNATE_BANK_BASE ((WEAR_LEVELING_BANK_SIZE) - wear_leveling.bank_base)
+#endif // WEAR_LEVELING_TWO_BANK
+
+#ifdef WEAR_LEVELING_WRITE_BUFFER
+/**
+ * Pending logical ranges, not yet written to the backing store.
+ */
+static struct {
+    struct {
+        uint32_t start;
+        uint32_t end;
+    } ranges[(WEAR_LEVELING_WRITE_BUFFER_RANGES)];
+    uint8_t  count;
+    uint32_t first_write_time;
+    uint32_t last_write_time;
+} wear_leveling_buffer;
+#endif // WEAR_LEVELING_WRITE_BUFFER
+
 /**
  * Locking helper: status
  */
@@ -202,9 +360,33 @@ static inline backing_store_lock_status_t wear_leveling_lock(void) {
  */
 static void wear_leveling_clear_cache(void) {
     memset(wear_leveling.cache, 0, (WEAR_LEVELING_LOGICAL_SIZE));
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 is due to the FNV1a_64 of the consolidated buffer
+    wear_leveling.write_address = (WEAR_LEVELING_BANK_BASE) + (WEAR_LEVELING_LOG_START);
+#ifdef WEAR_LEVELING_WRITE_BUFFER
+    wear_leveling_buffer.count = 0;
+#endif // WEAR_LEVELING_WRITE_BUFFER
 }
 
+/**
+ * Reads an 8-byte value, such as a checksum, from the backing store.
+ */
+static bool wear_leveling_read_u64(uint32_t address, uint64_t *value) {
+    write_log_entry_t entry;
+    if (!backing_store_read_bulk(address, (backing_store_int_t *)entry.raw8, sizeof(entry) / sizeof(backing_store_int_t))) {
+        return false;
+    }
+    *value = entry.raw64;
+    return true;
+}
+
+/**
+ * Writes an 8-byte value, such as a checksum, to the backing store.
+ */
+static bool wear_leveling_write_u64(uint32_t address, uint64_t value) {
+    write_log_entry_t entry = {.raw64 = value};
+    return backing_store_write_bulk(address, (backing_store_int_t *)entry.raw8, sizeof(entry) / sizeof(backing_store_int_t));
+}
+
+#ifndef WEAR_LEVELING_TWO_BANK
 /**
  * Reads the consolidated data from the backing store into the cache.
  * Does not consider the write log.
@@ -213,26 +395,20 @@ static wear_leveling_status_t wear_leveling_read_consolidated(void) {
     wl_dprintf("Reading consolidated data\n");
 
     wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
-    if (!backing_store_read_bulk(0, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
+    if (!backing_store_read_bulk((WEAR_LEVELING_CONSOLIDATED_ADDRESS), (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
         wl_dprintf("Failed to read from backing store\n");
         status = WEAR_LEVELING_FAILED;
     }
 
     // Verify the FNV1a_64 result
     if (status != WEAR_LEVELING_FAILED) {
-        uint64_t          expected = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
-        write_log_entry_t entry;
+        uint64_t expected = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
+        uint64_t checksum = 0;
         wl_dprintf("Reading checksum\n");
-#if BACKING_STORE_WRITE_SIZE == 2
-        backing_store_read_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4);
-#elif BACKING_STORE_WRITE_SIZE == 4
-        backing_store_read_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2);
-#elif BACKING_STORE_WRITE_SIZE == 8
-        backing_store_read((WEAR_LEVELING_LOGICAL_SIZE) + 0, &entry.raw64);
-#endif
+        wear_leveling_read_u64((WEAR_LEVELING_CHECKSUM_ADDRESS), &checksum);
         // If we have a mismatch, clear the cache but do not flag a failure,
         // which will cater for the completely clean MCU case.
-        if (entry.raw64 == expected) {
+        if (checksum == expected) {
             wl_dprintf("Checksum matches, consolidated data is correct\n");
         } else {
             wl_dprintf("Checksum mismatch, clearing cache\n");
@@ -258,48 +434,215 @@ static wear_leveling_status_t wear_leveling_write_consolidated(void) {
 
     backing_store_lock_status_t lock_status = wear_leveling_unlock();
     wear_leveling_status_t      status      = WEAR_LEVELING_CONSOLIDATED;
-    if (!backing_store_write_bulk(0, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
+    if (!backing_store_write_bulk((WEAR_LEVELING_CONSOLIDATED_ADDRESS), (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
         wl_dprintf("Failed to write to backing store\n");
         status = WEAR_LEVELING_FAILED;
     }
 
     if (status != WEAR_LEVELING_FAILED) {
         // Write out the FNV1a_64 result of the consolidated data
-        write_log_entry_t entry;
-        entry.raw64 = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
         wl_dprintf("Writing checksum\n");
-        do {
-#if BACKING_STORE_WRITE_SIZE == 2
-            if (!backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4)) {
-                status = WEAR_LEVELING_FAILED;
+        if (!wear_leveling_write_u64((WEAR_LEVELING_CHECKSUM_ADDRESS), fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT))) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    if (lock_status == STATUS_SUCCESS) {
+        wear_leveling_lock();
+    }
+    return status;
+}
+
+#else
+/**
+ * Reads the sequence number from the header of the bank at the supplied address.
+ *
+ * @return the sequence number, or zero if the bank header is not valid
+ */
+static uint32_t wear_leveling_bank_sequence(uint32_t bank_base) {
+    write_log_entry_t header = {.raw64 = 0};
+    if (!wear_leveling_read_u64(bank_base, &header.raw64) || header.raw32[1] != (WEAR_LEVELING_BANK_MAGIC)) {
+        return 0;
+    }
+    return header.raw32[0];
+}
+
+/**
+ * Writes the header of the bank at the supplied address. The magic is written last, so a partially-written header is not valid.
+ */
+static bool wear_leveling_write_bank_header(uint32_t bank_base, uint32_t sequence) {
+    write_log_entry_t header = {.raw32 = {sequence, (WEAR_LEVELING_BANK_MAGIC)}};
+    return wear_leveling_write_u64(bank_base, header.raw64);
+}
+
+/**
+ * Erases the entire backing store, then marks the first bank as active with cleared logical data.
+ */
+static bool wear_leveling_format(void) {
+    wear_leveling.bank_base     = 0;
+    wear_leveling_bank.sequence = 1;
+    wear_leveling_bank.state    = BANK_STATE_IDLE;
+    wear_leveling_clear_cache();
+
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    bool                        ret         = lock_status != STATUS_FAILURE && backing_store_erase() && wear_leveling_write_u64((WEAR_LEVELING_CHECKSUM_ADDRESS), fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT)) && wear_leveling_write_bank_header(0, wear_leveling_bank.sequence);
+    if (lock_status == STATUS_SUCCESS) {
+        ret &= (wear_leveling_lock() != STATUS_FAILURE);
+    }
+    return ret;
+}
+
+/**
+ * Reads the consolidated data of the bank at the supplied address into the cache, verifying its FNV1a_64 hash.
+ */
+static bool wear_leveling_load_bank(uint32_t bank_base) {
+    uint64_t checksum       = 0;
+    wear_leveling.bank_base = bank_base;
+    return backing_store_read_bulk((WEAR_LEVELING_CONSOLIDATED_ADDRESS), (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t)) && wear_leveling_read_u64((WEAR_LEVELING_CHECKSUM_ADDRESS), &checksum) && checksum == fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
+}
+
+/**
+ * Selects the latest valid bank as the active bank and reads its consolidated data into the cache, formatting the
+ * backing store if neither bank is valid. Does not consider the write log.
+ */
+static wear_leveling_status_t wear_leveling_select_bank(void) {
+    const uint32_t sequences[2] = {wear_leveling_bank_sequence(0), wear_leveling_bank_sequence((WEAR_LEVELING_BANK_SIZE))};
+
+    // Try the latest bank first, comparing sequence numbers such that wraparound is handled
+    const uint8_t newest = (sequences[0] == 0 || (sequences[1] != 0 && (int32_t)(sequences[1] - sequences[0]) > 0)) ? 1 : 0;
+    for (uint8_t i = 0; i < 2; ++i) {
+        const uint8_t bank = i == 0 ? newest : 1 - newest;
+        if (sequences[bank] != 0 && wear_leveling_load_bank(bank * (WEAR_LEVELING_BANK_SIZE))) {
+            wl_dprintf("Using bank at 0x%04X, sequence %d\n", (int)wear_leveling.bank_base, (int)sequences[bank]);
+            wear_leveling.write_address = (WEAR_LEVELING_BANK_BASE) + (WEAR_LEVELING_LOG_START);
+            wear_leveling_bank.sequence = sequences[bank];
+            wear_leveling_bank.state    = BANK_STATE_IDLE;
+            return WEAR_LEVELING_SUCCESS;
+        }
+    }
+
+    wl_dprintf("No valid bank, formatting backing store\n");
+    return wear_leveling_format() ? WEAR_LEVELING_SUCCESS : WEAR_LEVELING_FAILED;
+}
+
+/**
+ * Starts incremental consolidation into the alternate bank.
+ */
+static void wear_leveling_bank_start(void) {
+    wl_dprintf("Starting consolidation into bank at 0x%04X\n", (int)(WEAR_LEVELING_ALTERNATE_BANK_BASE));
+    wear_leveling_bank.state    = BANK_STATE_ERASING;
+    wear_leveling_bank.progress = 0;
+}
+
+/**
+ * Performs a single bounded step of incremental consolidation into the alternate bank.
+ *
+ * @return WEAR_LEVELING_CONSOLIDATED once the alternate bank has become the active bank
+ */
+static wear_leveling_status_t wear_leveling_bank_step(void) {
+    const uint32_t alternate = (WEAR_LEVELING_ALTERNATE_BANK_BASE);
+    switch (wear_leveling_bank.state) {
+        case BANK_STATE_ERASING: {
+            if (!backing_store_erase_range(alternate + wear_leveling_bank.progress, (WEAR_LEVELING_ERASE_SIZE))) {
                 break;
             }
-#elif BACKING_STORE_WRITE_SIZE == 4
-            if (!backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2)) {
-                status = WEAR_LEVELING_FAILED;
+            wear_leveling_bank.progress += (WEAR_LEVELING_ERASE_SIZE);
+            if (wear_leveling_bank.progress >= (WEAR_LEVELING_BANK_SIZE)) {
+                // Any log entries written from now on are mirrored into the alternate bank, as they may not be included in the copied data
+                wear_leveling_bank.state         = BANK_STATE_COPYING;
+                wear_leveling_bank.progress      = 0;
+                wear_leveling_bank.checksum      = FNV1A_64_INIT;
+                wear_leveling_bank.write_address = alternate + (WEAR_LEVELING_LOG_START);
+            }
+            return WEAR_LEVELING_SUCCESS;
+        }
+
+        case BANK_STATE_COPYING: {
+            uint32_t length = (WEAR_LEVELING_LOGICAL_SIZE)-wear_leveling_bank.progress;
+            if (length > (WEAR_LEVELING_CONSOLIDATION_STEP_SIZE)) {
+                length = (WEAR_LEVELING_CONSOLIDATION_STEP_SIZE);
+            }
+            uint8_t *data = &wear_leveling.cache[wear_leveling_bank.progress];
+            if (!backing_store_write_bulk(alternate + (WEAR_LEVELING_BANK_HEADER_SIZE) + wear_leveling_bank.progress, (backing_store_int_t *)data, length / (BACKING_STORE_WRITE_SIZE))) {
                 break;
             }
-#elif BACKING_STORE_WRITE_SIZE == 8
-            if (!backing_store_write((WEAR_LEVELING_LOGICAL_SIZE), entry.raw64)) {
-                status = WEAR_LEVELING_FAILED;
+            wear_leveling_bank.checksum = fnv_64a_buf(data, length, wear_leveling_bank.checksum);
+            wear_leveling_bank.progress += length;
+            if (wear_leveling_bank.progress >= (WEAR_LEVELING_LOGICAL_SIZE)) {
+                wear_leveling_bank.state = BANK_STATE_COMMITTING;
+            }
+            return WEAR_LEVELING_SUCCESS;
+        }
+
+        case BANK_STATE_COMMITTING: {
+            uint32_t sequence = wear_leveling_bank.sequence + 1;
+            if (sequence == 0) {
+                sequence = 1;
+            }
+            // The alternate bank only becomes valid once its header is written, until then the active bank is left as-is
+            if (!wear_leveling_write_u64(alternate + (WEAR_LEVELING_BANK_HEADER_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE), wear_leveling_bank.checksum) || !wear_leveling_write_bank_header(alternate, sequence)) {
                 break;
             }
-#endif
-        } while (0);
+            wl_dprintf("Switched to bank at 0x%04X, sequence %d\n", (int)alternate, (int)sequence);
+            wear_leveling.bank_base     = alternate;
+            wear_leveling.write_address = wear_leveling_bank.write_address;
+            wear_leveling_bank.sequence = sequence;
+            wear_leveling_bank.state    = BANK_STATE_IDLE;
+            return WEAR_LEVELING_CONSOLIDATED;
+        }
+
+        default:
+            return WEAR_LEVELING_SUCCESS;
     }
 
-    if (lock_status == STATUS_SUCCESS) {
-        wear_leveling_lock();
+    wl_dprintf("Failed to write to alternate bank, abandoning consolidation\n");
+    wear_leveling_bank.state = BANK_STATE_IDLE;
+    return WEAR_LEVELING_FAILED;
+}
+
+/**
+ * Mirrors a write log slot into the alternate bank, once incremental consolidation has started copying data.
+ */
+static void wear_leveling_bank_mirror(backing_store_int_t value) {
+    if (wear_leveling_bank.state < BANK_STATE_COPYING) {
+        return;
     }
-    return status;
+    if (wear_leveling_bank.write_address >= (WEAR_LEVELING_ALTERNATE_BANK_BASE) + (WEAR_LEVELING_BANK_SIZE) || !backing_store_write(wear_leveling_bank.write_address, value)) {
+        wl_dprintf("Failed to mirror write log, abandoning consolidation\n");
+        wear_leveling_bank.state = BANK_STATE_IDLE;
+        return;
+    }
+    wear_leveling_bank.write_address += (BACKING_STORE_WRITE_SIZE);
 }
+#endif // WEAR_LEVELING_TWO_BANK
 
 /**
  * Forces a write of the current cache.
  * Erases the backing store, including the write log.
- * During this operation, there is the potential for data loss if a power loss occurs.
+ * During this operation, there is the potential for data loss if a power loss occurs, unless two-bank mode is enabled.
  */
 static wear_leveling_status_t wear_leveling_consolidate_force(void) {
+#ifdef WEAR_LEVELING_TWO_BANK
+    // Run any in-progress consolidation to completion, starting one if required
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
+    }
+
+    if (wear_leveling_bank.state == BANK_STATE_IDLE) {
+        wear_leveling_bank_start();
+    }
+    wear_leveling_status_t status;
+    do {
+        status = wear_leveling_bank_step();
+    } while (status == WEAR_LEVELING_SUCCESS);
+
+    if (lock_status == STATUS_SUCCESS) {
+        wear_leveling_lock();
+    }
+    return status;
+#else
     wl_dprintf("Erasing backing store\n");
 
     // Erase the backing store. Expectation is that any un-written values that are read back after this call come back as zero.
@@ -316,9 +659,10 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
     }
 
     // Next write of the log occurs after the consolidated values at the start of the backing store.
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
+    wear_leveling.write_address = (WEAR_LEVELING_LOG_START);
 
     return status;
+#endif // WEAR_LEVELING_TWO_BANK
 }
 
 /**
@@ -329,7 +673,7 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
  * @return true if consolidation occurred
  */
 static wear_leveling_status_t wear_leveling_consolidate_if_needed(void) {
-    if (wear_leveling.write_address >= (WEAR_LEVELING_BACKING_SIZE)) {
+    if (wear_leveling.write_address >= (WEAR_LEVELING_BANK_END)) {
         return wear_leveling_consolidate_force();
     }
 
@@ -348,8 +692,69 @@ static wear_leveling_status_t wear_leveling_append_raw(backing_store_int_t value
         return WEAR_LEVELING_FAILED;
     }
     wear_leveling.write_address += (BACKING_STORE_WRITE_SIZE);
+#ifdef WEAR_LEVELING_TWO_BANK
+    wear_leveling_bank_mirror(value);
+#endif // WEAR_LEVELING_TWO_BANK
+    return wear_leveling_consolidate_if_needed();
+}
+
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+/**
+ * Pads the write log up to the supplied checkpoint location, then writes the current cache as a checkpoint.
+ *
+ * @return true if consolidation occurred
+ */
+static wear_leveling_status_t wear_leveling_write_checkpoint(uint32_t checkpoint_address) {
+    wl_dprintf("Writing checkpoint at 0x%04X\n", (int)checkpoint_address);
+
+    // Pad out the remainder of the previous interval so that playback remains aligned to log entries
+    const write_log_entry_t padding = LOG_ENTRY_MAKE_PADDING();
+    while (wear_leveling.write_address < checkpoint_address) {
+        if (!backing_store_write(wear_leveling.write_address, LOG_ENTRY_FIRST_SLOT(padding))) {
+            wl_dprintf("Failed to write to backing store\n");
+            return WEAR_LEVELING_FAILED;
+        }
+        wear_leveling.write_address += (BACKING_STORE_WRITE_SIZE);
+    }
+
+    // Marker, followed by the logical data and its FNV1a_64 hash
+    const write_log_entry_t marker = LOG_ENTRY_MAKE_CHECKPOINT();
+    write_log_entry_t       checksum;
+    checksum.raw64 = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
+    if (!backing_store_write(checkpoint_address, LOG_ENTRY_FIRST_SLOT(marker)) || !backing_store_write_bulk(checkpoint_address + (BACKING_STORE_WRITE_SIZE), (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t)) || !backing_store_write_bulk(checkpoint_address + (BACKING_STORE_WRITE_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE), (backing_store_int_t *)checksum.raw8, sizeof(checksum) / sizeof(backing_store_int_t))) {
+        wl_dprintf("Failed to write checkpoint to backing store\n");
+        return WEAR_LEVELING_FAILED;
+    }
+
+    wear_leveling.write_address = checkpoint_address + (WEAR_LEVELING_CHECKPOINT_SIZE);
     return wear_leveling_consolidate_if_needed();
 }
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+
+/**
+ * Prepares for appending a log entry of the supplied size, writing a checkpoint if it would otherwise overlap the next
+ * checkpoint location, or consolidating if it would otherwise be split across the end of the bank.
+ *
+ * @return true if consolidation occurred
+ */
+static wear_leveling_status_t wear_leveling_prepare_append(size_t entry_size) {
+#ifdef WEAR_LEVELING_TWO_BANK
+    // The mirrored write log in the alternate bank must only ever contain complete entries
+    if (wear_leveling.write_address + entry_size > (WEAR_LEVELING_BANK_END)) {
+        return wear_leveling_consolidate_force();
+    }
+#endif // WEAR_LEVELING_TWO_BANK
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+    uint32_t index = (wear_leveling.write_address - (WEAR_LEVELING_LOG_START) + (WEAR_LEVELING_CHECKPOINT_INTERVAL)-1) / (WEAR_LEVELING_CHECKPOINT_INTERVAL);
+    if (index == 0) {
+        index = 1;
+    }
+    if (index <= (WEAR_LEVELING_CHECKPOINT_COUNT) && WEAR_LEVELING_CHECKPOINT_ADDRESS(index) < wear_leveling.write_address + entry_size) {
+        return wear_leveling_write_checkpoint(WEAR_LEVELING_CHECKPOINT_ADDRESS(index));
+    }
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+    return WEAR_LEVELING_SUCCESS;
+}
 
 /**
  * Handles writing multi_byte-encoded data to the backing store.
@@ -366,6 +771,11 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
     // Write to the backing store. See the multi-byte log format in the documentation header at the top of the file.
     wear_leveling_status_t status;
 #if BACKING_STORE_WRITE_SIZE == 2
+    status = wear_leveling_prepare_append(4 + (length > 1 ? 2 : 0) + (length > 3 ? 2 : 0));
+    if (status != WEAR_LEVELING_SUCCESS) {
+        return status;
+    }
+
     status = wear_leveling_append_raw(log.raw16[0]);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
@@ -390,6 +800,11 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
         }
     }
 #elif BACKING_STORE_WRITE_SIZE == 4
+    status = wear_leveling_prepare_append(4 + (length > 1 ? 4 : 0));
+    if (status != WEAR_LEVELING_SUCCESS) {
+        return status;
+    }
+
     status = wear_leveling_append_raw(log.raw32[0]);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
@@ -402,6 +817,11 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
         }
     }
 #elif BACKING_STORE_WRITE_SIZE == 8
+    status = wear_leveling_prepare_append(8);
+    if (status != WEAR_LEVELING_SUCCESS) {
+        return status;
+    }
+
     status = wear_leveling_append_raw(log.raw64);
     if (status != WEAR_LEVELING_SUCCESS) {
         return status;
@@ -424,7 +844,10 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
             const uint16_t v = ((uint16_t)p[1]) << 8 | p[0]; // don't just dereference a uint16_t here -- if unaligned it generates faults on some MCUs
             if (v == 0 || v == 1) {
                 const write_log_entry_t log = LOG_ENTRY_MAKE_WORD_01(address, v);
-                status                      = wear_leveling_append_raw(log.raw16[0]);
+                status                      = wear_leveling_prepare_append(BACKING_STORE_WRITE_SIZE);
+                if (status == WEAR_LEVELING_SUCCESS) {
+                    status = wear_leveling_append_raw(log.raw16[0]);
+                }
                 if (status != WEAR_LEVELING_SUCCESS) {
                     // If consolidation occurred, then the cache has already been written to the consolidated area. No need to continue.
                     // If a failure occurred, pass it on.
@@ -441,7 +864,10 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
         // Small-write optimizations - address<64:
         if (address < 64) {
             const write_log_entry_t log = LOG_ENTRY_MAKE_OPTIMIZED_64(address, *p);
-            status                      = wear_leveling_append_raw(log.raw16[0]);
+            status                      = wear_leveling_prepare_append(BACKING_STORE_WRITE_SIZE);
+            if (status == WEAR_LEVELING_SUCCESS) {
+                status = wear_leveling_append_raw(log.raw16[0]);
+            }
             if (status != WEAR_LEVELING_SUCCESS) {
                 // If consolidation occurred, then the cache has already been written to the consolidated area. No need to continue.
                 // If a failure occurred, pass it on.
@@ -469,18 +895,187 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
     return status;
 }
 
+/**
+ * Chunked reader for the write log, minimising the number of backing store transactions during playback.
+ */
+typedef struct wear_leveling_log_reader_t {
+    backing_store_int_t values[(WEAR_LEVELING_PLAYBACK_CHUNK_SIZE) / (BACKING_STORE_WRITE_SIZE)];
+    uint32_t            address; // backing store address of values[0]
+    uint32_t            count;   // number of valid entries in values[]
+    uint32_t            limit;   // expected end of the write log -- reads are only issued past this if playback continues beyond it
+} wear_leveling_log_reader_t;
+
+/**
+ * Reads a value from the write log, fetching the next chunk from the backing store if required.
+ */
+static bool wear_leveling_log_read(wear_leveling_log_reader_t *reader, uint32_t address, backing_store_int_t *value) {
+    if (address >= (WEAR_LEVELING_BANK_END)) {
+        return false;
+    }
+
+    if (address < reader->address || address >= reader->address + reader->count * (BACKING_STORE_WRITE_SIZE)) {
+        const uint32_t end   = reader->limit > address ? reader->limit : (WEAR_LEVELING_BANK_END);
+        uint32_t       count = (end - address) / (BACKING_STORE_WRITE_SIZE);
+        if (count > sizeof(reader->values) / sizeof(backing_store_int_t)) {
+            count = sizeof(reader->values) / sizeof(backing_store_int_t);
+        }
+        if (!backing_store_read_bulk(address, reader->values, count)) {
+            reader->count = 0;
+            return false;
+        }
+        reader->address = address;
+        reader->count   = count;
+    }
+
+    *value = reader->values[(address - reader->address) / (BACKING_STORE_WRITE_SIZE)];
+    return true;
+}
+
+/**
+ * Determines if an entire log entry's worth of the backing store is empty at the supplied address.
+ */
+static bool wear_leveling_log_window_empty(uint32_t address, bool *empty) {
+    backing_store_int_t values[8 / (BACKING_STORE_WRITE_SIZE)];
+    uint32_t            count = sizeof(values) / sizeof(backing_store_int_t);
+    if (address + count * (BACKING_STORE_WRITE_SIZE) > (WEAR_LEVELING_BANK_END)) {
+        count = ((WEAR_LEVELING_BANK_END)-address) / (BACKING_STORE_WRITE_SIZE);
+    }
+    if (!backing_store_read_bulk(address, values, count)) {
+        return false;
+    }
+
+    *empty = true;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (values[i] != 0) {
+            *empty = false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Finds the approximate end of the write log, starting at the supplied address. See "Locating the end of the write log"
+ * in the documentation header at the top of the file. Only valid if there are no checkpoints after the supplied address.
+ *
+ * @return an address at or after the end of the write log
+ */
+static uint32_t wear_leveling_find_log_end(uint32_t start) {
+    const uint32_t slots = ((WEAR_LEVELING_BANK_END)-start) / (BACKING_STORE_WRITE_SIZE);
+    uint32_t       lo    = 0;
+    uint32_t       hi    = slots;
+    bool           empty = false;
+
+    // Search forward in increasing steps first, so that a mostly-empty log only requires a few reads
+    for (uint32_t bound = 1; bound - 1 < slots; bound *= 2) {
+        if (!wear_leveling_log_window_empty(start + (bound - 1) * (BACKING_STORE_WRITE_SIZE), &empty)) {
+            return (WEAR_LEVELING_BANK_END); // let playback deal with the failure
+        }
+        if (empty) {
+            hi = bound - 1;
+            break;
+        }
+        lo = bound;
+    }
+
+    // Binary search for the first empty window
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (!wear_leveling_log_window_empty(start + mid * (BACKING_STORE_WRITE_SIZE), &empty)) {
+            return (WEAR_LEVELING_BANK_END); // let playback deal with the failure
+        }
+        if (empty) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    // The end of the log is within one entry of the first empty window, include the window in the result
+    uint32_t end = lo + 8 / (BACKING_STORE_WRITE_SIZE);
+    if (end > slots) {
+        end = slots;
+    }
+    return start + end * (BACKING_STORE_WRITE_SIZE);
+}
+
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+/**
+ * Determines if the checkpoint with the supplied index has been written.
+ */
+static bool wear_leveling_checkpoint_present(uint32_t index) {
+    backing_store_int_t value = 0;
+    return backing_store_read(WEAR_LEVELING_CHECKPOINT_ADDRESS(index), &value) && value != 0;
+}
+
+/**
+ * Loads the latest valid checkpoint into the cache, falling back to the consolidated data if there are none.
+ *
+ * @return the address within the write log that playback should start
+ */
+static uint32_t wear_leveling_load_checkpoint(uint32_t *log_end) {
+    // Checkpoints are written in order, so binary search for the latest one
+    uint32_t latest = 0;
+    uint32_t hi     = (WEAR_LEVELING_CHECKPOINT_COUNT);
+    while (latest < hi) {
+        const uint32_t mid = latest + (hi - latest + 1) / 2;
+        if (wear_leveling_checkpoint_present(mid)) {
+            latest = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    // Only regular log entries exist after the latest checkpoint
+    *log_end = wear_leveling_find_log_end(latest > 0 ? WEAR_LEVELING_CHECKPOINT_ADDRESS(latest) + (WEAR_LEVELING_CHECKPOINT_SIZE) : (WEAR_LEVELING_LOG_START));
+
+    bool cache_modified = false;
+    for (uint32_t index = latest; index > 0; --index) {
+        const uint32_t          address  = WEAR_LEVELING_CHECKPOINT_ADDRESS(index);
+        const write_log_entry_t expected = LOG_ENTRY_MAKE_CHECKPOINT();
+        write_log_entry_t       marker   = {.raw64 = 0};
+        write_log_entry_t       checksum = {.raw64 = 0};
+        if (!backing_store_read(address, &LOG_ENTRY_FIRST_SLOT(marker)) || LOG_ENTRY_FIRST_SLOT(marker) != LOG_ENTRY_FIRST_SLOT(expected)) {
+            wl_dprintf("Checkpoint %d missing marker\n", (int)index);
+            continue;
+        }
+
+        cache_modified = true;
+        if (backing_store_read_bulk(address + (BACKING_STORE_WRITE_SIZE), (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t)) && backing_store_read_bulk(address + (BACKING_STORE_WRITE_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE), (backing_store_int_t *)checksum.raw8, sizeof(checksum) / sizeof(backing_store_int_t)) && checksum.raw64 == fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT)) {
+            wl_dprintf("Loaded checkpoint %d\n", (int)index);
+            return address + (WEAR_LEVELING_CHECKPOINT_SIZE);
+        }
+
+        wl_dprintf("Checkpoint %d checksum mismatch\n", (int)index);
+    }
+
+    // No valid checkpoints, start over from the consolidated data
+    if (cache_modified) {
+        wear_leveling_read_consolidated();
+    }
+
+    return (WEAR_LEVELING_LOG_START);
+}
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+
 /**
  * "Replays" the write log from the backing store, updating the local cache with updated values.
  */
 static wear_leveling_status_t wear_leveling_playback_log(void) {
     wl_dprintf("Playback write log\n");
 
+    wear_leveling_log_reader_t reader = {.address = 0, .count = 0, .limit = (WEAR_LEVELING_BANK_END)};
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+    uint32_t address = wear_leveling_load_checkpoint(&reader.limit);
+#else
+    uint32_t address = (WEAR_LEVELING_BANK_BASE) + (WEAR_LEVELING_LOG_START);
+    reader.limit     = wear_leveling_find_log_end(address);
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+
     wear_leveling_status_t status          = WEAR_LEVELING_SUCCESS;
     bool                   cancel_playback = false;
-    uint32_t               address         = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
-    while (!cancel_playback && address < (WEAR_LEVELING_BACKING_SIZE)) {
+    while (!cancel_playback && address < (WEAR_LEVELING_BANK_END)) {
         backing_store_int_t value;
-        bool                ok = backing_store_read(address, &value);
+        bool                ok = wear_leveling_log_read(&reader, address, &value);
         if (!ok) {
             wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
             cancel_playback = true;
@@ -508,8 +1103,25 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
 
         switch (LOG_ENTRY_GET_TYPE(log)) {
             case LOG_ENTRY_TYPE_MULTIBYTE: {
+                const uint8_t l = LOG_ENTRY_MULTIBYTE_GET_LENGTH(log);
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+                if (l == LOG_ENTRY_MULTIBYTE_LENGTH_PADDING) {
+                    break;
+                }
+                if (l == LOG_ENTRY_MULTIBYTE_LENGTH_CHECKPOINT) {
+                    // Everything before the checkpoint has already been played back, so the cache already matches its contents
+                    address += (WEAR_LEVELING_CHECKPOINT_SIZE) - (BACKING_STORE_WRITE_SIZE);
+                    break;
+                }
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+                if (l > LOG_ENTRY_MULTIBYTE_MAX_BYTES) {
+                    cancel_playback = true;
+                    status          = WEAR_LEVELING_FAILED;
+                    break;
+                }
+
 #if BACKING_STORE_WRITE_SIZE == 2
-                ok = backing_store_read(address, &log.raw16[1]);
+                ok = wear_leveling_log_read(&reader, address, &log.raw16[1]);
                 if (!ok) {
                     wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                     cancel_playback = true;
@@ -519,7 +1131,6 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
                 address += (BACKING_STORE_WRITE_SIZE);
 #endif // BACKING_STORE_WRITE_SIZE == 2
                 const uint32_t a = LOG_ENTRY_MULTIBYTE_GET_ADDRESS(log);
-                const uint8_t  l = LOG_ENTRY_MULTIBYTE_GET_LENGTH(log);
 
                 if (a + l > (WEAR_LEVELING_LOGICAL_SIZE)) {
                     cancel_playback = true;
@@ -529,7 +1140,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
 
 #if BACKING_STORE_WRITE_SIZE == 2
                 if (l > 1) {
-                    ok = backing_store_read(address, &log.raw16[2]);
+                    ok = wear_leveling_log_read(&reader, address, &log.raw16[2]);
                     if (!ok) {
                         wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                         cancel_playback = true;
@@ -539,7 +1150,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
                     address += (BACKING_STORE_WRITE_SIZE);
                 }
                 if (l > 3) {
-                    ok = backing_store_read(address, &log.raw16[3]);
+                    ok = wear_leveling_log_read(&reader, address, &log.raw16[3]);
                     if (!ok) {
                         wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                         cancel_playback = true;
@@ -550,7 +1161,7 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
                 }
 #elif BACKING_STORE_WRITE_SIZE == 4
                 if (l > 1) {
-                    ok = backing_store_read(address, &log.raw32[1]);
+                    ok = wear_leveling_log_read(&reader, address, &log.raw32[1]);
                     if (!ok) {
                         wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
                         cancel_playback = true;
@@ -611,6 +1222,49 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
     return status;
 }
 
+static wear_leveling_status_t wear_leveling_write_log(const uint32_t address, const void *value, size_t length);
+
+#ifdef WEAR_LEVELING_WRITE_BUFFER
+/**
+ * Tracks the supplied logical range as pending, merging with any overlapping or adjacent pending ranges.
+ */
+static wear_leveling_status_t wear_leveling_buffer_append(uint32_t start, uint32_t end) {
+    bool first_pending = wear_leveling_buffer.count == 0;
+    for (uint8_t i = 0; i < wear_leveling_buffer.count;) {
+        // Ranges separated by only a few unchanged bytes are also merged, as a single log entry covering both is smaller than two separate entries
+        if (start <= wear_leveling_buffer.ranges[i].end + (WEAR_LEVELING_WRITE_BUFFER_MERGE_DISTANCE) && end + (WEAR_LEVELING_WRITE_BUFFER_MERGE_DISTANCE) >= wear_leveling_buffer.ranges[i].start) {
+            // Absorb the existing range, then remove it so that the merged range can be checked against the others
+            start                          = start < wear_leveling_buffer.ranges[i].start ? start : wear_leveling_buffer.ranges[i].start;
+            end                            = end > wear_leveling_buffer.ranges[i].end ? end : wear_leveling_buffer.ranges[i].end;
+            wear_leveling_buffer.ranges[i] = wear_leveling_buffer.ranges[--wear_leveling_buffer.count];
+        } else {
+            ++i;
+        }
+    }
+
+    // Out of space, write out everything currently pending
+    wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
+    if (wear_leveling_buffer.count >= (WEAR_LEVELING_WRITE_BUFFER_RANGES)) {
+        wl_dprintf("Write buffer full, flushing\n");
+        status = wear_leveling_flush();
+        if (status == WEAR_LEVELING_FAILED) {
+            return status;
+        }
+        first_pending = true;
+    }
+
+    const uint32_t now = timer_read32();
+    if (first_pending) {
+        wear_leveling_buffer.first_write_time = now;
+    }
+    wear_leveling_buffer.last_write_time                          = now;
+    wear_leveling_buffer.ranges[wear_leveling_buffer.count].start = start;
+    wear_leveling_buffer.ranges[wear_leveling_buffer.count].end   = end;
+    wear_leveling_buffer.count++;
+    return status;
+}
+#endif // WEAR_LEVELING_WRITE_BUFFER
+
 /**
  * Wear-leveling initialization
  */
@@ -628,7 +1282,11 @@ wear_leveling_status_t wear_leveling_init(void) {
     }
 
     // Read the previous consolidated values, then replay the existing write log so that the cache has the "live" values
+#ifdef WEAR_LEVELING_TWO_BANK
+    wear_leveling_status_t status = wear_leveling_select_bank();
+#else
     wear_leveling_status_t status = wear_leveling_read_consolidated();
+#endif // WEAR_LEVELING_TWO_BANK
     if (status == WEAR_LEVELING_FAILED) {
         // If it failed, clear the cache and return with failure
         wear_leveling_clear_cache();
@@ -660,7 +1318,11 @@ wear_leveling_status_t wear_leveling_erase(void) {
     }
 
     // Perform the erase
+#ifdef WEAR_LEVELING_TWO_BANK
+    bool ret = wear_leveling_format();
+#else
     bool ret = backing_store_erase();
+#endif // WEAR_LEVELING_TWO_BANK
     wear_leveling_clear_cache();
 
     // Lock the backing store if we acquired the lock successfully
@@ -691,6 +1353,93 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
     // Update the cache before writing to the backing store -- if we hit the end of the backing store during writes to the log then we'll force a consolidation in-line
     memcpy(&wear_leveling.cache[address], value, length);
 
+#ifdef WEAR_LEVELING_WRITE_BUFFER
+    return wear_leveling_buffer_append(address, address + (uint32_t)length);
+#else
+    return wear_leveling_write_log(address, value, length);
+#endif // WEAR_LEVELING_WRITE_BUFFER
+}
+
+/**
+ * Writes all pending logical data into the backing store.
+ */
+wear_leveling_status_t wear_leveling_flush(void) {
+#ifdef WEAR_LEVELING_WRITE_BUFFER
+    if (wear_leveling_buffer.count == 0) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    wl_dprintf("Flushing %d pending ranges\n", (int)wear_leveling_buffer.count);
+
+    // Unlock once for the whole flush, rather than once per range
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
+    }
+
+    wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
+    while (wear_leveling_buffer.count > 0) {
+        const uint32_t start = wear_leveling_buffer.ranges[wear_leveling_buffer.count - 1].start;
+        const uint32_t end   = wear_leveling_buffer.ranges[wear_leveling_buffer.count - 1].end;
+        status               = wear_leveling_write_log(start, &wear_leveling.cache[start], end - start);
+        if (status == WEAR_LEVELING_FAILED) {
+            // Leave the range pending so that it is retried on the next flush
+            break;
+        }
+
+        wear_leveling_buffer.count--;
+        if (status == WEAR_LEVELING_CONSOLIDATED) {
+            // Consolidation wrote out the entire cache, including any other pending ranges
+            wear_leveling_buffer.count = 0;
+        }
+    }
+
+    if (lock_status == STATUS_SUCCESS) {
+        if (wear_leveling_lock() == STATUS_FAILURE) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    return status;
+#else
+    return WEAR_LEVELING_SUCCESS;
+#endif // WEAR_LEVELING_WRITE_BUFFER
+}
+
+/**
+ * Periodic task, writes pending logical data into the backing store once idle or stale, and performs incremental
+ * consolidation one step at a time.
+ */
+void wear_leveling_task(void) {
+#ifdef WEAR_LEVELING_WRITE_BUFFER
+    if (wear_leveling_buffer.count > 0 && (timer_elapsed32(wear_leveling_buffer.last_write_time) >= (WEAR_LEVELING_WRITE_BUFFER_IDLE_MS) || timer_elapsed32(wear_leveling_buffer.first_write_time) >= (WEAR_LEVELING_WRITE_BUFFER_MAX_STALENESS_MS))) {
+        wear_leveling_flush();
+    }
+#endif // WEAR_LEVELING_WRITE_BUFFER
+#ifdef WEAR_LEVELING_TWO_BANK
+    if (wear_leveling_bank.state == BANK_STATE_IDLE && (WEAR_LEVELING_BANK_END)-wear_leveling.write_address < (WEAR_LEVELING_CONSOLIDATION_HEADROOM)) {
+        wear_leveling_bank_start();
+    }
+
+    if (wear_leveling_bank.state != BANK_STATE_IDLE) {
+        backing_store_lock_status_t lock_status = wear_leveling_unlock();
+        if (lock_status == STATUS_FAILURE) {
+            wear_leveling_lock();
+            return;
+        }
+        wear_leveling_bank_step();
+        if (lock_status == STATUS_SUCCESS) {
+            wear_leveling_lock();
+        }
+    }
+#endif // WEAR_LEVELING_TWO_BANK
+}
+
+/**
+ * Handles writing logical data into the write log, unlocking the backing store if required.
+ */
+static wear_leveling_status_t wear_leveling_write_log(const uint32_t address, const void *value, size_t length) {
     // Unlock the backing store
     backing_store_lock_status_t lock_status = wear_leveling_unlock();
     if (lock_status == STATUS_FAILURE) {
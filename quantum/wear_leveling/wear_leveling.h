@@ -43,6 +43,22 @@ wear_leveling_status_t wear_leveling_erase(void);
  */
 wear_leveling_status_t wear_leveling_write(uint32_t address, const void* value, size_t length);
 
+/**
+ * Writes any buffered logical data into the backing store.
+ *
+ * Only has an effect if WEAR_LEVELING_WRITE_BUFFER is enabled, and should be invoked before any reset or power loss.
+ *
+ * @return Status of the request
+ */
+wear_leveling_status_t wear_leveling_flush(void);
+
+/**
+ * Wear-leveling periodic task.
+ *
+ * Writes buffered logical data into the backing store once writes are idle, or pending data has become too stale.
+ */
+void wear_leveling_task(void);
+
 /**
  * Reads logical data from the cache.
  *
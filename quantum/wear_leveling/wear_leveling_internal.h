@@ -66,6 +66,82 @@ _Static_assert(WEAR_LEVELING_BACKING_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 2), "
 _Static_assert(WEAR_LEVELING_LOGICAL_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Logical size must be a multiple of write size");
 _Static_assert(WEAR_LEVELING_BACKING_SIZE % WEAR_LEVELING_LOGICAL_SIZE == 0, "Backing size must be a multiple of logical size");
 
+// Number of bytes read from the backing store at a time during write log playback
+#ifndef WEAR_LEVELING_PLAYBACK_CHUNK_SIZE
+#    define WEAR_LEVELING_PLAYBACK_CHUNK_SIZE 64
+#endif // WEAR_LEVELING_PLAYBACK_CHUNK_SIZE
+
+_Static_assert(WEAR_LEVELING_PLAYBACK_CHUNK_SIZE % 8 == 0, "Playback chunk size must be a multiple of the log entry size");
+
+#ifdef WEAR_LEVELING_WRITE_BUFFER
+// Number of distinct pending ranges that can be buffered before a flush is forced
+#    ifndef WEAR_LEVELING_WRITE_BUFFER_RANGES
+#        define WEAR_LEVELING_WRITE_BUFFER_RANGES 8
+#    endif // WEAR_LEVELING_WRITE_BUFFER_RANGES
+// Maximum number of unchanged bytes between two pending ranges for them to be merged
+#    ifndef WEAR_LEVELING_WRITE_BUFFER_MERGE_DISTANCE
+#        define WEAR_LEVELING_WRITE_BUFFER_MERGE_DISTANCE 4
+#    endif // WEAR_LEVELING_WRITE_BUFFER_MERGE_DISTANCE
+// Time without any writes before pending writes are flushed
+#    ifndef WEAR_LEVELING_WRITE_BUFFER_IDLE_MS
+#        define WEAR_LEVELING_WRITE_BUFFER_IDLE_MS 500
+#    endif // WEAR_LEVELING_WRITE_BUFFER_IDLE_MS
+// Maximum time a write may remain pending, regardless of further writes
+#    ifndef WEAR_LEVELING_WRITE_BUFFER_MAX_STALENESS_MS
+#        define WEAR_LEVELING_WRITE_BUFFER_MAX_STALENESS_MS 5000
+#    endif // WEAR_LEVELING_WRITE_BUFFER_MAX_STALENESS_MS
+
+_Static_assert(WEAR_LEVELING_WRITE_BUFFER_RANGES > 0 && WEAR_LEVELING_WRITE_BUFFER_RANGES <= 255, "Write buffer range count must be between 1 and 255");
+#endif // WEAR_LEVELING_WRITE_BUFFER
+
+#ifdef WEAR_LEVELING_TWO_BANK
+// Each bank holds a header, the consolidated data and its FNV1a_64 checksum, and its own write log
+#    define WEAR_LEVELING_BANK_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+// Size of the bank header: sequence number, then magic
+#    define WEAR_LEVELING_BANK_HEADER_SIZE 8
+#    define WEAR_LEVELING_BANK_MAGIC 0x4B4E4257 // "WBNK"
+// Number of bytes erased from the alternate bank per step of incremental consolidation
+#    ifndef WEAR_LEVELING_ERASE_SIZE
+#        define WEAR_LEVELING_ERASE_SIZE (WEAR_LEVELING_BANK_SIZE)
+#    endif // WEAR_LEVELING_ERASE_SIZE
+// Number of bytes of logical data copied into the alternate bank per step of incremental consolidation
+#    ifndef WEAR_LEVELING_CONSOLIDATION_STEP_SIZE
+#        define WEAR_LEVELING_CONSOLIDATION_STEP_SIZE 64
+#    endif // WEAR_LEVELING_CONSOLIDATION_STEP_SIZE
+// Incremental consolidation starts once less than this many bytes of write log remain in the active bank
+#    ifndef WEAR_LEVELING_CONSOLIDATION_HEADROOM
+#        define WEAR_LEVELING_CONSOLIDATION_HEADROOM (((WEAR_LEVELING_BANK_SIZE) - (WEAR_LEVELING_LOG_START)) / 2)
+#    endif // WEAR_LEVELING_CONSOLIDATION_HEADROOM
+#else
+#    define WEAR_LEVELING_BANK_SIZE (WEAR_LEVELING_BACKING_SIZE)
+#    define WEAR_LEVELING_BANK_HEADER_SIZE 0
+#endif // WEAR_LEVELING_TWO_BANK
+
+// Location of the write log relative to the start of the bank, after the consolidated data and its FNV1a_64 checksum
+#define WEAR_LEVELING_LOG_START ((WEAR_LEVELING_BANK_HEADER_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE) + 8)
+
+#ifdef WEAR_LEVELING_TWO_BANK
+_Static_assert(WEAR_LEVELING_BACKING_SIZE % (WEAR_LEVELING_ERASE_SIZE * 2) == 0, "Backing size must be an even number of erase sizes");
+_Static_assert(WEAR_LEVELING_BANK_SIZE >= (WEAR_LEVELING_LOG_START + 64), "Bank size must leave room for the write log");
+_Static_assert(WEAR_LEVELING_CONSOLIDATION_STEP_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Consolidation step size must be a multiple of write size");
+_Static_assert(WEAR_LEVELING_CONSOLIDATION_HEADROOM > 0 && WEAR_LEVELING_CONSOLIDATION_HEADROOM < (WEAR_LEVELING_BANK_SIZE - WEAR_LEVELING_LOG_START), "Consolidation headroom must fit within the write log");
+#    ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+#        error WEAR_LEVELING_CHECKPOINT_INTERVAL cannot be used with WEAR_LEVELING_TWO_BANK.
+#    endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+#endif // WEAR_LEVELING_TWO_BANK
+
+#ifdef WEAR_LEVELING_CHECKPOINT_INTERVAL
+// Size of a checkpoint record: marker, copy of the logical data, FNV1a_64 checksum
+#    define WEAR_LEVELING_CHECKPOINT_SIZE ((BACKING_STORE_WRITE_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE) + 8)
+// Number of checkpoint locations available in the write log
+#    define WEAR_LEVELING_CHECKPOINT_COUNT (((WEAR_LEVELING_BACKING_SIZE) - (WEAR_LEVELING_LOG_START) - (WEAR_LEVELING_CHECKPOINT_SIZE)) / (WEAR_LEVELING_CHECKPOINT_INTERVAL))
+// Backing store address of the checkpoint with the specified index, 1-based
+#    define WEAR_LEVELING_CHECKPOINT_ADDRESS(index) ((WEAR_LEVELING_LOG_START) + ((uint32_t)(index)) * (WEAR_LEVELING_CHECKPOINT_INTERVAL))
+
+_Static_assert(WEAR_LEVELING_CHECKPOINT_INTERVAL % BACKING_STORE_WRITE_SIZE == 0, "Checkpoint interval must be a multiple of write size");
+_Static_assert(WEAR_LEVELING_CHECKPOINT_INTERVAL >= (WEAR_LEVELING_CHECKPOINT_SIZE + 8), "Checkpoint interval must leave room for log entries after each checkpoint");
+#endif // WEAR_LEVELING_CHECKPOINT_INTERVAL
+
 // Backing Store API, to be implemented elsewhere by flash driver etc.
 bool backing_store_init(void);
 bool backing_store_unlock(void);
@@ -75,6 +151,9 @@ bool backing_store_write_bulk(uint32_t address, backing_store_int_t* values, siz
 bool backing_store_lock(void);
 bool backing_store_read(uint32_t address, backing_store_int_t* value);
 bool backing_store_read_bulk(uint32_t address, backing_store_int_t* values, size_t item_count); // weak implementation already provided, optimized implementation can be implemented by driver
+#ifdef WEAR_LEVELING_TWO_BANK
+bool backing_store_erase_range(uint32_t address, uint32_t length); // erases [address, address + length), which is aligned to WEAR_LEVELING_ERASE_SIZE
+#endif // WEAR_LEVELING_TWO_BANK
 
 /**
  * Helper type used to contain a write log entry.
@@ -88,6 +167,17 @@ typedef union write_log_entry_t {
 
 _Static_assert(sizeof(write_log_entry_t) == 8, "Wear leveling write log entry size was not 8");
 
+/**
+ * Accessor for the first backing store write of a write log entry.
+ */
+#if BACKING_STORE_WRITE_SIZE == 2
+#    define LOG_ENTRY_FIRST_SLOT(entry) ((entry).raw16[0])
+#elif BACKING_STORE_WRITE_SIZE == 4
+#    define LOG_ENTRY_FIRST_SLOT(entry) ((entry).raw32[0])
+#elif BACKING_STORE_WRITE_SIZE == 8
+#    define LOG_ENTRY_FIRST_SLOT(entry) ((entry).raw64)
+#endif
+
 /**
  * Log entry type discriminator.
  */
@@ -111,6 +201,8 @@ _Static_assert(LOG_ENTRY_TYPES <= (1 << 2), "Too many log entry types to fit int
 #define LOG_ENTRY_GET_TYPE(entry) (((entry).raw8[0] >> 6) & BITMASK_FOR_BITCOUNT(2))
 
 #define LOG_ENTRY_MULTIBYTE_MAX_BYTES 5
+#define LOG_ENTRY_MULTIBYTE_LENGTH_CHECKPOINT 6
+#define LOG_ENTRY_MULTIBYTE_LENGTH_PADDING 7
 #define LOG_ENTRY_MULTIBYTE_GET_ADDRESS(entry) (((((uint32_t)((entry).raw8[0])) & BITMASK_FOR_BITCOUNT(3)) << 16) | (((uint32_t)((entry).raw8[1])) << 8) | (entry).raw8[2])
 #define LOG_ENTRY_MULTIBYTE_GET_LENGTH(entry) ((uint8_t)(((entry).raw8[0] >> 3) & BITMASK_FOR_BITCOUNT(3)))
 #define LOG_ENTRY_MAKE_MULTIBYTE(address, length)                                                       \
@@ -125,6 +217,9 @@ _Static_assert(LOG_ENTRY_TYPES <= (1 << 2), "Too many log entry types to fit int
         }                                                                                               \
     }
 
+#define LOG_ENTRY_MAKE_CHECKPOINT() LOG_ENTRY_MAKE_MULTIBYTE(0, LOG_ENTRY_MULTIBYTE_LENGTH_CHECKPOINT)
+#define LOG_ENTRY_MAKE_PADDING() LOG_ENTRY_MAKE_MULTIBYTE(0, LOG_ENTRY_MULTIBYTE_LENGTH_PADDING)
+
 #define LOG_ENTRY_OPTIMIZED_64_GET_ADDRESS(entry) ((uint32_t)((entry).raw8[0] & BITMASK_FOR_BITCOUNT(6)))
 #define LOG_ENTRY_OPTIMIZED_64_GET_VALUE(entry) ((entry).raw8[1])
 #define LOG_ENTRY_MAKE_OPTIMIZED_64(address, value)                                                        \
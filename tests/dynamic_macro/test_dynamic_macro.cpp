@@ -0,0 +1,45 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+
+class DynamicMacro : public TestFixture {};
+
+TEST_F(DynamicMacro, ReplayUsesLayersActiveAtReplay) {
+    TestDriver driver;
+    auto       key_a    = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b    = KeymapKey(1, 0, 0, KC_B);
+    auto       record   = KeymapKey(0, 1, 0, DM_REC1);
+    auto       stop     = KeymapKey(0, 2, 0, DM_RSTP);
+    auto       play     = KeymapKey(0, 3, 0, DM_PLY1);
+    auto       record_1 = KeymapKey(1, 1, 0, KC_TRNS);
+    auto       stop_1   = KeymapKey(1, 2, 0, KC_TRNS);
+    auto       play_1   = KeymapKey(1, 3, 0, KC_TRNS);
+
+    set_keymap({key_a, key_b, record, stop, play, record_1, stop_1, play_1});
+
+    /* Record a tap of the key while layer 1 is on */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_key(record);
+    layer_on(1);
+    EXPECT_REPORT(driver, (KC_B));
+    tap_key(key_b);
+    tap_key(stop);
+    layer_off(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Replayed on layer 0, the same key sends the keycode of layer 0 */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A)).Times(2);
+    EXPECT_REPORT(driver, (KC_B)).Times(0);
+    tap_key(play);
+    tap_key(play);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,142 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "eeprom.h"
+#include "eeprom_mock.h"
+}
+
+class Eeconfig : public TestFixture {
+   public:
+    void SetUp() override {
+        eeconfig_init_quantum();
+        eeprom_mock_reset_stats();
+    }
+};
+
+TEST_F(Eeconfig, UpdatesStagedUntilCommit) {
+    eeconfig_transaction_begin();
+    EXPECT_TRUE(eeconfig_in_transaction());
+    eeconfig_update_kb(0x12345678);
+    eeconfig_update_user(0x9ABCDEF0);
+
+    EXPECT_EQ(eeconfig_read_kb(), 0x12345678);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_KEYBOARD), 0);
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 0);
+
+    eeconfig_transaction_commit();
+    EXPECT_FALSE(eeconfig_in_transaction());
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_KEYBOARD), 0x12345678);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_USER), 0x9ABCDEF0);
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+    EXPECT_EQ(eeprom_mock_get_stats().bytes_written, 8);
+}
+
+TEST_F(Eeconfig, UnchangedValuesNotWritten) {
+    eeconfig_transaction_begin();
+    eeconfig_update_debug(eeconfig_read_debug());
+    eeconfig_update_kb(eeconfig_read_kb());
+    eeconfig_transaction_commit();
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 0);
+
+    // A value changed and then restored within the transaction is not rewritten either
+    eeconfig_transaction_begin();
+    eeconfig_update_default_layer(1);
+    eeconfig_update_default_layer(0);
+    eeconfig_transaction_commit();
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 0);
+}
+
+TEST_F(Eeconfig, CommitTrimsToChangedRange) {
+    eeconfig_transaction_begin();
+    eeconfig_update_debug(0x01);
+    eeconfig_update_user(0x00000002);
+    eeconfig_transaction_commit();
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+    EXPECT_EQ(eeprom_mock_get_stats().bytes_written, (uintptr_t)EECONFIG_USER - (uintptr_t)EECONFIG_DEBUG + 1);
+}
+
+TEST_F(Eeconfig, NestedTransactionsCommitOnce) {
+    eeconfig_transaction_begin();
+    eeconfig_update_kb(1);
+    eeconfig_transaction_begin();
+    eeconfig_update_user(2);
+    eeconfig_transaction_commit();
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 0);
+    EXPECT_TRUE(eeconfig_in_transaction());
+    eeconfig_transaction_commit();
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+    EXPECT_EQ(eeconfig_read_kb(), 1);
+    EXPECT_EQ(eeconfig_read_user(), 2);
+}
+
+TEST_F(Eeconfig, UpdatesOutsideBlockBypassStaging) {
+    uint8_t value = 0x5A;
+    eeconfig_transaction_begin();
+    eeconfig_update_block(&value, (void *)EECONFIG_SIZE, sizeof(value));
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+    EXPECT_EQ(eeprom_read_byte((const uint8_t *)EECONFIG_SIZE), 0x5A);
+    eeconfig_transaction_commit();
+}
+
+TEST_F(Eeconfig, InitQuantumIsSingleWrite) {
+    eeconfig_update_kb(0xFFFFFFFF);
+    eeconfig_disable();
+    EXPECT_FALSE(eeconfig_is_enabled());
+    eeprom_mock_reset_stats();
+
+    eeconfig_init_quantum();
+    EXPECT_TRUE(eeconfig_is_enabled());
+    EXPECT_EQ(eeconfig_read_kb(), 0);
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+}
+
+TEST_F(Eeconfig, ReadsServedFromImage) {
+    eeconfig_read_debug();
+    eeconfig_read_default_layer();
+    eeconfig_read_keymap();
+    eeconfig_read_kb();
+    eeconfig_read_user();
+    eeconfig_read_handedness();
+    EXPECT_TRUE(eeconfig_is_enabled());
+    EXPECT_EQ(eeprom_mock_get_stats().reads, 0);
+}
+
+TEST_F(Eeconfig, UpdatesWriteThrough) {
+    eeconfig_update_kb(0x01020304);
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_KEYBOARD), 0x01020304);
+
+    eeconfig_update_kb(0x01020304);
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+}
+
+TEST_F(Eeconfig, DirectWritesNotClobbered) {
+    eeprom_update_byte(EECONFIG_HANDEDNESS, 0xAA);
+    eeprom_mock_reset_stats();
+
+    eeconfig_transaction_begin();
+    eeconfig_update_debug(0x01);
+    eeconfig_update_user(0x00000002);
+    eeconfig_transaction_commit();
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+    EXPECT_EQ(eeprom_read_byte(EECONFIG_HANDEDNESS), 0xAA);
+}
+
+TEST_F(Eeconfig, DirectWritesVisibleAfterCommit) {
+    eeconfig_transaction_begin();
+    eeconfig_update_kb(1);
+    eeprom_update_dword(EECONFIG_USER, 0x55);
+    eeconfig_transaction_commit();
+    EXPECT_EQ(eeconfig_read_kb(), 1);
+    EXPECT_EQ(eeconfig_read_user(), 0x55);
+
+    // Also when the transaction has nothing staged
+    eeconfig_transaction_begin();
+    eeprom_update_dword(EECONFIG_USER, 0x66);
+    eeconfig_transaction_commit();
+    EXPECT_EQ(eeconfig_read_user(), 0x66);
+}
@@ -0,0 +1,51 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+
+extern "C" {
+#include "eeprom.h"
+#include "eeprom_mock.h"
+}
+
+class EeconfigFlushDelay : public TestFixture {
+   public:
+    void SetUp() override {
+        eeconfig_init_quantum();
+        eeconfig_flush();
+        eeprom_mock_reset_stats();
+    }
+};
+
+TEST_F(EeconfigFlushDelay, ChangesBatchedUntilDelayElapses) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    eeconfig_update_kb(1);
+    idle_for(EECONFIG_FLUSH_DELAY_MS / 2);
+    eeconfig_update_user(2);
+    eeconfig_update_debug(3);
+    idle_for(EECONFIG_FLUSH_DELAY_MS / 2);
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 0);
+    EXPECT_EQ(eeconfig_read_user(), 2);
+
+    idle_for(EECONFIG_FLUSH_DELAY_MS);
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_KEYBOARD), 1);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_USER), 2);
+    EXPECT_EQ(eeprom_read_byte(EECONFIG_DEBUG), 3);
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(EeconfigFlushDelay, ExplicitFlush) {
+    eeconfig_update_kb(4);
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 0);
+    eeconfig_flush();
+    EXPECT_EQ(eeprom_mock_get_stats().writes, 1);
+    EXPECT_EQ(eeprom_read_dword(EECONFIG_KEYBOARD), 4);
+}
@@ -0,0 +1,127 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class KeymapLookups : public TestFixture {
+   protected:
+    uint32_t lookups_since(uint32_t &start) {
+        uint32_t lookups = keymap_lookups - start;
+        start            = keymap_lookups;
+        return lookups;
+    }
+};
+
+TEST_F(KeymapLookups, RegularKeyIsLookedUpOncePerEvent) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+    uint32_t start = keymap_lookups;
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    EXPECT_EQ(lookups_since(start), 1);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    EXPECT_EQ(lookups_since(start), 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeymapLookups, TappedModTapIsLookedUpOncePerEvent) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+    uint32_t start = keymap_lookups;
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    EXPECT_EQ(lookups_since(start), 1);
+
+    /* Scans while the tap is pending check the tapping term of the key */
+    idle_for(TAPPING_TERM / 2);
+    EXPECT_EQ(lookups_since(start), 0);
+
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_key.release();
+    run_one_scan_loop();
+    EXPECT_EQ(lookups_since(start), 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeymapLookups, HeldModTapIsLookedUpOncePerEvent) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+    auto       key_a       = KeymapKey(0, 1, 0, KC_A);
+
+    set_keymap({mod_tap_key, key_a});
+    uint32_t start = keymap_lookups;
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    key_a.press();
+    run_one_scan_loop();
+    EXPECT_EQ(lookups_since(start), 1) << "The interrupting key waits behind the mod-tap and is not looked up yet";
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_A));
+    idle_for(TAPPING_TERM);
+    EXPECT_EQ(lookups_since(start), 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    mod_tap_key.release();
+    run_one_scan_loop();
+    EXPECT_EQ(lookups_since(start), 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeymapLookups, KeyWaitingBehindLayerTapResolvesOnHeldLayer) {
+    TestDriver driver;
+    InSequence s;
+    auto       layer_tap_key = KeymapKey(0, 0, 0, LT(1, KC_P));
+    auto       key_a         = KeymapKey(0, 1, 0, KC_A);
+    auto       key_b         = KeymapKey(1, 1, 0, KC_B);
+
+    set_keymap({layer_tap_key, KeymapKey(1, 0, 0, KC_TRNS), key_a, key_b});
+
+    EXPECT_NO_REPORT(driver);
+    layer_tap_key.press();
+    run_one_scan_loop();
+    key_a.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    layer_tap_key.release();
+    run_one_scan_loop();
+    key_a.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,123 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_layer.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LayerState64Bit : public TestFixture {};
+
+TEST_F(LayerState64Bit, HighestLayerCoversAllBits) {
+    EXPECT_EQ(sizeof(layer_state_t), 8);
+    EXPECT_EQ(MAX_LAYER, 64);
+    EXPECT_EQ(get_highest_layer((layer_state_t)0), 0);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1), 0);
+    EXPECT_EQ(get_highest_layer(((layer_state_t)1 << 40) | ((layer_state_t)1 << 3)), 40);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1 << 63), 63);
+    EXPECT_EQ(get_highest_layer(~(layer_state_t)0), 63);
+}
+
+TEST_F(LayerState64Bit, LayerFunctionsReachUpperLayers) {
+    layer_on(33);
+    layer_on(63);
+    EXPECT_TRUE(layer_state_is(33));
+    EXPECT_TRUE(layer_state_is(63));
+    EXPECT_FALSE(layer_state_is(32));
+    EXPECT_EQ(get_highest_layer(layer_state), 63);
+
+    layer_off(63);
+    EXPECT_EQ(get_highest_layer(layer_state), 33);
+
+    layer_move(50);
+    EXPECT_EQ(layer_state, (layer_state_t)1 << 50);
+}
+
+TEST_F(LayerState64Bit, UpperLayerKeyShadowsLowerLayers) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_base  = KeymapKey(0, 0, 0, KC_A);
+    auto       key_upper = KeymapKey(50, 0, 0, KC_B);
+
+    set_keymap({key_base, key_upper});
+    layer_on(50);
+
+    EXPECT_REPORT(driver, (KC_B));
+    key_base.press();
+    run_one_scan_loop();
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_base.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerState64Bit, TransparentKeysOnlyLookUpActiveLayers) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_base   = KeymapKey(0, 0, 0, KC_A);
+    auto       key_middle = KeymapKey(35, 0, 0, KC_C);
+    auto       key_top    = KeymapKey(60, 0, 0, KC_TRNS);
+
+    set_keymap({key_base, key_middle, key_top});
+    layer_on(35);
+    layer_on(60);
+    uint32_t start = keymap_lookups;
+
+    /* Layer 60 is transparent, layer 35 is the next active one */
+    EXPECT_REPORT(driver, (KC_C));
+    key_base.press();
+    run_one_scan_loop();
+    EXPECT_EQ(keymap_lookups - start, 2);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_base.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerState64Bit, ReleaseComesFromUpperSourceLayer) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_base  = KeymapKey(0, 0, 0, KC_A);
+    auto       key_upper = KeymapKey(45, 0, 0, KC_B);
+
+    set_keymap({key_base, key_upper});
+    layer_on(45);
+
+    EXPECT_REPORT(driver, (KC_B));
+    key_base.press();
+    run_one_scan_loop();
+
+    /* The source layer cache needs all six bits to remember layer 45 */
+    layer_off(45);
+    EXPECT_EMPTY_REPORT(driver);
+    key_base.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerState64Bit, LayerKeycodesClearUpperLayers) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_to    = KeymapKey(0, 0, 0, TO(20));
+    auto       key_upper = KeymapKey(40, 0, 0, KC_TRNS);
+
+    set_keymap({key_to, key_upper});
+    layer_on(40);
+
+    EXPECT_NO_REPORT(driver);
+    key_to.press();
+    run_one_scan_loop();
+    EXPECT_EQ(layer_state, (layer_state_t)1 << 20);
+
+    /* The press came from layer 0, which is no longer active */
+    key_to.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
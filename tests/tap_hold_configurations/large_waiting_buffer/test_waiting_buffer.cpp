@@ -0,0 +1,94 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LargeWaitingBuffer : public TestFixture {};
+
+TEST_F(LargeWaitingBuffer, tap_regular_keys_while_mod_tap_key_is_held) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_hold_key = KeymapKey(0, 0, 0, SFT_T(KC_P));
+
+    std::vector<KeymapKey> regular_keys;
+    for (uint8_t i = 0; i < 10; i++) {
+        regular_keys.push_back(KeymapKey(0, 1 + i % 9, 1 + i / 9, KC_A + i));
+    }
+
+    set_keymap({mod_tap_hold_key});
+    for (auto &key : regular_keys) {
+        add_key(key);
+    }
+
+    /* Press mod-tap-hold key */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Tap more regular keys than a default sized waiting buffer holds */
+    EXPECT_NO_REPORT(driver);
+    for (auto &key : regular_keys) {
+        tap_key(key);
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Settle mod-tap-hold key as hold, every queued tap comes out shifted */
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    for (auto &key : regular_keys) {
+        EXPECT_REPORT(driver, (KC_LEFT_SHIFT, key.report_code));
+        EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    }
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release mod-tap-hold key */
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LargeWaitingBuffer, release_of_key_pressed_before_mod_tap_key) {
+    TestDriver driver;
+    InSequence s;
+    auto       regular_key      = KeymapKey(0, 1, 0, KC_A);
+    auto       mod_tap_hold_key = KeymapKey(0, 2, 0, SFT_T(KC_P));
+
+    set_keymap({regular_key, mod_tap_hold_key});
+
+    /* Press regular key */
+    EXPECT_REPORT(driver, (regular_key.report_code));
+    regular_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Press mod-tap-hold key */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_hold_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release regular key, it was pressed before the mod-tap-hold key */
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release mod-tap-hold key */
+    EXPECT_REPORT(driver, (KC_P));
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
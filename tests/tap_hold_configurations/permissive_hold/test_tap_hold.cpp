@@ -95,6 +95,55 @@ TEST_F(PermissiveHold, tap_mod_tap_key_while_mod_tap_key_is_held) {
     testing::Mock::VerifyAndClearExpectations(&driver);
 }
 
+TEST_F(PermissiveHold, tap_regular_key_while_two_mod_tap_keys_are_held) {
+    TestDriver driver;
+    InSequence s;
+    auto       first_mod_tap_hold_key  = KeymapKey(0, 1, 0, SFT_T(KC_P));
+    auto       second_mod_tap_hold_key = KeymapKey(0, 2, 0, LCTL_T(KC_Q));
+    auto       regular_key             = KeymapKey(0, 3, 0, KC_A);
+
+    set_keymap({first_mod_tap_hold_key, second_mod_tap_hold_key, regular_key});
+
+    /* Press first mod-tap-hold key */
+    EXPECT_NO_REPORT(driver);
+    first_mod_tap_hold_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Press second mod-tap-hold key */
+    EXPECT_NO_REPORT(driver);
+    second_mod_tap_hold_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Press regular key */
+    EXPECT_NO_REPORT(driver);
+    regular_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release regular key, which settles both mod-tap-hold keys as held */
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_LEFT_CTRL));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_LEFT_CTRL, regular_key.report_code));
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_LEFT_CTRL));
+    regular_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release second mod-tap-hold key */
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
+    second_mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Release first mod-tap-hold key */
+    EXPECT_EMPTY_REPORT(driver);
+    first_mod_tap_hold_key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
 TEST_F(PermissiveHold, tap_regular_key_while_layer_tap_key_is_held) {
     TestDriver driver;
     InSequence s;
@@ -0,0 +1,99 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <map>
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+
+/**
+ * Rolling typing over home row mods. Every typed letter is due as soon as the
+ * event that settles it (its own release at the latest with permissive hold)
+ * has been scanned; the time it takes longer is the latency added by the
+ * tap-hold engine.
+ */
+class Rolling : public TestFixture {
+   protected:
+    struct Step {
+        KeymapKey *key;
+        bool       press;
+        uint16_t   due;     // letter that is settled by this step, KC_NO if none
+        unsigned   idle_ms; // time until the next step
+    };
+
+    std::map<uint8_t, uint32_t> first_report;
+
+    uint32_t type(TestDriver &driver, std::vector<Step> steps) {
+        std::map<uint8_t, uint32_t> due;
+
+        first_report.clear();
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly([this](const report_keyboard_t &report) {
+            for (uint8_t key : report.keys) {
+                if (key != KC_NO && first_report.count(key) == 0) {
+                    first_report[key] = timer_read32();
+                }
+            }
+        });
+
+        for (auto &step : steps) {
+            if (step.due != KC_NO) {
+                due[step.due] = timer_read32();
+            }
+            step.press ? step.key->press() : step.key->release();
+            run_one_scan_loop();
+            idle_for(step.idle_ms);
+        }
+        idle_for(TAPPING_TERM * 2);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        uint32_t added = 0;
+        for (auto &letter : due) {
+            EXPECT_EQ(first_report.count(letter.first), 1) << "Letter " << +letter.first << " was never typed";
+            added += first_report[letter.first] - letter.second;
+        }
+        return added;
+    }
+};
+
+TEST_F(Rolling, AddedLatency) {
+    TestDriver driver;
+    auto       a = KeymapKey(0, 1, 0, LSFT_T(KC_A));
+    auto       s = KeymapKey(0, 2, 0, LCTL_T(KC_S));
+    auto       d = KeymapKey(0, 3, 0, LALT_T(KC_D));
+    auto       f = KeymapKey(0, 4, 0, LGUI_T(KC_F));
+    auto       j = KeymapKey(0, 5, 0, KC_J);
+
+    set_keymap({a, s, d, f, j});
+
+    struct Scenario {
+        const char       *name;
+        std::vector<Step> steps;
+    };
+    // Keys follow each other 15ms apart, chords are held for another 60ms after their last key
+    // clang-format off
+    std::vector<Scenario> scenarios = {
+        {"roll of two mod-taps", {{&a, true, KC_NO, 15}, {&s, true, KC_NO, 15}, {&a, false, KC_A, 15}, {&s, false, KC_S, 15}}},
+        {"roll of four mod-taps", {{&a, true, KC_NO, 15}, {&s, true, KC_NO, 15}, {&a, false, KC_A, 15}, {&d, true, KC_NO, 15}, {&s, false, KC_S, 15}, {&f, true, KC_NO, 15}, {&d, false, KC_D, 15}, {&f, false, KC_F, 15}}},
+        {"key inside one mod", {{&a, true, KC_NO, 15}, {&j, true, KC_NO, 15}, {&j, false, KC_J, 60}, {&a, false, KC_NO, 15}}},
+        {"key inside two mods", {{&a, true, KC_NO, 15}, {&s, true, KC_NO, 15}, {&j, true, KC_NO, 15}, {&j, false, KC_J, 60}, {&s, false, KC_NO, 15}, {&a, false, KC_NO, 15}}},
+        {"key inside three mods", {{&a, true, KC_NO, 15}, {&s, true, KC_NO, 15}, {&d, true, KC_NO, 15}, {&j, true, KC_NO, 15}, {&j, false, KC_J, 60}, {&d, false, KC_NO, 15}, {&s, false, KC_NO, 15}, {&a, false, KC_NO, 15}}},
+        {"mod-tap inside one mod", {{&a, true, KC_NO, 15}, {&s, true, KC_NO, 15}, {&s, false, KC_S, 60}, {&a, false, KC_NO, 15}}},
+        {"mod-tap inside two mods", {{&a, true, KC_NO, 15}, {&s, true, KC_NO, 15}, {&d, true, KC_NO, 15}, {&d, false, KC_D, 60}, {&s, false, KC_NO, 15}, {&a, false, KC_NO, 15}}},
+    };
+    // clang-format on
+
+    uint32_t total = 0;
+    for (auto &scenario : scenarios) {
+        uint32_t added = type(driver, scenario.steps);
+        printf("[ ROLLING    ] %-24s added latency %3u ms\n", scenario.name, added);
+        EXPECT_EQ(added, 0) << scenario.name;
+        total += added;
+    }
+    printf("[ ROLLING    ] total added latency %u ms\n", total);
+}
@@ -32,13 +32,16 @@ using testing::_;
 /* This is used for dynamic dispatching keymap_key_to_keycode calls to the current active test_fixture. */
 TestFixture* TestFixture::m_this = nullptr;
 
+#ifndef DYNAMIC_KEYMAP_ENABLE
 /* Override weak QMK function to allow the usage of isolated per-test keymaps in unit-tests.
- * The actual call is dynamicaly dispatched to the current active test fixture, which in turn has it's own keymap. */
+ * The actual call is dynamicaly dispatched to the current active test fixture, which in turn has it's own keymap.
+ * Dynamic keymaps provide their own override, backed by the mocked EEPROM. */
 extern "C" uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t position) {
     uint16_t keycode;
     TestFixture::m_this->get_keycode(layer, position, &keycode);
     return keycode;
 }
+#endif
 
 void TestFixture::SetUpTestCase() {
     test_logger.info() << "TestFixture setup-up start." << std::endl;
@@ -143,6 +146,8 @@ const KeymapKey* TestFixture::find_key(layer_t layer, keypos_t position) const {
 }
 
 void TestFixture::get_keycode(const layer_t layer, const keypos_t position, uint16_t* result) const {
+    keymap_lookups++;
+
     bool key_is_out_of_bounds = position.col >= MATRIX_COLS && position.row >= MATRIX_ROWS;
 
     if (key_is_out_of_bounds) {
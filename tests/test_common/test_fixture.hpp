@@ -68,4 +68,6 @@ class TestFixture : public testing::Test {
    protected:
     void                   print_test_log() const;
     std::vector<KeymapKey> keymap;
+    /* Number of keymap lookups done through keymap_key_to_keycode */
+    mutable uint32_t keymap_lookups = 0;
 };
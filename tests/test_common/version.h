@@ -0,0 +1,10 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Fixed stand-in for the generated version.h, so that tests are reproducible
+#pragma once
+
+#define QMK_VERSION "test"
+#define QMK_BUILDDATE "2022-01-01-00:00:00"
+#define CHIBIOS_VERSION "NA"
+#define CHIBIOS_CONTRIB_VERSION "NA"
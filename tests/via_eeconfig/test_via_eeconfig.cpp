@@ -0,0 +1,85 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "via.h"
+#include "raw_hid.h"
+#include "dynamic_keymap.h"
+#include "eeconfig.h"
+#include "eeprom_mock.h"
+
+// The test keymap has a single layer
+uint8_t keymap_layer_count(void) {
+    return 1;
+}
+
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    return keymaps[layer_num][row][column];
+}
+
+void raw_hid_send(uint8_t *data, uint8_t length) {}
+}
+
+struct eeprom_write_t {
+    uintptr_t            offset;
+    std::vector<uint8_t> data;
+};
+
+static std::vector<eeprom_write_t> writes;
+
+static void record_write(uintptr_t offset, const uint8_t *data, size_t len) {
+    writes.push_back({offset, std::vector<uint8_t>(data, data + len)});
+}
+
+/* Returns the index of the write that left the VIA magic in EEPROM holding the given validity, or -1 */
+static int magic_write(bool valid) {
+    for (size_t i = 0; i < writes.size(); i++) {
+        const eeprom_write_t &w = writes[i];
+        if (w.offset <= VIA_EEPROM_MAGIC_ADDR && w.offset + w.data.size() > VIA_EEPROM_MAGIC_ADDR) {
+            if ((w.data[VIA_EEPROM_MAGIC_ADDR - w.offset] != 0xFF) == valid) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+class ViaEeconfig : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        eeconfig_init_quantum();
+        writes.clear();
+    }
+
+    void TearDown() override {
+        eeprom_mock_set_write_callback(NULL);
+    }
+};
+
+TEST_F(ViaEeconfig, InvalidatedBeforeKeymapReset) {
+    ASSERT_TRUE(via_eeprom_is_valid());
+    dynamic_keymap_set_keycode(0, 1, 2, 0x1234);
+
+    eeprom_mock_set_write_callback(record_write);
+    eeconfig_init_quantum();
+
+    int invalidated = magic_write(false);
+    int validated   = magic_write(true);
+    int keymap      = -1;
+    for (size_t i = 0; i < writes.size(); i++) {
+        if (writes[i].offset >= VIA_EEPROM_CONFIG_END) {
+            keymap = i;
+            break;
+        }
+    }
+    ASSERT_NE(invalidated, -1) << "VIA magic never invalidated in EEPROM";
+    ASSERT_NE(keymap, -1) << "Keymap reset never written";
+    EXPECT_LT(invalidated, keymap);
+    EXPECT_GT(validated, keymap);
+    EXPECT_TRUE(via_eeprom_is_valid());
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 1, 2), keymaps[0][1][2]);
+}
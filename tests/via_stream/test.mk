@@ -0,0 +1,5 @@
+# Copyright 2022 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+VIA_ENABLE = yes
+VIA_STREAM_ENABLE = yes
@@ -0,0 +1,326 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <deque>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "via.h"
+#include "raw_hid.h"
+#include "dynamic_keymap.h"
+#include "eeprom_mock.h"
+
+void advance_time(uint32_t ms);
+
+// The test keymap has a single layer
+uint8_t keymap_layer_count(void) {
+    return 1;
+}
+
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    return keymaps[layer_num][row][column];
+}
+}
+
+typedef std::vector<uint8_t> packet_t;
+
+static const uint8_t        PACKET_SIZE = 32;
+static const uint8_t        PAYLOAD     = PACKET_SIZE - 3;
+static std::deque<packet_t> device_packets;
+static uint32_t             device_replies;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) {
+    device_replies++;
+    device_packets.emplace_back(data, data + length);
+}
+
+static uint16_t host_crc(const uint8_t *data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    while (length--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+class ViaStream : public ::testing::Test {
+   protected:
+    uint32_t round_trips;
+
+    void SetUp() override {
+        eeconfig_init_quantum();
+        via_init();
+        device_packets.clear();
+        eeprom_mock_reset_stats();
+        round_trips    = 0;
+        device_replies = 0;
+    }
+
+    void send(packet_t packet) {
+        packet.resize(PACKET_SIZE);
+        round_trips++;
+        raw_hid_receive(packet.data(), packet.size());
+        // Give the main loop time to send a whole window of data packets
+        for (int i = 0; i < VIA_STREAM_WINDOW * VIA_STREAM_SEND_INTERVAL; i++) {
+            advance_time(1);
+            via_task();
+        }
+    }
+
+    packet_t receive(void) {
+        EXPECT_FALSE(device_packets.empty());
+        if (device_packets.empty()) {
+            return packet_t(PACKET_SIZE);
+        }
+        packet_t packet = device_packets.front();
+        device_packets.pop_front();
+        return packet;
+    }
+
+    packet_t range_command(uint8_t command, uint8_t region, uint16_t offset, uint16_t length) {
+        return {id_bulk_stream, command, region, (uint8_t)(offset >> 8), (uint8_t)offset, (uint8_t)(length >> 8), (uint8_t)length};
+    }
+
+    std::vector<uint8_t> stream_read(uint8_t region, uint16_t offset, uint16_t length, int drop_packet = -1) {
+        std::vector<uint8_t> result(length);
+        uint16_t             expected = 0;
+        uint16_t             packets  = (length + PAYLOAD - 1) / PAYLOAD;
+
+        send(range_command(id_stream_read, region, offset, length));
+        while (true) {
+            while (!device_packets.empty()) {
+                packet_t packet = receive();
+                EXPECT_EQ(packet[0], id_bulk_stream);
+                if (packet[1] != id_stream_data) {
+                    EXPECT_EQ(packet[1], id_stream_ack);
+                    EXPECT_EQ(packet[2], id_stream_ok);
+                    EXPECT_EQ(expected, packets);
+                    return result;
+                }
+                if (packet[2] == drop_packet) {
+                    drop_packet = -1;
+                    continue;
+                }
+                if (packet[2] == (expected & 0xFF)) {
+                    size_t start = expected * PAYLOAD;
+                    size_t count = std::min<size_t>(PAYLOAD, length - start);
+                    std::copy(&packet[3], &packet[3] + count, result.begin() + start);
+                    expected++;
+                }
+            }
+            send({id_bulk_stream, id_stream_ack, (uint8_t)expected});
+        }
+    }
+
+    uint16_t stream_write(uint8_t region, uint16_t offset, const std::vector<uint8_t> &data, int drop_packet = -1) {
+        uint16_t packets = (data.size() + PAYLOAD - 1) / PAYLOAD;
+
+        send(range_command(id_stream_write, region, offset, data.size()));
+        packet_t reply = receive();
+        EXPECT_EQ(reply[2], id_stream_ok);
+        EXPECT_EQ(reply[3], PAYLOAD);
+        uint8_t window = reply[4];
+
+        uint16_t next = 0;
+        while (next < packets) {
+            uint16_t end = std::min<uint16_t>(next + window, packets);
+            for (uint16_t p = next; p < end; p++) {
+                if (p == drop_packet) {
+                    drop_packet = -1;
+                    continue;
+                }
+                packet_t packet = {id_bulk_stream, id_stream_data, (uint8_t)p};
+                size_t   count  = std::min<size_t>(PAYLOAD, data.size() - p * PAYLOAD);
+                packet.insert(packet.end(), data.begin() + p * PAYLOAD, data.begin() + p * PAYLOAD + count);
+                send(packet);
+            }
+            // Collect the acknowledgements, resuming from the last one
+            EXPECT_FALSE(device_packets.empty());
+            while (!device_packets.empty()) {
+                packet_t ack = receive();
+                EXPECT_EQ(ack[1], id_stream_ack);
+                next = end - (uint8_t)(end - ack[2]);
+            }
+        }
+
+        send({id_bulk_stream, id_stream_commit});
+        reply = receive();
+        EXPECT_EQ(reply[2], id_stream_ok);
+        return (reply[3] << 8) | reply[4];
+    }
+};
+
+TEST_F(ViaStream, LegacyHostsUnaffected) {
+    send({id_get_protocol_version});
+    packet_t reply = receive();
+    EXPECT_EQ((reply[1] << 8) | reply[2], VIA_PROTOCOL_VERSION);
+
+    send({id_dynamic_keymap_set_buffer, 0x00, 0x02, 0x02, 0x12, 0x34});
+    receive();
+    send({id_dynamic_keymap_get_buffer, 0x00, 0x00, 0x04});
+    reply = receive();
+    EXPECT_EQ(reply[4], 0x00);
+    EXPECT_EQ(reply[5], 0x00);
+    EXPECT_EQ(reply[6], 0x12);
+    EXPECT_EQ(reply[7], 0x34);
+}
+
+TEST_F(ViaStream, Info) {
+    send({id_bulk_stream, id_stream_info, id_stream_region_keymap});
+    packet_t reply = receive();
+    EXPECT_EQ(reply[2], id_stream_ok);
+    EXPECT_EQ((reply[3] << 8) | reply[4], dynamic_keymap_get_buffer_size());
+    EXPECT_EQ(reply[5], PAYLOAD);
+    EXPECT_EQ(reply[6], VIA_STREAM_WINDOW);
+
+    send({id_bulk_stream, id_stream_info, 0x7F});
+    reply = receive();
+    EXPECT_EQ(reply[2], id_stream_error_range);
+}
+
+TEST_F(ViaStream, UnknownCommandUnhandled) {
+    send({id_bulk_stream, 0x7F});
+    EXPECT_EQ(receive()[0], id_unhandled);
+}
+
+TEST_F(ViaStream, ReadKeymap) {
+    uint16_t             size = dynamic_keymap_get_buffer_size();
+    std::vector<uint8_t> expected(size);
+    dynamic_keymap_set_keycode(0, 1, 2, 0x1234);
+    dynamic_keymap_set_keycode(3, 3, 9, 0xABCD);
+    dynamic_keymap_get_buffer(0, size, expected.data());
+
+    EXPECT_EQ(stream_read(id_stream_region_keymap, 0, size), expected);
+    uint16_t packets = (size + PAYLOAD - 1) / PAYLOAD;
+    EXPECT_EQ(round_trips, 1 + (packets + VIA_STREAM_WINDOW - 1) / VIA_STREAM_WINDOW);
+}
+
+TEST_F(ViaStream, ReadSendsOnePacketPerInterval) {
+    packet_t packet = range_command(id_stream_read, id_stream_region_keymap, 0, dynamic_keymap_get_buffer_size());
+    packet.resize(PACKET_SIZE);
+    raw_hid_receive(packet.data(), packet.size());
+    EXPECT_TRUE(device_packets.empty()) << "Data packets are only sent from via_task()";
+
+    advance_time(VIA_STREAM_SEND_INTERVAL);
+    via_task();
+    via_task();
+    EXPECT_EQ(device_packets.size(), 1u);
+
+    advance_time(VIA_STREAM_SEND_INTERVAL - 1);
+    via_task();
+    EXPECT_EQ(device_packets.size(), 1u);
+
+    advance_time(1);
+    via_task();
+    EXPECT_EQ(device_packets.size(), 2u);
+    EXPECT_EQ(receive()[2], 0);
+    EXPECT_EQ(receive()[2], 1);
+}
+
+TEST_F(ViaStream, ReadRecoversFromLostPacket) {
+    uint16_t             size = dynamic_keymap_get_buffer_size();
+    std::vector<uint8_t> expected(size);
+    dynamic_keymap_set_keycode(0, 0, 5, 0x5555);
+    dynamic_keymap_get_buffer(0, size, expected.data());
+
+    EXPECT_EQ(stream_read(id_stream_region_keymap, 0, size, 2), expected);
+}
+
+TEST_F(ViaStream, WriteKeymap) {
+    uint16_t             size = dynamic_keymap_get_buffer_size();
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    EXPECT_EQ(stream_write(id_stream_region_keymap, 0, data), host_crc(data.data(), data.size()));
+
+    std::vector<uint8_t> stored(size);
+    dynamic_keymap_get_buffer(0, size, stored.data());
+    EXPECT_EQ(stored, data);
+    EXPECT_EQ(eeprom_mock_get_stats().writes, (size + VIA_STREAM_BUFFER_SIZE - 1) / VIA_STREAM_BUFFER_SIZE);
+}
+
+TEST_F(ViaStream, WriteRecoversFromLostPacket) {
+    uint16_t             size = dynamic_keymap_get_buffer_size();
+    std::vector<uint8_t> data(size, 0x42);
+
+    EXPECT_EQ(stream_write(id_stream_region_keymap, 0, data, 3), host_crc(data.data(), data.size()));
+
+    std::vector<uint8_t> stored(size);
+    dynamic_keymap_get_buffer(0, size, stored.data());
+    EXPECT_EQ(stored, data);
+}
+
+TEST_F(ViaStream, WriteMacros) {
+    std::vector<uint8_t> data = {'a', 'b', 'c', 0, 'd', 0};
+    EXPECT_EQ(stream_write(id_stream_region_macros, 0, data), host_crc(data.data(), data.size()));
+
+    std::vector<uint8_t> stored(data.size());
+    dynamic_keymap_macro_get_buffer(0, stored.size(), stored.data());
+    EXPECT_EQ(stored, data);
+}
+
+TEST_F(ViaStream, ChecksumIdentifiesChangedRanges) {
+    uint16_t             half = dynamic_keymap_get_buffer_size() / 2;
+    std::vector<uint8_t> before(half);
+    dynamic_keymap_get_buffer(half, half, before.data());
+
+    send(range_command(id_stream_checksum, id_stream_region_keymap, half, half));
+    packet_t reply = receive();
+    EXPECT_EQ(reply[2], id_stream_ok);
+    EXPECT_EQ((reply[3] << 8) | reply[4], host_crc(before.data(), before.size()));
+
+    dynamic_keymap_set_keycode(0, 0, 0, 0x0004);
+    send(range_command(id_stream_checksum, id_stream_region_keymap, half, half));
+    reply = receive();
+    EXPECT_EQ((reply[3] << 8) | reply[4], host_crc(before.data(), before.size())) << "Change outside the range";
+
+    send(range_command(id_stream_checksum, id_stream_region_keymap, half, half + 1));
+    EXPECT_EQ(receive()[2], id_stream_error_range);
+}
+
+TEST_F(ViaStream, DataWithoutWriteRejected) {
+    send({id_bulk_stream, id_stream_data, 0x00, 0x01});
+    packet_t reply = receive();
+    EXPECT_EQ(reply[1], id_stream_ack);
+    EXPECT_EQ(reply[3], id_stream_error_state);
+
+    send({id_bulk_stream, id_stream_commit});
+    EXPECT_EQ(receive()[2], id_stream_error_state);
+}
+
+/**
+ * Compares round trips and EEPROM updates of a full keymap upload against the
+ * legacy 28 byte per round trip buffer commands.
+ */
+TEST_F(ViaStream, TransferReport) {
+    uint16_t             size = dynamic_keymap_get_buffer_size();
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)(i * 13 + 1);
+    }
+
+    for (uint16_t offset = 0; offset < size; offset += 28) {
+        uint8_t  count  = std::min<uint16_t>(28, size - offset);
+        packet_t packet = {id_dynamic_keymap_set_buffer, (uint8_t)(offset >> 8), (uint8_t)offset, count};
+        packet.insert(packet.end(), data.begin() + offset, data.begin() + offset + count);
+        send(packet);
+        receive();
+    }
+    printf("[ VIA STREAM ] legacy upload of %u bytes: %u host packets, %u device replies, %u EEPROM updates\n", size, round_trips, device_replies, eeprom_mock_get_stats().writes);
+
+    for (auto &b : data) {
+        b ^= 0xFF;
+    }
+    round_trips    = 0;
+    device_replies = 0;
+    eeprom_mock_reset_stats();
+    stream_write(id_stream_region_keymap, 0, data);
+    printf("[ VIA STREAM ] stream upload of %u bytes: %u host packets, %u device replies, %u EEPROM updates\n", size, round_trips, device_replies, eeprom_mock_get_stats().writes);
+    EXPECT_LT(device_replies, 12u);
+}